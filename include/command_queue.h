@@ -0,0 +1,64 @@
+#ifndef COMMAND_QUEUE_H
+#define COMMAND_QUEUE_H
+
+#include <Arduino.h>
+#include <atomic>
+
+// ============================================================
+// Command ring
+// Bounded single-producer/single-consumer queue. The producer
+// fills the slot returned by reserve() and hands it over with
+// publish(); the consumer reads peek() and gives the slot back
+// with release(). Neither side blocks or takes a lock, a full
+// ring makes reserve() fail and counts a drop. Positions run
+// free and wrap; SIZE must be a power of two.
+// ============================================================
+
+template <typename T, uint8_t SIZE>
+struct CommandRing {
+    static_assert(SIZE && (SIZE & (SIZE - 1)) == 0, "CommandRing size must be a power of two");
+
+    T slots[SIZE];
+    std::atomic<uint32_t> head;       // Next slot to fill, written by the producer
+    std::atomic<uint32_t> tail;       // Next slot to read, written by the consumer
+    std::atomic<uint32_t> drops;      // Commands refused while full
+    std::atomic<uint32_t> highWater;  // Deepest the ring has been
+
+    uint32_t depth() const {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+
+    // Producer: slot to fill, nullptr (counted as a drop) when full
+    T* reserve() {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) >= SIZE) {
+            drops.store(drops.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        return &slots[h & (SIZE - 1)];
+    }
+
+    // Producer: make the reserved slot visible to the consumer
+    void publish() {
+        uint32_t h = head.load(std::memory_order_relaxed) + 1;
+        head.store(h, std::memory_order_release);
+        uint32_t used = h - tail.load(std::memory_order_acquire);
+        if (used > highWater.load(std::memory_order_relaxed)) {
+            highWater.store(used, std::memory_order_relaxed);
+        }
+    }
+
+    // Consumer: oldest published slot, nullptr when empty
+    T* peek() {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        if (head.load(std::memory_order_acquire) == t) return nullptr;
+        return &slots[t & (SIZE - 1)];
+    }
+
+    // Consumer: hand the peeked slot back to the producer
+    void release() {
+        tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+};
+
+#endif // COMMAND_QUEUE_H
@@ -110,6 +110,22 @@
     #define CLK_PIN 16
 #endif
 
+// ============================================================================
+// Memory
+// ============================================================================
+// Boards without PSRAM (trinity, devkit) get smaller long-lived buffers.
+// Approximate budget there, 32-bit sizes with the defaults below:
+//   state snapshot     1 x 21 KB  heap, taken at boot
+//   icon arena         12 KB      heap, taken at boot
+//   command rings      2 x 4 x 1.1 KB (.bss)
+//   large REST bodies  1 x 4 KB   (.bss)
+//   MQTT outbox        2 x 1 KB   (.bss)
+// With PSRAM the snapshot copies and the arena are allocated there.
+// Free heap and largest block are logged at boot ([MEM]) and in /api/stats.
+#ifndef USE_PSRAM
+    #define USE_PSRAM 0
+#endif
+
 // ============================================================================
 // Application Limits
 // ============================================================================
@@ -120,7 +136,7 @@
     #define MAX_NOTIFICATIONS 10
 #endif
 #ifndef MAX_ICON_CACHE
-    #define MAX_ICON_CACHE 8
+    #define MAX_ICON_CACHE 16           // Cache entries, memory is bounded by ICON_CACHE_BUDGET
 #endif
 
 // ============================================================================
@@ -132,6 +148,33 @@
 #ifndef MAX_ICON_DIMENSION
     #define MAX_ICON_DIMENSION 64       // Max 64x64 pixels
 #endif
+#ifndef ICON_CACHE_BUDGET
+    #if USE_PSRAM
+        #define ICON_CACHE_BUDGET 24576 // Arena for decoded icons (frames + spans)
+    #else
+        #define ICON_CACHE_BUDGET 12288 // Arena for decoded icons (frames + spans)
+    #endif
+#endif
+#ifndef MAX_ICON_FRAMES
+    #define MAX_ICON_FRAMES 32          // Frames kept for an animated (GIF) icon
+#endif
+#ifndef MAX_ICON_MISSES
+    #define MAX_ICON_MISSES 16          // Missing icon names remembered
+#endif
+#define ICON_MISS_TTL 60000             // Retry a missing icon after 1 minute
+#define ICON_PREFETCH_INTERVAL 100      // ms between look-ahead scans for upcoming icons
+#ifndef ICON_TRANSCODE_QUEUE
+    #define ICON_TRANSCODE_QUEUE 4      // Pending pre-decoded sidecar writes
+#endif
+
+// ============================================================================
+// GIF Playback
+// ============================================================================
+#ifndef GIF_HEAP_RESERVE
+    #define GIF_HEAP_RESERVE 16384      // Largest free block left after the decoder
+#endif
+#define GIF_MIN_FRAME_DELAY 20          // Shorter delays are treated as unset (browser behavior)
+#define GIF_DEFAULT_FRAME_DELAY 100     // Delay used for frames without a usable one
 
 // ============================================================================
 // Tracker Layout
@@ -146,6 +189,15 @@
 #define TRACKER_ID_PREFIX "tracker_"
 #define LAMETRIC_API_HOST "developer.lametric.com"
 #define LAMETRIC_ICON_PATH "/content/apps/icon_thumbs/"
+#ifndef LAMETRIC_ICON_URL
+    #define LAMETRIC_ICON_URL "https://" LAMETRIC_API_HOST LAMETRIC_ICON_PATH  // http:// for a local stand-in
+#endif
+#ifndef MAX_ICON_DOWNLOADS
+    #define MAX_ICON_DOWNLOADS 8        // Queued, in-flight and backing-off icon downloads
+#endif
+#define ICON_DOWNLOAD_TIMEOUT 10000     // Connect/read timeout per request (ms)
+#define ICON_DOWNLOAD_RETRY_MIN 30000   // First retry after a failure, doubled each time
+#define ICON_DOWNLOAD_RETRY_MAX 3600000 // Backoff cap (1 hour)
 
 // ============================================================================
 // Sleep Configuration
@@ -194,7 +246,9 @@
 #ifndef MQTT_BUFFER_SIZE
     #define MQTT_BUFFER_SIZE 1024
 #endif
-#define MQTT_RECONNECT_DELAY 5000  // 5 seconds
+#define MQTT_BACKOFF_MIN 1000  // First reconnect delay (ms), doubled per failure
+#define MQTT_BACKOFF_MAX 60000  // Reconnect delay cap (ms), each delay is jittered
+#define MQTT_CONNECT_TIMEOUT 3  // seconds, TCP connect and CONNACK wait
 #define MQTT_KEEPALIVE 60  // seconds
 #define MQTT_STATS_INTERVAL 60000  // Publish stats every minute
 
@@ -212,6 +266,7 @@
 #define MQTT_TOPIC_STATUS       "/status"
 #define MQTT_TOPIC_SLEEP        "/sleep"
 #define MQTT_TOPIC_WAKE         "/wake"
+#define MQTT_TOPIC_BATCH        "/batch"
 
 // ============================================================================
 // Web Server
@@ -275,6 +330,8 @@ typedef enum {
 
 #define DEFAULT_TRANSITION TRANSITION_NONE
 #define TRANSITION_DURATION 300  // ms
+#define TRANSITION_FRAME_INTERVAL RENDER_FRAME_PERIOD  // One composite per frame tick
+#define TRANSITION_GLOBAL 0xFF   // Per-app value: follow settings.transition
 
 // ============================================================================
 // Debug
@@ -300,4 +357,57 @@ typedef enum {
 #define TASK_STACK_SIZE 4096
 #define LOOP_DELAY 10  // Main loop delay (ms)
 
+// Render task: runs on the core not used by AsyncTCP and loop() (core 1)
+#ifndef RENDER_TASK_CORE
+    #define RENDER_TASK_CORE 0
+#endif
+#define RENDER_TASK_STACK 8192
+#define RENDER_TASK_PRIORITY 5
+#define RENDER_FRAME_PERIOD 10      // ms, shortest spacing of timed frames (100 Hz)
+#define RENDER_IDLE_PERIOD 1000     // ms, longest sleep when no frame is due
+#define RENDER_STATS_WINDOW 10000   // ms per jitter/load window
+#define ICON_PREFETCH_IDLE_US (RENDER_FRAME_PERIOD * 500UL)  // Prefetch only after frames under half the period
+#ifndef STATE_SNAPSHOT_COPIES
+    #if USE_PSRAM
+        #define STATE_SNAPSHOT_COPIES 2  // Published model copies (~21 KB each), readers never wait
+    #else
+        #define STATE_SNAPSHOT_COPIES 1  // One copy, a reader racing a refresh waits for the frame
+    #endif
+#endif
+
+// Icon download worker: blocking HTTP(S), kept off the render core
+#define ICON_DOWNLOAD_TASK_CORE (1 - RENDER_TASK_CORE)
+#define ICON_DOWNLOAD_TASK_STACK 8192
+#define ICON_DOWNLOAD_TASK_PRIORITY 1
+
+// MQTT client task: connects, polls the socket and publishes the outbox
+#define MQTT_TASK_CORE (1 - RENDER_TASK_CORE)
+#define MQTT_TASK_STACK 6144
+#define MQTT_TASK_PRIORITY 1
+#define MQTT_TASK_PERIOD 10                      // ms between socket polls
+#ifndef MQTT_OUTBOX_SIZE
+    #define MQTT_OUTBOX_SIZE 2                   // Queued outgoing messages, power of two
+#endif
+
+// Command queues: mutating REST/MQTT requests, applied at the start of a frame
+#ifndef COMMAND_QUEUE_SIZE
+    #define COMMAND_QUEUE_SIZE 4                 // Slots per producer, power of two
+#endif
+#define COMMAND_BODY_SIZE MQTT_BUFFER_SIZE      // Largest JSON payload held in a slot (all of MQTT)
+#ifndef COMMAND_LARGE_SIZE
+    #define COMMAND_LARGE_SIZE 4096              // Largest REST payload, batches as JSON of their accepted ops
+#endif
+#ifndef COMMAND_LARGE_COUNT
+    #if USE_PSRAM
+        #define COMMAND_LARGE_COUNT 2            // REST payloads over a slot queued at once
+    #else
+        #define COMMAND_LARGE_COUNT 1            // REST payloads over a slot queued at once
+    #endif
+#endif
+
+// Per-render-function timing histograms (/api/stats and MQTT stats)
+#ifndef ENABLE_RENDER_TIMING
+    #define ENABLE_RENDER_TIMING 1
+#endif
+
 #endif // CONFIG_H
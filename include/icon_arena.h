@@ -0,0 +1,123 @@
+#ifndef ICON_ARENA_H
+#define ICON_ARENA_H
+
+#include <Arduino.h>
+
+// ============================================================
+// Icon arena
+// Decoded icons live in one fixed pool instead of the heap, so
+// loading and evicting them never fragments it. Blocks are
+// bump-allocated; freeing only marks a block, and when the free
+// space is not contiguous the live blocks are slid down
+// (compacted). Each block records the pointer that owns it so
+// compaction can update it.
+// ============================================================
+
+#define ICON_ARENA_ALIGN sizeof(void*)
+
+struct IconArenaBlock {
+    uint32_t size;    // Whole block, header included
+    uint8_t** owner;  // nullptr once freed
+};
+
+struct IconArena {
+    uint8_t* base;
+    uint32_t capacity;
+    uint32_t top;          // End of the last block
+    uint32_t live;         // Bytes held by allocated blocks
+    uint32_t compactions;
+};
+
+inline void iconArenaInit(IconArena* arena, uint8_t* pool, uint32_t capacity) {
+    arena->base = pool;
+    arena->capacity = capacity;
+    arena->top = 0;
+    arena->live = 0;
+    arena->compactions = 0;
+}
+
+inline uint32_t iconArenaBlockSize(uint32_t bytes) {
+    return (sizeof(IconArenaBlock) + bytes + ICON_ARENA_ALIGN - 1) & ~(uint32_t)(ICON_ARENA_ALIGN - 1);
+}
+
+// Enough free space once compacted
+inline bool iconArenaFits(const IconArena* arena, uint32_t bytes) {
+    return arena->live + iconArenaBlockSize(bytes) <= arena->capacity;
+}
+
+// Enough contiguous space at the top
+inline bool iconArenaFitsTop(const IconArena* arena, uint32_t bytes) {
+    return arena->top + iconArenaBlockSize(bytes) <= arena->capacity;
+}
+
+// Allocate at the top, nullptr if it does not fit there. *owner is set to
+// the block and kept up to date by compaction.
+inline uint8_t* iconArenaAlloc(IconArena* arena, uint32_t bytes, uint8_t** owner) {
+    if (!arena->base || !iconArenaFitsTop(arena, bytes)) return nullptr;
+    IconArenaBlock* block = (IconArenaBlock*)(arena->base + arena->top);
+    block->size = iconArenaBlockSize(bytes);
+    block->owner = owner;
+    arena->top += block->size;
+    arena->live += block->size;
+    *owner = (uint8_t*)(block + 1);
+    return *owner;
+}
+
+inline void iconArenaFree(IconArena* arena, uint8_t* data) {
+    if (!data) return;
+    IconArenaBlock* block = (IconArenaBlock*)data - 1;
+    if (!block->owner) return;
+    block->owner = nullptr;
+    arena->live -= block->size;
+    // Freeing the last block gives its space back right away
+    if ((uint8_t*)block + block->size == arena->base + arena->top) arena->top -= block->size;
+    if (arena->live == 0) arena->top = 0;
+}
+
+// Slide live blocks down over the freed ones, updating their owners
+inline void iconArenaCompact(IconArena* arena) {
+    uint32_t read = 0;
+    uint32_t write = 0;
+    while (read < arena->top) {
+        IconArenaBlock* block = (IconArenaBlock*)(arena->base + read);
+        uint32_t size = block->size;
+        if (block->owner) {
+            if (write != read) {
+                memmove(arena->base + write, block, size);
+                block = (IconArenaBlock*)(arena->base + write);
+                *block->owner = (uint8_t*)(block + 1);
+            }
+            write += size;
+        }
+        read += size;
+    }
+    arena->top = write;
+    arena->compactions++;
+}
+
+// Largest contiguous free space: runs of freed blocks or the gap above the top
+inline uint32_t iconArenaLargestFree(const IconArena* arena) {
+    uint32_t largest = arena->capacity - arena->top;
+    uint32_t hole = 0;
+    uint32_t offset = 0;
+    while (offset < arena->top) {
+        const IconArenaBlock* block = (const IconArenaBlock*)(arena->base + offset);
+        if (block->owner) {
+            hole = 0;
+        } else {
+            hole += block->size;
+            if (hole > largest) largest = hole;
+        }
+        offset += block->size;
+    }
+    return largest;
+}
+
+// Share of the free space that is not at the top (0-100)
+inline uint8_t iconArenaFragmentation(const IconArena* arena) {
+    uint32_t freeBytes = arena->capacity - arena->live;
+    if (freeBytes == 0) return 0;
+    return (uint8_t)(100 - (uint64_t)(arena->capacity - arena->top) * 100 / freeBytes);
+}
+
+#endif // ICON_ARENA_H
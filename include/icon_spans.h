@@ -0,0 +1,92 @@
+#ifndef ICON_SPANS_H
+#define ICON_SPANS_H
+
+#include <Arduino.h>
+#include <Adafruit_GFX.h>
+
+// ============================================================
+// Span-based icon blitting
+// Icons are pre-processed into horizontal runs of opaque pixels
+// (black = transparent), drawing is then a loop over spans
+// writing straight into the RGB565 frame canvas.
+// ============================================================
+
+struct IconSpan {
+    uint8_t x;    // First opaque pixel of the run
+    uint8_t y;    // Source row
+    uint8_t len;  // Run length in pixels
+};
+
+// Find opaque runs in an RGB565 icon. Pass out=nullptr to only count them.
+// Runs are split at 255 pixels so the length fits in a byte.
+inline uint16_t buildIconSpans(const uint16_t* pixels, uint8_t width, uint8_t height,
+                               IconSpan* out) {
+    uint16_t count = 0;
+    for (uint8_t py = 0; py < height; py++) {
+        const uint16_t* row = pixels + py * width;
+        uint8_t px = 0;
+        while (px < width) {
+            if (pgm_read_word(&row[px]) == 0) {
+                px++;
+                continue;
+            }
+            uint8_t start = px;
+            while (px < width && pgm_read_word(&row[px]) != 0 && px - start < 255) px++;
+            if (out) {
+                out[count].x = start;
+                out[count].y = py;
+                out[count].len = px - start;
+            }
+            count++;
+        }
+    }
+    return count;
+}
+
+// Blit spans at (x, y) with integer scaling, clipped to the canvas.
+// pixels may live in PROGMEM (flash is memory-mapped on ESP32).
+inline void drawIconSpans(GFXcanvas16* dst, const uint16_t* pixels, uint8_t width,
+                          const IconSpan* spans, uint16_t count,
+                          int16_t x, int16_t y, uint8_t scale) {
+    if (!dst || !pixels || !spans || scale == 0) return;
+
+    uint16_t* frame = dst->getBuffer();
+    int16_t dstW = dst->width();
+    int16_t dstH = dst->height();
+
+    for (uint16_t i = 0; i < count; i++) {
+        const IconSpan& span = spans[i];
+        const uint16_t* src = pixels + span.y * width + span.x;
+        int16_t dx0 = x + span.x * scale;
+        int16_t dy0 = y + span.y * scale;
+
+        // Clip the span horizontally once (in source pixels). A source pixel
+        // only partly off the left edge is kept, its columns are clipped below.
+        int16_t first = 0;
+        int16_t last = span.len;
+        if (dx0 < 0) first = -dx0 / scale;
+        if (dx0 + last * scale > dstW) last = (dstW - dx0 + scale - 1) / scale;
+        if (first >= last) continue;
+
+        for (uint8_t sy = 0; sy < scale; sy++) {
+            int16_t dy = dy0 + sy;
+            if (dy < 0 || dy >= dstH) continue;
+            uint16_t* row = frame + dy * dstW;
+
+            if (scale == 1) {
+                memcpy(row + dx0 + first, src + first, (last - first) * sizeof(uint16_t));
+                continue;
+            }
+
+            for (int16_t p = first; p < last; p++) {
+                uint16_t color = src[p];
+                int16_t dx = dx0 + p * scale;
+                for (uint8_t sx = 0; sx < scale; sx++, dx++) {
+                    if (dx >= 0 && dx < dstW) row[dx] = color;
+                }
+            }
+        }
+    }
+}
+
+#endif // ICON_SPANS_H
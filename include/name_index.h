@@ -0,0 +1,82 @@
+#ifndef NAME_INDEX_H
+#define NAME_INDEX_H
+
+#include <Arduino.h>
+
+// ============================================================
+// Hashed name index
+// Maps the hash of a name to a slot of a small fixed table, so
+// lookups compare names only when the 32-bit hashes match.
+// Open addressing with linear probing; removals shift the
+// following entries back, so there are no tombstones to purge.
+// SIZE must be a power of two larger than the indexed table.
+// ============================================================
+
+// FNV-1a
+inline uint32_t nameHash(const char* name) {
+    uint32_t hash = 2166136261u;
+    while (*name) {
+        hash ^= (uint8_t)*name++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Same hash at compile time, for tables of known names
+constexpr uint32_t nameHashConst(const char* name, uint32_t hash = 2166136261u) {
+    return *name ? nameHashConst(name + 1, (hash ^ (uint8_t)*name) * 16777619u) : hash;
+}
+
+template <uint8_t SIZE>
+struct NameIndex {
+    uint32_t hashes[SIZE];
+    uint8_t slots[SIZE];  // Table slot + 1, 0 = empty
+
+    void clear() {
+        memset(slots, 0, sizeof(slots));
+    }
+
+    // First probe position for a lookup
+    uint8_t start(uint32_t hash) const {
+        return hash & (SIZE - 1);
+    }
+
+    // Next table slot whose name hashes to `hash`, -1 at the end of the
+    // chain. `pos` starts at start(hash) and is advanced by each call.
+    int16_t next(uint32_t hash, uint8_t* pos) const {
+        while (slots[*pos]) {
+            uint8_t i = *pos;
+            *pos = (i + 1) & (SIZE - 1);
+            if (hashes[i] == hash) return slots[i] - 1;
+        }
+        return -1;
+    }
+
+    void insert(uint32_t hash, uint8_t slot) {
+        uint8_t i = start(hash);
+        while (slots[i]) i = (i + 1) & (SIZE - 1);
+        hashes[i] = hash;
+        slots[i] = slot + 1;
+    }
+
+    void remove(uint32_t hash, uint8_t slot) {
+        uint8_t i = start(hash);
+        while (slots[i] && !(hashes[i] == hash && slots[i] == slot + 1)) i = (i + 1) & (SIZE - 1);
+        if (!slots[i]) return;
+
+        // Shift back entries that probed past the hole
+        uint8_t hole = i;
+        for (uint8_t j = (i + 1) & (SIZE - 1); slots[j]; j = (j + 1) & (SIZE - 1)) {
+            uint8_t home = start(hashes[j]);
+            // Movable unless its home lies cyclically in (hole, j]
+            bool stays = hole <= j ? (home > hole && home <= j) : (home > hole || home <= j);
+            if (stays) continue;
+            hashes[hole] = hashes[j];
+            slots[hole] = slots[j];
+            hole = j;
+        }
+        slots[hole] = 0;
+    }
+};
+
+#endif // NAME_INDEX_H
@@ -0,0 +1,83 @@
+#ifndef PANEL_COLOR_H
+#define PANEL_COLOR_H
+
+#include <Arduino.h>
+
+// ============================================================
+// Panel color pipeline
+// 0xRRGGBB colors are gamma corrected (CIE 1931 lightness) and
+// rounded to the panel's COLOR_DEPTH before being packed into
+// RGB565, using tables built at compile time. The HUB75 driver's
+// own CIE correction is disabled (NO_CIE1931): correcting after
+// the 565 quantization collapsed most dark levels to black.
+// Packed values are linear light, so dimming is a plain scale.
+// ============================================================
+
+#ifndef COLOR_DEPTH
+    #define COLOR_DEPTH 8
+#endif
+
+// Bits per channel that actually reach the LEDs
+#define PANEL_BITS_R (COLOR_DEPTH < 5 ? COLOR_DEPTH : 5)
+#define PANEL_BITS_G (COLOR_DEPTH < 6 ? COLOR_DEPTH : 6)
+#define PANEL_BITS_B (COLOR_DEPTH < 5 ? COLOR_DEPTH : 5)
+
+constexpr float panelCube(float x) {
+    return x * x * x;
+}
+
+// CIE 1931 lightness (0-255) to relative luminance (0.0-1.0)
+constexpr float panelLuminance(uint16_t v) {
+    return v <= 20 ? (v * (100.0f / 255.0f)) / 903.3f
+                   : panelCube((v * (100.0f / 255.0f) + 16.0f) / 116.0f);
+}
+
+// Luminance rounded to `bits`, left-aligned in a `fieldBits` wide field
+constexpr uint16_t panelQuantize(uint16_t v, uint8_t bits, uint8_t fieldBits) {
+    return (uint16_t)(panelLuminance(v) * ((1 << bits) - 1) + 0.5f) << (fieldBits - bits);
+}
+
+template <uint16_t... I> struct PanelIndexSeq {};
+template <uint16_t N, uint16_t... I>
+struct PanelMakeSeq : PanelMakeSeq<N - 1, N - 1, I...> {};
+template <uint16_t... I>
+struct PanelMakeSeq<0, I...> { typedef PanelIndexSeq<I...> type; };
+
+template <typename Seq> struct PanelTables;
+template <uint16_t... I>
+struct PanelTables<PanelIndexSeq<I...>> {
+    static constexpr uint16_t red[256] = { (uint16_t)(panelQuantize(I, PANEL_BITS_R, 5) << 11)... };
+    static constexpr uint16_t green[256] = { (uint16_t)(panelQuantize(I, PANEL_BITS_G, 6) << 5)... };
+    static constexpr uint16_t blue[256] = { panelQuantize(I, PANEL_BITS_B, 5)... };
+    static constexpr uint8_t level[256] = { (uint8_t)panelQuantize(I, 8, 8)... };  // Perceived -> linear
+};
+template <uint16_t... I> constexpr uint16_t PanelTables<PanelIndexSeq<I...>>::red[256];
+template <uint16_t... I> constexpr uint16_t PanelTables<PanelIndexSeq<I...>>::green[256];
+template <uint16_t... I> constexpr uint16_t PanelTables<PanelIndexSeq<I...>>::blue[256];
+template <uint16_t... I> constexpr uint8_t PanelTables<PanelIndexSeq<I...>>::level[256];
+
+typedef PanelTables<PanelMakeSeq<256>::type> PanelLut;
+
+// 8-bit sRGB-style channels to packed panel color
+constexpr uint16_t panelColor(uint8_t r, uint8_t g, uint8_t b) {
+    return PanelLut::red[r] | PanelLut::green[g] | PanelLut::blue[b];
+}
+
+constexpr uint16_t panelColorRGB(uint32_t rgb) {
+    return panelColor((rgb >> 16) & 0xFF, (rgb >> 8) & 0xFF, rgb & 0xFF);
+}
+
+// Scale a packed color by a linear factor (255 = unchanged), all channels at once
+inline uint16_t panelScale(uint16_t color, uint8_t linearLevel) {
+    uint32_t alpha = ((uint32_t)linearLevel + 4) >> 3;  // 0..32
+    uint32_t spread = (color | ((uint32_t)color << 16)) & 0x07E0F81F;
+    spread = ((spread * alpha) >> 5) & 0x07E0F81F;
+    return (uint16_t)(spread | (spread >> 16));
+}
+
+// Dim a packed color as if its 8-bit channels had been multiplied by brightness/255
+inline uint16_t panelDim(uint16_t color, uint8_t brightness) {
+    return panelScale(color, PanelLut::level[brightness]);
+}
+
+#endif // PANEL_COLOR_H
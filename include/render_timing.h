@@ -0,0 +1,84 @@
+#ifndef RENDER_TIMING_H
+#define RENDER_TIMING_H
+
+#include <Arduino.h>
+
+// ============================================================
+// Render timing histograms
+// Durations are measured with the CPU cycle counter and kept in
+// fixed log-scale buckets (4 per power of two, ~19% resolution),
+// so recording is a handful of instructions and never allocates.
+// ============================================================
+
+#define TIMING_BUCKETS 84   // Covers 0 us .. ~4 s
+
+struct TimingHistogram {
+    uint16_t buckets[TIMING_BUCKETS];
+    uint32_t count;     // Samples since boot
+    uint32_t lastUs;
+    uint32_t maxUs;
+};
+
+inline uint8_t timingBucketIndex(uint32_t us) {
+    if (us < 4) return us;
+    uint8_t msb = 31 - __builtin_clz(us);
+    uint8_t sub = (us >> (msb - 2)) & 3;
+    uint16_t index = (msb - 1) * 4 + sub;
+    return index < TIMING_BUCKETS ? index : TIMING_BUCKETS - 1;
+}
+
+// Largest duration that falls into a bucket
+inline uint32_t timingBucketUpper(uint8_t index) {
+    if (index < 4) return index;
+    uint8_t msb = index / 4 + 1;
+    uint8_t sub = index % 4;
+    return (((uint32_t)(4 + sub + 1)) << (msb - 2)) - 1;
+}
+
+inline void timingRecord(TimingHistogram* h, uint32_t us) {
+    uint8_t index = timingBucketIndex(us);
+    if (h->buckets[index] == 0xFFFF) {
+        // Halve everything instead of overflowing, recent samples weigh more
+        for (uint8_t i = 0; i < TIMING_BUCKETS; i++) h->buckets[i] >>= 1;
+    }
+    h->buckets[index]++;
+    h->count++;
+    h->lastUs = us;
+    if (us > h->maxUs) h->maxUs = us;
+}
+
+// Upper bound of the bucket holding the given percentile (0 if empty)
+inline uint32_t timingPercentile(const TimingHistogram* h, uint8_t pct) {
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < TIMING_BUCKETS; i++) total += h->buckets[i];
+    if (total == 0) return 0;
+
+    uint32_t target = (total * pct + 99) / 100;
+    uint32_t seen = 0;
+    for (uint8_t i = 0; i < TIMING_BUCKETS; i++) {
+        seen += h->buckets[i];
+        if (seen >= target) {
+            uint32_t upper = timingBucketUpper(i);
+            return upper < h->maxUs ? upper : h->maxUs;
+        }
+    }
+    return h->maxUs;
+}
+
+inline uint32_t timingCyclesToUs(uint32_t cycles) {
+    static uint32_t cpuMHz = ESP.getCpuFreqMHz();
+    return cycles / cpuMHz;
+}
+
+// Records the lifetime of the enclosing scope
+class ScopedTiming {
+public:
+    explicit ScopedTiming(TimingHistogram* h) : hist(h), start(ESP.getCycleCount()) {}
+    ~ScopedTiming() { timingRecord(hist, timingCyclesToUs(ESP.getCycleCount() - start)); }
+
+private:
+    TimingHistogram* hist;
+    uint32_t start;
+};
+
+#endif // RENDER_TIMING_H
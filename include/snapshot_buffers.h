@@ -0,0 +1,84 @@
+#ifndef SNAPSHOT_BUFFERS_H
+#define SNAPSHOT_BUFFERS_H
+
+#include <Arduino.h>
+#include <atomic>
+
+// ============================================================
+// Snapshot buffers
+// Copies of shared state, one of them published. Readers pin the
+// published copy: a copy is only rewritten once no reader holds
+// it. The single writer fills a free copy and publishes it; when
+// every copy it could use is pinned it keeps its changes for a
+// later attempt. With two or more copies the writer never touches
+// the published one, so readers never wait. With a single copy a
+// reader arriving during the write fails tryPin() and has to wait
+// for the writer by other means. Readers count themselves in
+// before checking the copy, and the writer marks the copy before
+// checking its readers, so one of them always sees the other.
+// The copies are supplied by the owner (attach()), which lets
+// them come from PSRAM.
+// ============================================================
+
+template <typename T, uint8_t COUNT>
+struct SnapshotBuffers {
+    T* copies;                             // COUNT copies, nullptr until attached
+    std::atomic<uint8_t> published;        // Copy handed to readers
+    std::atomic<int8_t> writing;           // Copy being filled, -1 when none
+    std::atomic<uint32_t> readers[COUNT];  // Pins held on each copy
+
+    SnapshotBuffers() : copies(nullptr), published(0), writing(-1) {
+        for (uint8_t i = 0; i < COUNT; i++) readers[i].store(0);
+    }
+
+    void attach(T* storage) {
+        copies = storage;
+    }
+
+    // Reader: pin the published copy, false while the writer fills it
+    // (single copy only)
+    bool tryPin(uint8_t* index) {
+        while (true) {
+            uint8_t i = published.load();
+            readers[i].fetch_add(1);
+            if (published.load() == i) {
+                if (writing.load() == (int8_t)i) {
+                    readers[i].fetch_sub(1);
+                    return false;
+                }
+                *index = i;
+                return true;
+            }
+            // Republished meanwhile, that copy may be rewritten next
+            readers[i].fetch_sub(1);
+        }
+    }
+
+    void unpin(uint8_t index) {
+        readers[index].fetch_sub(1);
+    }
+
+    // Writer: a copy no reader can see, nullptr while all usable ones are pinned
+    T* beginWrite(uint8_t* index) {
+        if (!copies) return nullptr;
+        uint8_t current = published.load();
+        for (uint8_t i = 0; i < COUNT; i++) {
+            if (COUNT > 1 && i == current) continue;
+            writing.store((int8_t)i);
+            if (readers[i].load() == 0) {
+                *index = i;
+                return &copies[i];
+            }
+            writing.store(-1);
+        }
+        return nullptr;
+    }
+
+    // Cleared first, so a reader never finds the new copy still marked
+    void publish(uint8_t index) {
+        writing.store(-1);
+        published.store(index);
+    }
+};
+
+#endif // SNAPSHOT_BUFFERS_H
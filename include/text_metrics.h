@@ -0,0 +1,126 @@
+#ifndef TEXT_METRICS_H
+#define TEXT_METRICS_H
+
+#include <Arduino.h>
+#include <Adafruit_GFX.h>
+
+// ============================================================
+// Text metrics
+// Per-byte cursor advance of a font, copied once from its GFX
+// glyph table, so text widths are a table walk instead of a
+// strlen() times a guessed glyph width. Main text goes through
+// textDecodeSpecial() (degree signs drawn by hand, French
+// accents folded to ASCII); labels are printed raw, bytes the
+// font has no glyph for do not move the cursor.
+// ============================================================
+
+#define TEXT_GLYPH_DEGREE 0xB0  // Decoded degree sign, drawn as a small circle
+#define TEXT_DEGREE_WIDTH 4
+
+struct FontMetrics {
+    uint8_t advance[256];  // 0 = byte not drawn
+};
+
+// font = nullptr for the built-in 5x7 font (6px cells)
+inline void fontMetricsInit(FontMetrics* metrics, const GFXfont* font) {
+    memset(metrics->advance, 0, sizeof(metrics->advance));
+    if (!font) {
+        for (uint16_t c = 32; c <= 126; c++) metrics->advance[c] = 6;
+        return;
+    }
+
+    uint16_t first = pgm_read_word(&font->first);
+    uint16_t last = pgm_read_word(&font->last);
+    const GFXglyph* glyphs = (const GFXglyph*)pgm_read_ptr(&font->glyph);
+    for (uint16_t c = first; c <= last && c < 256; c++) {
+        if (c == '\n' || c == '\r') continue;
+        metrics->advance[c] = pgm_read_byte(&glyphs[c - first].xAdvance);
+    }
+}
+
+// Width of text printed as-is in this font
+inline int16_t fontTextWidth(const FontMetrics* metrics, const char* text) {
+    int16_t width = 0;
+    for (const uint8_t* p = (const uint8_t*)text; *p; p++) width += metrics->advance[*p];
+    return width;
+}
+
+// Bytes of the longest prefix that fits in maxWidth
+inline size_t fontFitLength(const FontMetrics* metrics, const char* text, int16_t maxWidth) {
+    const uint8_t* p = (const uint8_t*)text;
+    int16_t width = 0;
+    while (*p && width + metrics->advance[*p] <= maxWidth) width += metrics->advance[*p++];
+    return p - (const uint8_t*)text;
+}
+
+// Decode one drawn character of main text. *glyph receives the ASCII glyph
+// to print, TEXT_GLYPH_DEGREE, or 0 for a byte that is skipped. Returns the
+// bytes consumed.
+inline uint8_t textDecodeSpecial(const uint8_t* p, uint8_t* glyph) {
+    uint8_t c = p[0];
+
+    // UTF-8 (C2 B0) and Latin-1 (B0) degree sign
+    if (c == 0xC2 && p[1] == 0xB0) {
+        *glyph = TEXT_GLYPH_DEGREE;
+        return 2;
+    }
+    if (c == 0xB0) {
+        *glyph = TEXT_GLYPH_DEGREE;
+        return 1;
+    }
+
+    // UTF-8 accented characters (common French)
+    if (c == 0xC3 && p[1]) {
+        switch (p[1]) {
+            case 0xA0: case 0xA2: case 0xA4: *glyph = 'a'; break;  // a grave, circumflex, umlaut
+            case 0xA8: case 0xA9: case 0xAA: case 0xAB: *glyph = 'e'; break;  // e variants
+            case 0xAC: case 0xAE: case 0xAF: *glyph = 'i'; break;  // i variants
+            case 0xB2: case 0xB4: case 0xB6: *glyph = 'o'; break;  // o variants
+            case 0xB9: case 0xBB: case 0xBC: *glyph = 'u'; break;  // u variants
+            case 0xA7: *glyph = 'c'; break;  // c cedilla
+            case 0xB1: *glyph = 'n'; break;  // n tilde
+            case 0x80: case 0x89: *glyph = 'E'; break;  // E accent
+            case 0x87: *glyph = 'C'; break;  // C cedilla
+            default: *glyph = '?'; break;
+        }
+        return 2;
+    }
+
+    // Standard ASCII, other non-printable bytes are skipped
+    *glyph = (c >= 32 && c <= 126) ? c : 0;
+    return 1;
+}
+
+inline uint8_t textGlyphAdvance(const FontMetrics* metrics, uint8_t glyph) {
+    return glyph == TEXT_GLYPH_DEGREE ? TEXT_DEGREE_WIDTH : metrics->advance[glyph];
+}
+
+// Width of main text as drawn by printTextWithSpecialChars()
+inline int16_t textSpecialWidth(const FontMetrics* metrics, const char* text) {
+    int16_t width = 0;
+    const uint8_t* p = (const uint8_t*)text;
+    while (*p) {
+        uint8_t glyph;
+        p += textDecodeSpecial(p, &glyph);
+        width += textGlyphAdvance(metrics, glyph);
+    }
+    return width;
+}
+
+// Bytes of the longest prefix that fits in maxWidth, never splitting a
+// multi-byte character
+inline size_t textSpecialFitLength(const FontMetrics* metrics, const char* text, int16_t maxWidth) {
+    const uint8_t* p = (const uint8_t*)text;
+    int16_t width = 0;
+    while (*p) {
+        uint8_t glyph;
+        uint8_t bytes = textDecodeSpecial(p, &glyph);
+        uint8_t advance = textGlyphAdvance(metrics, glyph);
+        if (width + advance > maxWidth) break;
+        width += advance;
+        p += bytes;
+    }
+    return p - (const uint8_t*)text;
+}
+
+#endif // TEXT_METRICS_H
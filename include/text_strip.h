@@ -0,0 +1,101 @@
+#ifndef TEXT_STRIP_H
+#define TEXT_STRIP_H
+
+#include <Arduino.h>
+#include <Adafruit_GFX.h>
+
+// ============================================================
+// Pre-rendered text strip (1bpp mask + per-column color runs)
+// Text is rasterized once, scrolling frames only blit a window
+// ============================================================
+
+#define TEXT_STRIP_ASCENT 6     // Rows above the cursor (degree symbol sits at y-6)
+#define TEXT_STRIP_HEIGHT 14    // Ascent + 8px glyph cell
+#define TEXT_STRIP_MAX_RUNS 16
+
+struct TextColorRun {
+    int16_t x;        // First strip column using this color
+    uint16_t color;   // RGB565
+};
+
+// 1bpp canvas that remembers which color each column was drawn with.
+// Glyphs are drawn left to right and a column never mixes colors,
+// so a short run table is enough to colorize the mask. A glyph may
+// be drawn row by row (TomThumb, the degree sign), so its first lit
+// pixel is not always its leftmost: a run starts at the smallest x
+// drawn with its color, and earlier runs it covers are dropped.
+class TextStripCanvas : public GFXcanvas1 {
+public:
+    TextColorRun runs[TEXT_STRIP_MAX_RUNS];
+    uint8_t runCount = 0;
+    bool runOverflow = false;
+
+    TextStripCanvas(uint16_t w, uint16_t h) : GFXcanvas1(w, h) {}
+
+    void drawPixel(int16_t x, int16_t y, uint16_t color) override {
+        if (color == 0) return;  // Black text is invisible on the panel anyway
+        GFXcanvas1::drawPixel(x, y, 1);
+
+        if (runCount > 0 && runs[runCount - 1].color == color) {
+            if (x < runs[runCount - 1].x) startLastRunAt(x);
+            return;
+        }
+        if (runCount > 0 && runs[runCount - 1].x >= x) {
+            runs[runCount - 1].color = color;
+            startLastRunAt(x);
+            return;
+        }
+        if (runCount >= TEXT_STRIP_MAX_RUNS) {
+            runOverflow = true;
+            return;
+        }
+        runs[runCount].x = x;
+        runs[runCount].color = color;
+        runCount++;
+    }
+
+private:
+    // Move the last run's start left, dropping the runs it now covers
+    void startLastRunAt(int16_t x) {
+        runs[runCount - 1].x = x;
+        while (runCount > 1 && runs[runCount - 2].x >= x) {
+            runs[runCount - 2] = runs[runCount - 1];
+            runCount--;
+        }
+    }
+};
+
+// Blit the strip into an RGB565 canvas, strip column 0 at x, cursor row at y
+inline void drawTextStrip(GFXcanvas16* dst, const TextStripCanvas* strip, int16_t x, int16_t y) {
+    if (!dst || !strip || strip->runCount == 0) return;
+
+    uint16_t* pixels = dst->getBuffer();
+    const uint8_t* mask = strip->getBuffer();
+    int16_t dstW = dst->width();
+    int16_t dstH = dst->height();
+    int16_t stripW = strip->width();
+    int16_t maskStride = (stripW + 7) / 8;
+    int16_t top = y - TEXT_STRIP_ASCENT;
+
+    int16_t colStart = max((int16_t)0, (int16_t)-x);
+    int16_t colEnd = min(stripW, (int16_t)(dstW - x));
+    int16_t rowStart = max((int16_t)0, (int16_t)-top);
+    int16_t rowEnd = min((int16_t)TEXT_STRIP_HEIGHT, (int16_t)(dstH - top));
+
+    uint8_t run = 0;
+    for (int16_t col = colStart; col < colEnd; col++) {
+        while (run + 1 < strip->runCount && strip->runs[run + 1].x <= col) run++;
+        uint16_t color = strip->runs[run].color;
+        uint8_t bit = 0x80 >> (col & 7);
+        const uint8_t* maskCol = mask + (col >> 3);
+        uint16_t* dstCol = pixels + x + col;
+
+        for (int16_t row = rowStart; row < rowEnd; row++) {
+            if (maskCol[row * maskStride] & bit) {
+                dstCol[(top + row) * dstW] = color;
+            }
+        }
+    }
+}
+
+#endif // TEXT_STRIP_H
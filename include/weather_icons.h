@@ -2,15 +2,17 @@
 #define WEATHER_ICONS_H
 
 #include <Arduino.h>
-#include <ESP32-HUB75-MatrixPanel-I2S-DMA.h>
+#include "panel_color.h"
+#include "name_index.h"
 
 // ============================================================
 // Built-in PROGMEM weather icons (8x8 pixel art, RGB565)
-// Eliminates filesystem dependency for weather dashboard
+// Eliminates filesystem dependency for weather dashboard.
+// getIcon() serves them like cached icons, by name.
 // ============================================================
 
-// Compile-time RGB565 color conversion
-#define WI_RGB565(r, g, b) (uint16_t)(((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3))
+// Compile-time panel color conversion (gamma corrected RGB565)
+#define WI_RGB565(r, g, b) panelColor(r, g, b)
 
 // Named palette for pixel art readability (WI_ prefix avoids ctype.h collisions)
 #define WI__  0x0000                       // Transparent (black = skip)
@@ -27,8 +29,32 @@
 #define WI_F  WI_RGB565(150, 150, 140)     // Fog gray
 #define WI_E  WI_RGB565(255, 240, 80)      // Lightning yellow
 
-// ---- Clear day: sun with rays ----
-const uint16_t w_clear_day[64] PROGMEM = {
+// ============================================================
+// Sprite atlas
+// All sprites packed back to back in one PROGMEM block, sprite N
+// starting at WEATHER_ATLAS + N * 64. The name of sprite N is
+// WEATHER_SPRITE_NAMES[N]; keep both lists in the same order.
+// ============================================================
+
+enum WeatherSprite : uint8_t {
+    WS_CLEAR_DAY,
+    WS_CLEAR_NIGHT,
+    WS_PARTLY_DAY,
+    WS_PARTLY_NIGHT,
+    WS_CLOUDY,
+    WS_RAIN,
+    WS_HEAVY_RAIN,
+    WS_THUNDER,
+    WS_SNOW,
+    WS_FOG,
+    WEATHER_SPRITE_COUNT
+};
+
+#define WEATHER_SPRITE_SIZE   8
+#define WEATHER_SPRITE_PIXELS (WEATHER_SPRITE_SIZE * WEATHER_SPRITE_SIZE)
+
+constexpr uint16_t WEATHER_ATLAS[WEATHER_SPRITE_COUNT * WEATHER_SPRITE_PIXELS] PROGMEM = {
+    // ---- Clear day: sun with rays ----
     WI__, WI__, WI_A, WI__, WI__, WI_A, WI__, WI__,
     WI__, WI__, WI__, WI_Y, WI_Y, WI__, WI__, WI__,
     WI_A, WI__, WI_Y, WI_Y, WI_Y, WI_Y, WI__, WI_A,
@@ -37,10 +63,8 @@ const uint16_t w_clear_day[64] PROGMEM = {
     WI_A, WI__, WI_Y, WI_Y, WI_Y, WI_Y, WI__, WI_A,
     WI__, WI__, WI__, WI_Y, WI_Y, WI__, WI__, WI__,
     WI__, WI__, WI_A, WI__, WI__, WI_A, WI__, WI__,
-};
 
-// ---- Clear night: crescent moon ----
-const uint16_t w_clear_night[64] PROGMEM = {
+    // ---- Clear night: crescent moon ----
     WI__, WI__, WI__, WI_P, WI_P, WI__, WI__, WI__,
     WI__, WI__, WI_P, WI_P, WI__, WI__, WI__, WI__,
     WI__, WI_P, WI_P, WI__, WI__, WI__, WI__, WI__,
@@ -49,10 +73,8 @@ const uint16_t w_clear_night[64] PROGMEM = {
     WI__, WI_P, WI_P, WI__, WI__, WI__, WI__, WI__,
     WI__, WI__, WI_P, WI_P, WI__, WI__, WI__, WI__,
     WI__, WI__, WI__, WI_P, WI_P, WI__, WI__, WI__,
-};
 
-// ---- Partly cloudy day: small sun top-right + cloud bottom-left ----
-const uint16_t w_partly_day[64] PROGMEM = {
+    // ---- Partly cloudy day: small sun top-right + cloud bottom-left ----
     WI__, WI__, WI__, WI__, WI_A, WI__, WI_A, WI__,
     WI__, WI__, WI__, WI__, WI__, WI_Y, WI__, WI__,
     WI__, WI__, WI__, WI__, WI_Y, WI_Y, WI_Y, WI_A,
@@ -61,10 +83,8 @@ const uint16_t w_partly_day[64] PROGMEM = {
     WI_W, WI_W, WI_L, WI_L, WI_W, WI_W, WI__, WI__,
     WI_L, WI_L, WI_G, WI_G, WI_L, WI_L, WI__, WI__,
     WI__, WI_D, WI_D, WI_D, WI_D, WI__, WI__, WI__,
-};
 
-// ---- Partly cloudy night: small moon top-right + cloud bottom-left ----
-const uint16_t w_partly_night[64] PROGMEM = {
+    // ---- Partly cloudy night: small moon top-right + cloud bottom-left ----
     WI__, WI__, WI__, WI__, WI__, WI_P, WI_P, WI__,
     WI__, WI__, WI__, WI__, WI_P, WI_P, WI__, WI__,
     WI__, WI__, WI__, WI__, WI_P, WI_P, WI__, WI__,
@@ -73,10 +93,8 @@ const uint16_t w_partly_night[64] PROGMEM = {
     WI_W, WI_W, WI_L, WI_L, WI_W, WI_W, WI__, WI__,
     WI_L, WI_L, WI_G, WI_G, WI_L, WI_L, WI__, WI__,
     WI__, WI_D, WI_D, WI_D, WI_D, WI__, WI__, WI__,
-};
 
-// ---- Cloudy: full cloud ----
-const uint16_t w_cloudy[64] PROGMEM = {
+    // ---- Cloudy: full cloud ----
     WI__, WI__, WI__, WI__, WI__, WI__, WI__, WI__,
     WI__, WI__, WI_W, WI_W, WI__, WI__, WI__, WI__,
     WI__, WI_W, WI_W, WI_W, WI_W, WI_W, WI__, WI__,
@@ -85,10 +103,8 @@ const uint16_t w_cloudy[64] PROGMEM = {
     WI_L, WI_L, WI_G, WI_G, WI_G, WI_L, WI_L, WI__,
     WI__, WI_G, WI_D, WI_D, WI_D, WI_G, WI__, WI__,
     WI__, WI__, WI__, WI__, WI__, WI__, WI__, WI__,
-};
 
-// ---- Rain: cloud + rain drops ----
-const uint16_t w_rain[64] PROGMEM = {
+    // ---- Rain: cloud + rain drops ----
     WI__, WI__, WI_W, WI_W, WI__, WI__, WI__, WI__,
     WI__, WI_W, WI_W, WI_W, WI_W, WI_W, WI__, WI__,
     WI_W, WI_W, WI_L, WI_L, WI_W, WI_W, WI_W, WI__,
@@ -97,10 +113,8 @@ const uint16_t w_rain[64] PROGMEM = {
     WI__, WI_B, WI__, WI__, WI_B, WI__, WI__, WI__,
     WI__, WI__, WI__, WI_B, WI__, WI__, WI_B, WI__,
     WI__, WI__, WI__, WI__, WI__, WI__, WI__, WI__,
-};
 
-// ---- Heavy rain: cloud + many drops ----
-const uint16_t w_heavy_rain[64] PROGMEM = {
+    // ---- Heavy rain: cloud + many drops ----
     WI__, WI__, WI_W, WI_W, WI__, WI__, WI__, WI__,
     WI__, WI_W, WI_W, WI_W, WI_W, WI_W, WI__, WI__,
     WI_W, WI_W, WI_L, WI_L, WI_W, WI_W, WI_W, WI__,
@@ -109,10 +123,8 @@ const uint16_t w_heavy_rain[64] PROGMEM = {
     WI_C, WI__, WI_C, WI__, WI_C, WI__, WI_C, WI__,
     WI__, WI_C, WI__, WI_C, WI__, WI_C, WI__, WI__,
     WI__, WI__, WI__, WI__, WI__, WI__, WI__, WI__,
-};
 
-// ---- Thunderstorm: cloud + lightning bolt ----
-const uint16_t w_thunder[64] PROGMEM = {
+    // ---- Thunderstorm: cloud + lightning bolt ----
     WI__, WI__, WI_W, WI_W, WI__, WI__, WI__, WI__,
     WI__, WI_W, WI_W, WI_W, WI_W, WI_W, WI__, WI__,
     WI_W, WI_W, WI_L, WI_L, WI_W, WI_W, WI_W, WI__,
@@ -121,10 +133,8 @@ const uint16_t w_thunder[64] PROGMEM = {
     WI__, WI__, WI_E, WI_E, WI__, WI__, WI__, WI__,
     WI__, WI__, WI__, WI_E, WI_E, WI__, WI__, WI__,
     WI__, WI__, WI__, WI_E, WI__, WI__, WI__, WI__,
-};
 
-// ---- Snow: cloud + snowflakes ----
-const uint16_t w_snow[64] PROGMEM = {
+    // ---- Snow: cloud + snowflakes ----
     WI__, WI__, WI_W, WI_W, WI__, WI__, WI__, WI__,
     WI__, WI_W, WI_W, WI_W, WI_W, WI_W, WI__, WI__,
     WI_W, WI_W, WI_L, WI_L, WI_W, WI_W, WI_W, WI__,
@@ -133,10 +143,8 @@ const uint16_t w_snow[64] PROGMEM = {
     WI__, WI_S, WI__, WI__, WI_S, WI__, WI_S, WI__,
     WI__, WI__, WI_S, WI__, WI__, WI_S, WI__, WI__,
     WI__, WI__, WI__, WI_S, WI__, WI__, WI__, WI__,
-};
 
-// ---- Fog: horizontal dashed lines ----
-const uint16_t w_fog[64] PROGMEM = {
+    // ---- Fog: horizontal dashed lines ----
     WI__, WI__, WI__, WI__, WI__, WI__, WI__, WI__,
     WI__, WI_F, WI_F, WI_F, WI_F, WI_F, WI_F, WI__,
     WI__, WI__, WI__, WI__, WI__, WI__, WI__, WI__,
@@ -144,9 +152,24 @@ const uint16_t w_fog[64] PROGMEM = {
     WI__, WI__, WI__, WI__, WI__, WI__, WI__, WI__,
     WI__, WI__, WI_F, WI_F, WI_F, WI_F, WI_F, WI__,
     WI__, WI__, WI__, WI__, WI__, WI__, WI__, WI__,
-    WI_F, WI_F, WI_F, WI__, WI_F, WI_F, WI_F, WI__,
+    WI_F, WI_F, WI_F, WI__, WI_F, WI_F, WI_F, WI__
 };
 
+// Opaque runs of a sprite from pixel p on, as counted by buildIconSpans()
+constexpr uint16_t weatherSpriteRuns(uint8_t sprite, uint8_t p) {
+    return p >= WEATHER_SPRITE_PIXELS ? 0
+         : (WEATHER_ATLAS[sprite * WEATHER_SPRITE_PIXELS + p] != 0 &&
+            (p % WEATHER_SPRITE_SIZE == 0 || WEATHER_ATLAS[sprite * WEATHER_SPRITE_PIXELS + p - 1] == 0))
+           + weatherSpriteRuns(sprite, p + 1);
+}
+
+constexpr uint16_t weatherAtlasRuns(uint8_t sprite) {
+    return sprite >= WEATHER_SPRITE_COUNT ? 0 : weatherSpriteRuns(sprite, 0) + weatherAtlasRuns(sprite + 1);
+}
+
+// Span entries needed by the whole atlas
+constexpr uint16_t WEATHER_ATLAS_SPANS = weatherAtlasRuns(0);
+
 // Clean up palette macros
 #undef WI__
 #undef WI_Y
@@ -164,63 +187,76 @@ const uint16_t w_fog[64] PROGMEM = {
 #undef WI_RGB565
 
 // ============================================================
-// Lookup table: API name -> PROGMEM icon pointer
+// Name lookup: perfect hash generated at compile time
+// A sprite's slot is a bit field of nameHash(name); the shift is
+// the first one that gives every sprite its own slot, found by
+// the compiler. A lookup is then one hash, one table read and a
+// single strcmp to reject names that are not sprites.
 // ============================================================
 
-struct ProgmemWeatherIcon {
-    const char* name;
-    const uint16_t* pixels;
+constexpr const char* WEATHER_SPRITE_NAMES[WEATHER_SPRITE_COUNT] = {
+    "w_clear_day",
+    "w_clear_night",
+    "w_partly_day",
+    "w_partly_night",
+    "w_cloudy",
+    "w_rain",
+    "w_heavy_rain",
+    "w_thunder",
+    "w_snow",
+    "w_fog",
 };
 
-const ProgmemWeatherIcon PROGMEM_WEATHER_ICONS[] = {
-    { "w_clear_day",    w_clear_day },
-    { "w_clear_night",  w_clear_night },
-    { "w_partly_day",   w_partly_day },
-    { "w_partly_night", w_partly_night },
-    { "w_cloudy",       w_cloudy },
-    { "w_rain",         w_rain },
-    { "w_heavy_rain",   w_heavy_rain },
-    { "w_thunder",      w_thunder },
-    { "w_snow",         w_snow },
-    { "w_fog",          w_fog },
+#define WEATHER_ATLAS_SLOTS 32  // Power of two, room to spare so a shift is easy to find
+
+constexpr uint8_t weatherAtlasSlot(uint32_t hash, uint8_t shift) {
+    return (hash >> shift) & (WEATHER_ATLAS_SLOTS - 1);
+}
+
+constexpr uint8_t weatherSpriteSlot(uint8_t sprite, uint8_t shift) {
+    return weatherAtlasSlot(nameHashConst(WEATHER_SPRITE_NAMES[sprite]), shift);
+}
+
+// True if any two sprites from (i, j) onwards share a slot
+constexpr bool weatherAtlasClash(uint8_t shift, uint8_t i, uint8_t j) {
+    return i >= WEATHER_SPRITE_COUNT ? false
+         : j >= WEATHER_SPRITE_COUNT ? weatherAtlasClash(shift, i + 1, i + 2)
+         : weatherSpriteSlot(i, shift) == weatherSpriteSlot(j, shift) || weatherAtlasClash(shift, i, j + 1);
+}
+
+constexpr uint8_t weatherAtlasFindShift(uint8_t shift) {
+    return shift > 32 - 5 ? 0xFF
+         : !weatherAtlasClash(shift, 0, 1) ? shift
+         : weatherAtlasFindShift(shift + 1);
+}
+
+constexpr uint8_t WEATHER_ATLAS_SHIFT = weatherAtlasFindShift(0);
+static_assert(WEATHER_ATLAS_SLOTS == 32, "weatherAtlasFindShift() assumes 5 slot bits");
+static_assert(WEATHER_ATLAS_SHIFT != 0xFF, "No collision-free slot layout, raise WEATHER_ATLAS_SLOTS");
+
+// Sprite + 1 owning a slot, 0 if none
+constexpr uint8_t weatherAtlasEntry(uint8_t slot, uint8_t sprite) {
+    return sprite >= WEATHER_SPRITE_COUNT ? 0
+         : weatherSpriteSlot(sprite, WEATHER_ATLAS_SHIFT) == slot ? sprite + 1
+         : weatherAtlasEntry(slot, sprite + 1);
+}
+
+#define WA_ROW(s) weatherAtlasEntry(s, 0), weatherAtlasEntry(s + 1, 0), weatherAtlasEntry(s + 2, 0), weatherAtlasEntry(s + 3, 0), \
+                  weatherAtlasEntry(s + 4, 0), weatherAtlasEntry(s + 5, 0), weatherAtlasEntry(s + 6, 0), weatherAtlasEntry(s + 7, 0)
+const uint8_t WEATHER_ATLAS_INDEX[WEATHER_ATLAS_SLOTS] PROGMEM = {
+    WA_ROW(0), WA_ROW(8), WA_ROW(16), WA_ROW(24)
 };
+#undef WA_ROW
 
-const uint8_t PROGMEM_WEATHER_ICON_COUNT = sizeof(PROGMEM_WEATHER_ICONS) / sizeof(PROGMEM_WEATHER_ICONS[0]);
-
-// Lookup builtin icon by name, returns nullptr if not found
-inline const uint16_t* getBuiltinWeatherIcon(const char* name) {
-    if (!name) return nullptr;
-    for (uint8_t i = 0; i < PROGMEM_WEATHER_ICON_COUNT; i++) {
-        if (strcmp(name, PROGMEM_WEATHER_ICONS[i].name) == 0) {
-            return PROGMEM_WEATHER_ICONS[i].pixels;
-        }
-    }
-    return nullptr;
+// Sprite for a name whose nameHash() is already known, -1 if not a builtin
+inline int8_t weatherSpriteFind(const char* name, uint32_t hash) {
+    uint8_t entry = pgm_read_byte(&WEATHER_ATLAS_INDEX[weatherAtlasSlot(hash, WEATHER_ATLAS_SHIFT)]);
+    if (entry == 0 || strcmp(name, WEATHER_SPRITE_NAMES[entry - 1]) != 0) return -1;
+    return entry - 1;
 }
 
-// Draw a PROGMEM 8x8 icon at position (x, y) with optional scale
-// Reads pixels via pgm_read_word(); 0x0000 = transparent (skipped)
-inline void drawProgmemIcon(MatrixPanel_I2S_DMA* display, const uint16_t* progmemPixels,
-                            int16_t x, int16_t y, uint8_t scale) {
-    if (!display || !progmemPixels) return;
-
-    for (uint8_t py = 0; py < 8; py++) {
-        for (uint8_t px = 0; px < 8; px++) {
-            uint16_t pixel = pgm_read_word(&progmemPixels[py * 8 + px]);
-            if (pixel != 0x0000) {
-                if (scale == 2) {
-                    int16_t dx = x + px * 2;
-                    int16_t dy = y + py * 2;
-                    display->drawPixel(dx, dy, pixel);
-                    display->drawPixel(dx + 1, dy, pixel);
-                    display->drawPixel(dx, dy + 1, pixel);
-                    display->drawPixel(dx + 1, dy + 1, pixel);
-                } else {
-                    display->drawPixel(x + px, y + py, pixel);
-                }
-            }
-        }
-    }
+inline const uint16_t* weatherSpritePixels(uint8_t sprite) {
+    return WEATHER_ATLAS + sprite * WEATHER_SPRITE_PIXELS;
 }
 
 #endif // WEATHER_ICONS_H
@@ -0,0 +1,11 @@
+#ifndef SIM_ADAFRUIT_I2CDEVICE_H
+#define SIM_ADAFRUIT_I2CDEVICE_H
+
+// Host shim: Adafruit_GFX.h includes the BusIO headers, but only the
+// SPI/I2C display drivers (not built natively) use them.
+
+#include <Arduino.h>
+
+class Adafruit_I2CDevice;
+
+#endif // SIM_ADAFRUIT_I2CDEVICE_H
@@ -0,0 +1,10 @@
+#ifndef SIM_ADAFRUIT_SPIDEVICE_H
+#define SIM_ADAFRUIT_SPIDEVICE_H
+
+// Host shim: see Adafruit_I2CDevice.h
+
+#include <Arduino.h>
+
+class Adafruit_SPIDevice;
+
+#endif // SIM_ADAFRUIT_SPIDEVICE_H
@@ -0,0 +1,117 @@
+#ifndef SIM_ARDUINO_H
+#define SIM_ARDUINO_H
+
+// ============================================================
+// Host shim: the subset of the ESP32 Arduino core used by the
+// firmware. Time is virtual (see simAdvanceMs) so rendered
+// frames are reproducible; the cycle counter follows the real
+// clock so render timings stay meaningful.
+// ============================================================
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <limits.h>
+#include <math.h>
+#include <time.h>
+#include <algorithm>
+#include <functional>
+
+#include "WString.h"
+#include "Print.h"
+#include "Stream.h"
+
+using std::min;
+using std::max;
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define PROGMEM
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define PSTR(s) (s)
+#define F(s) (s)
+#define pgm_read_byte(addr)  (*(const uint8_t*)(addr))
+#define pgm_read_word(addr)  (*(const uint16_t*)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t*)(addr))
+#define pgm_read_ptr(addr)   (*(void* const*)(addr))
+#define memcpy_P memcpy
+#define strlen_P strlen
+
+#ifndef constrain
+    #define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+#endif
+
+#if defined(__GLIBC__) && !(__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 38))
+inline size_t strlcpy(char* dst, const char* src, size_t size) {
+    size_t len = strlen(src);
+    if (size > 0) {
+        size_t n = len < size - 1 ? len : size - 1;
+        memcpy(dst, src, n);
+        dst[n] = '\0';
+    }
+    return len;
+}
+#endif
+
+// Virtual clock
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void simAdvanceMs(unsigned long ms);
+inline void yield() {}
+
+inline long random(long howbig) { return howbig > 0 ? rand() % howbig : 0; }
+inline long random(long howsmall, long howbig) {
+    return howsmall >= howbig ? howsmall : howsmall + random(howbig - howsmall);
+}
+
+inline void configTzTime(const char* tz, const char*, const char* = nullptr, const char* = nullptr) {
+    setenv("TZ", tz, 1);
+    tzset();
+}
+
+class HardwareSerial : public Stream {
+public:
+    void begin(unsigned long) {}
+    size_t write(uint8_t c) override { return fputc(c, stdout) == EOF ? 0 : 1; }
+    size_t write(const uint8_t* buffer, size_t size) override { return fwrite(buffer, 1, size, stdout); }
+    using Print::write;
+};
+extern HardwareSerial Serial;
+
+class IPAddress : public Printable {
+public:
+    IPAddress(uint8_t a = 0, uint8_t b = 0, uint8_t c = 0, uint8_t d = 0) : octets{a, b, c, d} {}
+    String toString() const {
+        char buf[16];
+        snprintf(buf, sizeof(buf), "%u.%u.%u.%u", octets[0], octets[1], octets[2], octets[3]);
+        return String(buf);
+    }
+    size_t printTo(Print& p) const override { return p.print(toString()); }
+
+private:
+    uint8_t octets[4];
+};
+
+class EspClass {
+public:
+    uint32_t getFreeHeap() { return 256 * 1024; }
+    uint32_t getMaxAllocHeap() { return 128 * 1024; }
+    uint32_t getHeapSize() { return 320 * 1024; }
+    uint64_t getEfuseMac() { return 0x0000AABBCCDDEEFFULL; }
+    uint32_t getCpuFreqMHz() { return 240; }
+    uint32_t getCycleCount();
+    void restart() { exit(0); }
+};
+extern EspClass ESP;
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+#endif // SIM_ARDUINO_H
@@ -0,0 +1,20 @@
+#ifndef SIM_ARDUINO_OTA_H
+#define SIM_ARDUINO_OTA_H
+
+#include <Arduino.h>
+
+typedef int ota_error_t;
+
+class ArduinoOTAClass {
+public:
+    void setHostname(const char*) {}
+    void onStart(std::function<void()>) {}
+    void onEnd(std::function<void()>) {}
+    void onProgress(std::function<void(unsigned int, unsigned int)>) {}
+    void onError(std::function<void(ota_error_t)>) {}
+    void begin() {}
+    void handle() {}
+};
+extern ArduinoOTAClass ArduinoOTA;
+
+#endif // SIM_ARDUINO_OTA_H
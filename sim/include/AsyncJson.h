@@ -0,0 +1,16 @@
+#ifndef SIM_ASYNC_JSON_H
+#define SIM_ASYNC_JSON_H
+
+#include "ESPAsyncWebServer.h"
+#include <ArduinoJson.h>
+
+typedef std::function<void(AsyncWebServerRequest*, JsonVariant&)> ArJsonRequestHandlerFunction;
+
+class AsyncCallbackJsonWebHandler : public AsyncWebHandler {
+public:
+    AsyncCallbackJsonWebHandler(const String&, ArJsonRequestHandlerFunction = nullptr) {}
+    void setMethod(WebRequestMethodComposite) {}
+    void setMaxContentLength(int) {}
+};
+
+#endif // SIM_ASYNC_JSON_H
@@ -0,0 +1,6 @@
+#ifndef SIM_ASYNC_TCP_H
+#define SIM_ASYNC_TCP_H
+
+#include <Arduino.h>
+
+#endif // SIM_ASYNC_TCP_H
@@ -0,0 +1,157 @@
+#ifndef SIM_MATRIX_PANEL_H
+#define SIM_MATRIX_PANEL_H
+
+// ============================================================
+// Host shim: HUB75 DMA panel backed by RGB565 framebuffers.
+// Mirrors the front/back buffer behaviour of the real driver so
+// only flipped frames are visible, and dumps the visible frame
+// as a binary PPM for inspection. With NO_CIE1931 the frame holds
+// linear light, which is re-encoded to lightness for the image.
+// ============================================================
+
+#include <Arduino.h>
+#include <Adafruit_GFX.h>
+
+struct HUB75_I2S_CFG {
+    enum shift_driver { SHIFTREG = 0, FM6124, FM6126A, ICN2038S, MBI5124, SM5266P, DP3246_SM5368 };
+
+    struct i2s_pins {
+        int8_t r1, g1, b1, r2, g2, b2, a, b, c, d, e, lat, oe, clk;
+    } gpio;
+
+    uint16_t mx_width;
+    uint16_t mx_height;
+    uint16_t chain_length;
+    bool clkphase;
+    shift_driver driver;
+    bool double_buff;
+
+    HUB75_I2S_CFG(uint16_t width = 64, uint16_t height = 32, uint16_t chain = 1)
+        : gpio(), mx_width(width), mx_height(height), chain_length(chain),
+          clkphase(true), driver(SHIFTREG), double_buff(false) {}
+};
+
+class MatrixPanel_I2S_DMA : public Adafruit_GFX {
+public:
+    explicit MatrixPanel_I2S_DMA(const HUB75_I2S_CFG& cfg)
+        : Adafruit_GFX(cfg.mx_width * cfg.chain_length, cfg.mx_height), config(cfg),
+          pixels(cfg.mx_width * cfg.chain_length * cfg.mx_height),
+          front(nullptr), back(nullptr), brightness(128), flips(0) {}
+
+    ~MatrixPanel_I2S_DMA() {
+        free(front);
+        if (back != front) free(back);
+    }
+
+    bool begin() {
+        front = (uint16_t*)calloc(pixels, sizeof(uint16_t));
+        back = config.double_buff ? (uint16_t*)calloc(pixels, sizeof(uint16_t)) : front;
+        return front && back;
+    }
+
+    void drawPixel(int16_t x, int16_t y, uint16_t color) override { drawPixelRGB565(x, y, color); }
+
+    void drawPixelRGB565(int16_t x, int16_t y, uint16_t color) {
+        if (!back || x < 0 || y < 0 || x >= _width || y >= _height) return;
+        back[y * _width + x] = color;
+    }
+
+    // Single-color run, the driver's fast DMA line path
+    void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override {
+        for (int16_t i = 0; i < w; i++) drawPixelRGB565(x + i, y, color);
+    }
+
+    void drawPixelRGB888(int16_t x, int16_t y, uint8_t r, uint8_t g, uint8_t b) {
+        drawPixelRGB565(x, y, color565(r, g, b));
+    }
+
+    void fillScreen(uint16_t color) override {
+        if (!back) return;
+        for (uint32_t i = 0; i < pixels; i++) back[i] = color;
+    }
+
+    void clearScreen() { fillScreen(0); }
+
+    void flipDMABuffer() {
+        if (!config.double_buff) return;
+        uint16_t* tmp = front;
+        front = back;
+        back = tmp;
+        flips++;
+    }
+
+    void setBrightness8(uint8_t b) { brightness = b; }
+    uint8_t getBrightness() const { return brightness; }
+    uint32_t getFlipCount() const { return flips; }
+
+    static uint16_t color565(uint8_t r, uint8_t g, uint8_t b) {
+        return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+    }
+
+    // Visible frame (what the LEDs would show, before brightness)
+    const uint16_t* frontBuffer() const { return front; }
+
+    // Write the visible frame as a binary PPM, each LED scaled to a
+    // scale x scale block so small panels are readable in an image viewer
+    bool writePPM(const char* path, uint8_t scale = 1) const {
+        if (!front || scale == 0) return false;
+        FILE* f = fopen(path, "wb");
+        if (!f) return false;
+
+        fprintf(f, "P6\n%d %d\n255\n", _width * scale, _height * scale);
+        uint8_t* row = (uint8_t*)malloc(_width * scale * 3);
+        if (!row) {
+            fclose(f);
+            return false;
+        }
+        for (int16_t y = 0; y < _height; y++) {
+            for (int16_t x = 0; x < _width; x++) {
+                uint16_t c = front[y * _width + x];
+                uint8_t r = (c >> 11) & 0x1F;
+                uint8_t g = (c >> 5) & 0x3F;
+                uint8_t b = c & 0x1F;
+                r = toImage((r << 3) | (r >> 2));
+                g = toImage((g << 2) | (g >> 4));
+                b = toImage((b << 3) | (b >> 2));
+                for (uint8_t s = 0; s < scale; s++) {
+                    uint8_t* px = row + (x * scale + s) * 3;
+                    px[0] = r;
+                    px[1] = g;
+                    px[2] = b;
+                }
+            }
+            for (uint8_t s = 0; s < scale; s++) fwrite(row, 1, _width * scale * 3, f);
+        }
+        free(row);
+        return fclose(f) == 0;
+    }
+
+private:
+    // Inverse of the CIE 1931 correction the real driver applies by default
+    static uint8_t toImage(uint8_t v) {
+#ifdef NO_CIE1931
+        static uint8_t table[256];
+        static bool ready = false;
+        if (!ready) {
+            for (int i = 0; i < 256; i++) {
+                float y = i / 255.0f;
+                float l = y <= 0.008856f ? y * 903.3f : 116.0f * cbrtf(y) - 16.0f;
+                table[i] = (uint8_t)(l * 2.55f + 0.5f);
+            }
+            ready = true;
+        }
+        return table[v];
+#else
+        return v;
+#endif
+    }
+
+    HUB75_I2S_CFG config;
+    uint32_t pixels;
+    uint16_t* front;
+    uint16_t* back;
+    uint8_t brightness;
+    uint32_t flips;
+};
+
+#endif // SIM_MATRIX_PANEL_H
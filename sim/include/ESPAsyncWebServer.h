@@ -0,0 +1,80 @@
+#ifndef SIM_ESP_ASYNC_WEBSERVER_H
+#define SIM_ESP_ASYNC_WEBSERVER_H
+
+// ============================================================
+// Host shim: routes are registered and discarded, no socket is
+// opened. Enough surface for setupWebServer() to run unchanged.
+// ============================================================
+
+#include <Arduino.h>
+#include <FS.h>
+
+typedef enum {
+    HTTP_GET     = 0b00000001,
+    HTTP_POST    = 0b00000010,
+    HTTP_DELETE  = 0b00000100,
+    HTTP_PUT     = 0b00001000,
+    HTTP_PATCH   = 0b00010000,
+    HTTP_HEAD    = 0b00100000,
+    HTTP_OPTIONS = 0b01000000,
+    HTTP_ANY     = 0b01111111,
+} WebRequestMethod;
+typedef uint8_t WebRequestMethodComposite;
+
+class AsyncWebParameter {
+public:
+    explicit AsyncWebParameter(const String& v = String()) : val(v) {}
+    const String& value() const { return val; }
+
+private:
+    String val;
+};
+
+class AsyncWebServerRequest {
+public:
+    void send(int, const char* = "", const char* = "") {}
+    void send(int, const char*, const String&) {}
+    void send(int, const String&, const String&) {}
+    void send(fs::FS&, const String&, const char* = "", bool = false) {}
+    bool hasParam(const char*, bool = false, bool = false) const { return false; }
+    AsyncWebParameter* getParam(const char*, bool = false, bool = false) { return &param; }
+    String pathArg(size_t) const { return String(); }
+    String url() const { return String(); }
+    WebRequestMethodComposite method() const { return HTTP_GET; }
+
+private:
+    AsyncWebParameter param;
+};
+
+typedef std::function<void(AsyncWebServerRequest*)> ArRequestHandlerFunction;
+typedef std::function<void(AsyncWebServerRequest*, const String&, size_t, uint8_t*, size_t, bool)> ArUploadHandlerFunction;
+typedef std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> ArBodyHandlerFunction;
+
+class AsyncWebHandler {
+public:
+    virtual ~AsyncWebHandler() {}
+};
+
+class AsyncWebServer {
+public:
+    explicit AsyncWebServer(uint16_t) {}
+    void on(const char*, WebRequestMethodComposite, ArRequestHandlerFunction) {}
+    void on(const char*, WebRequestMethodComposite, ArRequestHandlerFunction, ArUploadHandlerFunction) {}
+    void on(const char*, WebRequestMethodComposite, ArRequestHandlerFunction, ArUploadHandlerFunction,
+            ArBodyHandlerFunction) {}
+    void on(const char* uri, ArRequestHandlerFunction fn) { on(uri, HTTP_ANY, fn); }
+    AsyncWebHandler& addHandler(AsyncWebHandler* handler) { return *handler; }
+    void onNotFound(ArRequestHandlerFunction) {}
+    void begin() {}
+};
+
+class DefaultHeaders {
+public:
+    static DefaultHeaders& Instance() {
+        static DefaultHeaders instance;
+        return instance;
+    }
+    void addHeader(const char*, const char*) {}
+};
+
+#endif // SIM_ESP_ASYNC_WEBSERVER_H
@@ -0,0 +1,13 @@
+#ifndef SIM_ESPMDNS_H
+#define SIM_ESPMDNS_H
+
+#include <Arduino.h>
+
+class MDNSResponder {
+public:
+    bool begin(const char*) { return true; }
+    void addService(const char*, const char*, uint16_t) {}
+};
+extern MDNSResponder MDNS;
+
+#endif // SIM_ESPMDNS_H
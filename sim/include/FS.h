@@ -0,0 +1,88 @@
+#ifndef SIM_FS_H
+#define SIM_FS_H
+
+// ============================================================
+// Host shim: Arduino FS mapped onto a directory of the host
+// filesystem, so settings, apps and icons persist between runs.
+// ============================================================
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <dirent.h>
+#include <memory>
+
+namespace fs {
+
+class File : public Stream {
+public:
+    File() {}
+    File(FILE* f, const String& hostPath, const String& fsPath);
+    File(DIR* d, const String& hostPath, const String& fsPath);
+
+    operator bool() const { return handle && (handle->fp || handle->dir); }
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+
+    int available() override;
+    int read() override;
+    int peek() override;
+    size_t read(uint8_t* buffer, size_t size);
+    void flush() override;
+    bool seek(uint32_t pos);
+    size_t position() const;
+    size_t size() const;
+    void close();
+
+    const char* name() const;
+    const char* path() const { return fsPath.c_str(); }
+    bool isDirectory() const { return handle && handle->dir; }
+    File openNextFile(const char* mode = "r");
+
+private:
+    // Copies share the host handle, like the Arduino File wrapper
+    struct Handle {
+        FILE* fp;
+        DIR* dir;
+        Handle(FILE* f, DIR* d) : fp(f), dir(d) {}
+        ~Handle();
+    };
+
+    std::shared_ptr<Handle> handle;
+    String hostPath;
+    String fsPath;
+};
+
+class FS {
+public:
+    explicit FS(const char* defaultRoot) : defaultRoot(defaultRoot) {}
+    virtual ~FS() {}
+
+    File open(const char* path, const char* mode = "r", bool create = false);
+    File open(const String& path, const char* mode = "r", bool create = false) {
+        return open(path.c_str(), mode, create);
+    }
+    bool exists(const char* path);
+    bool exists(const String& path) { return exists(path.c_str()); }
+    bool remove(const char* path);
+    bool remove(const String& path) { return remove(path.c_str()); }
+    bool rename(const char* from, const char* to);
+    bool rename(const String& from, const String& to) { return rename(from.c_str(), to.c_str()); }
+    bool mkdir(const char* path);
+    bool mkdir(const String& path) { return mkdir(path.c_str()); }
+    bool rmdir(const char* path);
+
+    // Host directory backing "/" (PIXELCAST_SIM_FS or the default root)
+    String hostPath(const char* path) const;
+
+protected:
+    const char* defaultRoot;
+};
+
+} // namespace fs
+
+using fs::FS;
+using fs::File;
+
+#endif // SIM_FS_H
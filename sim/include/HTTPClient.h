@@ -0,0 +1,29 @@
+#ifndef SIM_HTTP_CLIENT_H
+#define SIM_HTTP_CLIENT_H
+
+// ============================================================
+// Host shim: no network, every request fails at begin()
+// ============================================================
+
+#include "WiFi.h"
+
+#define HTTP_CODE_OK 200
+#define HTTPC_ERROR_CONNECTION_REFUSED (-1)
+
+class HTTPClient {
+public:
+    bool begin(WiFiClient&, const String&) { return false; }
+    bool begin(const String&) { return false; }
+    int GET() { return HTTPC_ERROR_CONNECTION_REFUSED; }
+    void end() {}
+    int getSize() { return -1; }
+    WiFiClient* getStreamPtr() { return &client; }
+    bool connected() { return false; }
+    void setTimeout(uint16_t) {}
+    void setConnectTimeout(int32_t) {}
+
+private:
+    WiFiClient client;
+};
+
+#endif // SIM_HTTP_CLIENT_H
@@ -0,0 +1,22 @@
+#ifndef SIM_LITTLEFS_H
+#define SIM_LITTLEFS_H
+
+#include "FS.h"
+
+namespace fs {
+
+class LittleFSFS : public FS {
+public:
+    LittleFSFS() : FS("sim_fs") {}
+    bool begin(bool formatOnFail = false, const char* basePath = "/littlefs",
+               uint8_t maxOpenFiles = 10, const char* partitionLabel = "spiffs");
+    void end() {}
+    size_t totalBytes() { return 1024 * 1024; }
+    size_t usedBytes();
+};
+
+} // namespace fs
+
+extern fs::LittleFSFS LittleFS;
+
+#endif // SIM_LITTLEFS_H
@@ -0,0 +1,78 @@
+#ifndef SIM_PRINT_H
+#define SIM_PRINT_H
+
+// ============================================================
+// Host shim: Arduino Print / Printable
+// Faithful enough for Adafruit GFX text (print -> write per byte)
+// ============================================================
+
+#include <stdarg.h>
+#include <stdio.h>
+#include "WString.h"
+
+#define DEC 10
+#define HEX 16
+
+class Print;
+
+class Printable {
+public:
+    virtual ~Printable() {}
+    virtual size_t printTo(Print& p) const = 0;
+};
+
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size) {
+        size_t n = 0;
+        while (size--) n += write(*buffer++);
+        return n;
+    }
+    size_t write(const char* str) { return str ? write((const uint8_t*)str, strlen(str)) : 0; }
+    size_t write(const char* buffer, size_t size) { return write((const uint8_t*)buffer, size); }
+
+    size_t print(const char* str) { return write(str); }
+    size_t print(const String& str) { return write(str.c_str(), str.length()); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(unsigned char v, int base = DEC) { return print((unsigned long)v, base); }
+    size_t print(int v, int base = DEC) { return print((long)v, base); }
+    size_t print(unsigned int v, int base = DEC) { return print((unsigned long)v, base); }
+    size_t print(long v, int base = DEC) {
+        char buf[24];
+        if (base == HEX) {
+            snprintf(buf, sizeof(buf), "%lx", (unsigned long)v);
+        } else {
+            snprintf(buf, sizeof(buf), "%ld", v);
+        }
+        return write(buf);
+    }
+    size_t print(unsigned long v, int base = DEC) {
+        char buf[24];
+        snprintf(buf, sizeof(buf), base == HEX ? "%lx" : "%lu", v);
+        return write(buf);
+    }
+    size_t print(double v, int digits = 2) {
+        char buf[48];
+        snprintf(buf, sizeof(buf), "%.*f", digits, v);
+        return write(buf);
+    }
+    size_t print(const Printable& p) { return p.printTo(*this); }
+
+    size_t println() { return write("\r\n"); }
+    template <typename T> size_t println(const T& v) { size_t n = print(v); return n + println(); }
+    template <typename T> size_t println(const T& v, int fmt) { size_t n = print(v, fmt); return n + println(); }
+
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+        char buf[512];
+        va_list args;
+        va_start(args, format);
+        int len = vsnprintf(buf, sizeof(buf), format, args);
+        va_end(args);
+        if (len < 0) return 0;
+        return write((const uint8_t*)buf, (size_t)len < sizeof(buf) ? len : sizeof(buf) - 1);
+    }
+};
+
+#endif // SIM_PRINT_H
@@ -0,0 +1,36 @@
+#ifndef SIM_PUBSUBCLIENT_H
+#define SIM_PUBSUBCLIENT_H
+
+// ============================================================
+// Host shim: MQTT client that never connects. The simulator
+// feeds messages straight into mqttCallback() instead.
+// ============================================================
+
+#include "WiFi.h"
+
+#define MQTT_CONNECTION_REFUSED (-2)
+
+class PubSubClient {
+public:
+    explicit PubSubClient(WiFiClient&) {}
+    PubSubClient& setServer(const char*, uint16_t) { return *this; }
+    PubSubClient& setCallback(std::function<void(char*, uint8_t*, unsigned int)>) { return *this; }
+    bool setBufferSize(uint16_t) { return true; }
+    PubSubClient& setKeepAlive(uint16_t) { return *this; }
+    PubSubClient& setSocketTimeout(uint16_t) { return *this; }
+    bool connect(const char*) { return false; }
+    bool connect(const char*, const char*, uint8_t, bool, const char*) { return false; }
+    bool connect(const char*, const char*, const char*, const char*, uint8_t, bool, const char*) { return false; }
+    bool publish(const char*, const char*) { return false; }
+    bool publish(const char*, const char*, bool) { return false; }
+    bool beginPublish(const char*, unsigned int, bool) { return false; }
+    size_t write(const uint8_t*, size_t) { return 0; }
+    int endPublish() { return 0; }
+    bool subscribe(const char*) { return false; }
+    bool connected() { return false; }
+    bool loop() { return false; }
+    int state() { return MQTT_CONNECTION_REFUSED; }
+    void disconnect() {}
+};
+
+#endif // SIM_PUBSUBCLIENT_H
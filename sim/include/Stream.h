@@ -0,0 +1,32 @@
+#ifndef SIM_STREAM_H
+#define SIM_STREAM_H
+
+// ============================================================
+// Host shim: Arduino Stream (non-blocking, no timeouts)
+// ============================================================
+
+#include "Print.h"
+
+class Stream : public Print {
+public:
+    virtual int available() { return 0; }
+    virtual int read() { return -1; }
+    virtual int peek() { return -1; }
+    virtual void flush() {}
+    size_t write(uint8_t) override { return 0; }
+    using Print::write;
+
+    size_t readBytes(char* buffer, size_t length) {
+        size_t count = 0;
+        while (count < length) {
+            int c = read();
+            if (c < 0) break;
+            buffer[count++] = (char)c;
+        }
+        return count;
+    }
+    size_t readBytes(uint8_t* buffer, size_t length) { return readBytes((char*)buffer, length); }
+    void setTimeout(unsigned long) {}
+};
+
+#endif // SIM_STREAM_H
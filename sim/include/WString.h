@@ -0,0 +1,111 @@
+#ifndef SIM_WSTRING_H
+#define SIM_WSTRING_H
+
+// ============================================================
+// Host shim: Arduino String on top of std::string
+// ============================================================
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <string>
+
+class __FlashStringHelper;
+
+class String {
+public:
+    String() {}
+    String(const char* str) : s(str ? str : "") {}
+    String(const char* str, unsigned int len) : s(str ? std::string(str, len) : std::string()) {}
+    String(const std::string& str) : s(str) {}
+    explicit String(char c) : s(1, c) {}
+    explicit String(unsigned char v) : s(std::to_string(v)) {}
+    explicit String(int v) : s(std::to_string(v)) {}
+    explicit String(unsigned int v) : s(std::to_string(v)) {}
+    explicit String(long v) : s(std::to_string(v)) {}
+    explicit String(unsigned long v) : s(std::to_string(v)) {}
+    explicit String(long long v) : s(std::to_string(v)) {}
+    explicit String(unsigned long long v) : s(std::to_string(v)) {}
+    explicit String(float v, unsigned int decimals = 2) { format(v, decimals); }
+    explicit String(double v, unsigned int decimals = 2) { format(v, decimals); }
+
+    const char* c_str() const { return s.c_str(); }
+    unsigned int length() const { return s.size(); }
+    bool isEmpty() const { return s.empty(); }
+    void reserve(unsigned int size) { s.reserve(size); }
+
+    bool concat(const char* str) { if (str) s += str; return true; }
+    bool concat(const char* str, unsigned int len) { if (str) s.append(str, len); return true; }
+    bool concat(const String& str) { s += str.s; return true; }
+    bool concat(char c) { s += c; return true; }
+
+    String& operator+=(const String& str) { s += str.s; return *this; }
+    String& operator+=(const char* str) { if (str) s += str; return *this; }
+    String& operator+=(char c) { s += c; return *this; }
+
+    char charAt(unsigned int index) const { return index < s.size() ? s[index] : 0; }
+    char operator[](unsigned int index) const { return charAt(index); }
+
+    int indexOf(char c, unsigned int from = 0) const { return pos(s.find(c, from)); }
+    int indexOf(const String& str, unsigned int from = 0) const { return pos(s.find(str.s, from)); }
+    int lastIndexOf(char c) const { return pos(s.rfind(c)); }
+    int lastIndexOf(const String& str) const { return pos(s.rfind(str.s)); }
+
+    String substring(unsigned int from) const {
+        return from < s.size() ? String(s.substr(from)) : String();
+    }
+    String substring(unsigned int from, unsigned int to) const {
+        if (from > to) { unsigned int tmp = from; from = to; to = tmp; }
+        if (from >= s.size()) return String();
+        return String(s.substr(from, to - from));
+    }
+
+    bool startsWith(const String& prefix) const { return s.compare(0, prefix.s.size(), prefix.s) == 0; }
+    bool endsWith(const String& suffix) const {
+        return s.size() >= suffix.s.size() &&
+               s.compare(s.size() - suffix.s.size(), suffix.s.size(), suffix.s) == 0;
+    }
+    bool equals(const String& other) const { return s == other.s; }
+
+    void trim() {
+        size_t first = s.find_first_not_of(" \t\r\n");
+        if (first == std::string::npos) { s.clear(); return; }
+        size_t last = s.find_last_not_of(" \t\r\n");
+        s = s.substr(first, last - first + 1);
+    }
+    void toLowerCase() { for (size_t i = 0; i < s.size(); i++) s[i] = tolower(s[i]); }
+    void toUpperCase() { for (size_t i = 0; i < s.size(); i++) s[i] = toupper(s[i]); }
+    long toInt() const { return atol(s.c_str()); }
+    float toFloat() const { return atof(s.c_str()); }
+
+    bool operator==(const String& other) const { return s == other.s; }
+    bool operator==(const char* other) const { return other && s == other; }
+    bool operator!=(const String& other) const { return s != other.s; }
+    bool operator!=(const char* other) const { return !(*this == other); }
+    bool operator<(const String& other) const { return s < other.s; }
+
+    friend String operator+(const String& a, const String& b) { return String(a.s + b.s); }
+    friend String operator+(const String& a, const char* b) { return String(a.s + (b ? b : "")); }
+    friend String operator+(const char* a, const String& b) { return String(std::string(a ? a : "") + b.s); }
+    friend String operator+(const String& a, char b) { return String(a.s + b); }
+
+private:
+    std::string s;
+
+    static int pos(size_t p) { return p == std::string::npos ? -1 : (int)p; }
+    void format(double v, unsigned int decimals) {
+        char buf[48];
+        snprintf(buf, sizeof(buf), "%.*f", (int)decimals, v);
+        s = buf;
+    }
+};
+
+// Named by libraries that special-case the result of operator+
+class StringSumHelper : public String {
+public:
+    StringSumHelper(const String& s) : String(s) {}
+    StringSumHelper(const char* p) : String(p) {}
+};
+
+#endif // SIM_WSTRING_H
@@ -0,0 +1,35 @@
+#ifndef SIM_WIFI_H
+#define SIM_WIFI_H
+
+// ============================================================
+// Host shim: WiFi always reports connected, sockets never open
+// ============================================================
+
+#include <Arduino.h>
+
+#define WL_CONNECTED 3
+#define WL_DISCONNECTED 6
+
+class WiFiClient : public Stream {
+public:
+    virtual ~WiFiClient() {}
+    int connect(const char*, uint16_t) { return 0; }
+    bool connected() { return false; }
+    void stop() {}
+    size_t write(uint8_t) override { return 0; }
+    size_t write(const uint8_t*, size_t) override { return 0; }
+    using Print::write;
+};
+
+class WiFiClass {
+public:
+    int status() { return WL_CONNECTED; }
+    bool reconnect() { return true; }
+    IPAddress localIP() { return IPAddress(127, 0, 0, 1); }
+    String SSID() { return String("simulator"); }
+    int RSSI() { return -50; }
+    String macAddress() { return String("AA:BB:CC:DD:EE:FF"); }
+};
+extern WiFiClass WiFi;
+
+#endif // SIM_WIFI_H
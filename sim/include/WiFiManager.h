@@ -0,0 +1,14 @@
+#ifndef SIM_WIFI_MANAGER_H
+#define SIM_WIFI_MANAGER_H
+
+#include "WiFi.h"
+
+class WiFiManager {
+public:
+    void setConfigPortalTimeout(unsigned long) {}
+    void setAPCallback(std::function<void(WiFiManager*)>) {}
+    bool autoConnect(const char*) { return true; }
+    bool autoConnect(const char*, const char*) { return true; }
+};
+
+#endif // SIM_WIFI_MANAGER_H
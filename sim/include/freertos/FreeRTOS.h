@@ -0,0 +1,29 @@
+#ifndef SIM_FREERTOS_H
+#define SIM_FREERTOS_H
+
+// ============================================================
+// Host shim: FreeRTOS types. The simulator is single threaded,
+// so tasks fail to start (callers fall back to running inline)
+// and mutexes always succeed.
+// ============================================================
+
+#include <stdint.h>
+
+typedef void* TaskHandle_t;
+typedef void* SemaphoreHandle_t;
+typedef void* QueueHandle_t;
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+
+#define pdTRUE  1
+#define pdFALSE 0
+#define pdPASS  1
+#define pdFAIL  0
+#define portMAX_DELAY 0xFFFFFFFFUL
+#define portTICK_PERIOD_MS 1
+#define configTICK_RATE_HZ 1000
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define tskNO_AFFINITY 0x7FFFFFFF
+
+#endif // SIM_FREERTOS_H
@@ -0,0 +1,21 @@
+#ifndef SIM_FREERTOS_SEMPHR_H
+#define SIM_FREERTOS_SEMPHR_H
+
+#include "FreeRTOS.h"
+
+inline SemaphoreHandle_t simSemaphoreHandle() {
+    static int token;
+    return &token;
+}
+
+inline SemaphoreHandle_t xSemaphoreCreateMutex() { return simSemaphoreHandle(); }
+inline SemaphoreHandle_t xSemaphoreCreateRecursiveMutex() { return simSemaphoreHandle(); }
+inline SemaphoreHandle_t xSemaphoreCreateBinary() { return simSemaphoreHandle(); }
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t, TickType_t) { return pdTRUE; }
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t) { return pdTRUE; }
+inline BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t, TickType_t) { return pdTRUE; }
+inline BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t) { return pdTRUE; }
+// Locks are never contended on the host, nothing holds them
+inline TaskHandle_t xSemaphoreGetMutexHolder(SemaphoreHandle_t) { return nullptr; }
+
+#endif // SIM_FREERTOS_SEMPHR_H
@@ -0,0 +1,40 @@
+#ifndef SIM_FREERTOS_TASK_H
+#define SIM_FREERTOS_TASK_H
+
+#include "FreeRTOS.h"
+
+typedef void (*TaskFunction_t)(void*);
+
+inline BaseType_t xTaskCreatePinnedToCore(TaskFunction_t, const char*, uint32_t, void*,
+                                          UBaseType_t, TaskHandle_t* handle, BaseType_t) {
+    if (handle) *handle = nullptr;
+    return pdFAIL;
+}
+
+inline BaseType_t xTaskCreate(TaskFunction_t fn, const char* name, uint32_t stack, void* arg,
+                              UBaseType_t prio, TaskHandle_t* handle) {
+    return xTaskCreatePinnedToCore(fn, name, stack, arg, prio, handle, tskNO_AFFINITY);
+}
+
+unsigned long millis();
+void delay(unsigned long ms);
+
+inline TickType_t xTaskGetTickCount() { return (TickType_t)millis(); }
+inline void vTaskDelay(TickType_t ticks) { delay(ticks); }
+inline void vTaskDelayUntil(TickType_t* previous, TickType_t period) {
+    TickType_t now = xTaskGetTickCount();
+    *previous += period;
+    if ((int32_t)(*previous - now) > 0) delay(*previous - now);
+}
+inline void vTaskDelete(TaskHandle_t) {}
+inline BaseType_t xTaskNotifyGive(TaskHandle_t) { return pdPASS; }
+inline uint32_t ulTaskNotifyTake(BaseType_t, TickType_t) { return 0; }
+inline BaseType_t xPortGetCoreID() { return 0; }
+
+// The host runs everything on one thread, seen as a single task
+inline TaskHandle_t xTaskGetCurrentTaskHandle() {
+    static int token;
+    return &token;
+}
+
+#endif // SIM_FREERTOS_TASK_H
@@ -0,0 +1,18 @@
+# PlatformIO extra script for the native simulator environment.
+#
+# Adafruit GFX ships display drivers (SPITFT, GrayOLED) that need SPI/Wire
+# and Adafruit BusIO; the simulator only uses the core GFX and canvases, so
+# those sources are dropped from the library build.
+
+Import("env")
+
+SKIPPED_SOURCES = ("Adafruit_SPITFT.cpp", "Adafruit_GrayOLED.cpp")
+
+
+def skip_display_drivers(env, node):
+    if node.name in SKIPPED_SOURCES:
+        return None
+    return node
+
+
+env.AddBuildMiddleware(skip_display_drivers)
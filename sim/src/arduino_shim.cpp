@@ -0,0 +1,240 @@
+// ============================================================
+// Host implementations behind the sim/include shims
+// ============================================================
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <ESPmDNS.h>
+#include <ArduinoOTA.h>
+#include <LittleFS.h>
+
+#include <chrono>
+#include <errno.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+HardwareSerial Serial;
+EspClass ESP;
+WiFiClass WiFi;
+MDNSResponder MDNS;
+ArduinoOTAClass ArduinoOTA;
+fs::LittleFSFS LittleFS;
+
+// ============================================================================
+// Virtual Clock
+// ============================================================================
+
+static uint64_t simClockUs = 0;
+
+unsigned long millis() {
+    return (unsigned long)(simClockUs / 1000);
+}
+
+unsigned long micros() {
+    return (unsigned long)simClockUs;
+}
+
+void delay(unsigned long ms) {
+    simAdvanceMs(ms);
+}
+
+void simAdvanceMs(unsigned long ms) {
+    simClockUs += (uint64_t)ms * 1000;
+}
+
+// Real elapsed time at the advertised CPU clock, so ScopedTiming and the
+// render stats report host durations in microseconds
+uint32_t EspClass::getCycleCount() {
+    using namespace std::chrono;
+    static const steady_clock::time_point origin = steady_clock::now();
+    uint64_t ns = duration_cast<nanoseconds>(steady_clock::now() - origin).count();
+    return (uint32_t)(ns * getCpuFreqMHz() / 1000);
+}
+
+// ============================================================================
+// Filesystem
+// ============================================================================
+
+namespace fs {
+
+File::Handle::~Handle() {
+    if (fp) fclose(fp);
+    if (dir) closedir(dir);
+}
+
+File::File(FILE* f, const String& host, const String& path)
+    : handle(std::make_shared<Handle>(f, nullptr)), hostPath(host), fsPath(path) {}
+
+File::File(DIR* d, const String& host, const String& path)
+    : handle(std::make_shared<Handle>(nullptr, d)), hostPath(host), fsPath(path) {}
+
+size_t File::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+size_t File::write(const uint8_t* buffer, size_t size) {
+    if (!handle || !handle->fp) return 0;
+    return fwrite(buffer, 1, size, handle->fp);
+}
+
+int File::available() {
+    if (!handle || !handle->fp) return 0;
+    return (int)(size() - position());
+}
+
+int File::read() {
+    if (!handle || !handle->fp) return -1;
+    int c = fgetc(handle->fp);
+    return c == EOF ? -1 : c;
+}
+
+int File::peek() {
+    if (!handle || !handle->fp) return -1;
+    int c = fgetc(handle->fp);
+    if (c == EOF) return -1;
+    ungetc(c, handle->fp);
+    return c;
+}
+
+size_t File::read(uint8_t* buffer, size_t size) {
+    if (!handle || !handle->fp) return 0;
+    return fread(buffer, 1, size, handle->fp);
+}
+
+void File::flush() {
+    if (handle && handle->fp) fflush(handle->fp);
+}
+
+bool File::seek(uint32_t pos) {
+    if (!handle || !handle->fp) return false;
+    return fseek(handle->fp, pos, SEEK_SET) == 0;
+}
+
+size_t File::position() const {
+    if (!handle || !handle->fp) return 0;
+    long pos = ftell(handle->fp);
+    return pos < 0 ? 0 : (size_t)pos;
+}
+
+size_t File::size() const {
+    if (!handle || !handle->fp) return 0;
+    struct stat st;
+    fflush(handle->fp);
+    if (fstat(fileno(handle->fp), &st) != 0) return 0;
+    return st.st_size;
+}
+
+void File::close() {
+    handle.reset();
+}
+
+const char* File::name() const {
+    int slash = fsPath.lastIndexOf('/');
+    return fsPath.c_str() + (slash >= 0 ? slash + 1 : 0);
+}
+
+File File::openNextFile(const char* mode) {
+    if (!handle || !handle->dir) return File();
+
+    struct dirent* entry;
+    while ((entry = readdir(handle->dir)) != nullptr) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) continue;
+
+        String childHost = hostPath + "/" + entry->d_name;
+        String childPath = fsPath + (fsPath.endsWith("/") ? "" : "/") + entry->d_name;
+        struct stat st;
+        if (stat(childHost.c_str(), &st) != 0) continue;
+        if (S_ISDIR(st.st_mode)) {
+            DIR* d = opendir(childHost.c_str());
+            if (d) return File(d, childHost, childPath);
+        } else {
+            FILE* f = fopen(childHost.c_str(), strcmp(mode, "r") == 0 ? "rb" : mode);
+            if (f) return File(f, childHost, childPath);
+        }
+    }
+    return File();
+}
+
+String FS::hostPath(const char* path) const {
+    const char* root = getenv("PIXELCAST_SIM_FS");
+    String host = root && *root ? root : defaultRoot;
+    if (path && *path) {
+        if (*path != '/') host += "/";
+        host += path;
+    }
+    while (host.length() > 1 && host.endsWith("/")) host = host.substring(0, host.length() - 1);
+    return host;
+}
+
+File FS::open(const char* path, const char* mode, bool create) {
+    String host = hostPath(path);
+    struct stat st;
+    bool exists = stat(host.c_str(), &st) == 0;
+
+    if (exists && S_ISDIR(st.st_mode)) {
+        DIR* d = opendir(host.c_str());
+        return d ? File(d, host, path) : File();
+    }
+
+    const char* hostMode = "rb";
+    if (strcmp(mode, "w") == 0) hostMode = "wb";
+    else if (strcmp(mode, "a") == 0) hostMode = "ab";
+    else if (strcmp(mode, "r+") == 0) hostMode = "r+b";
+    else if (strcmp(mode, "w+") == 0) hostMode = "w+b";
+    else if (strcmp(mode, "a+") == 0) hostMode = "a+b";
+
+    if (!exists && hostMode[0] == 'r' && !create) return File();
+
+    FILE* f = fopen(host.c_str(), hostMode);
+    return f ? File(f, host, path) : File();
+}
+
+bool FS::exists(const char* path) {
+    struct stat st;
+    return stat(hostPath(path).c_str(), &st) == 0;
+}
+
+bool FS::remove(const char* path) {
+    return unlink(hostPath(path).c_str()) == 0;
+}
+
+bool FS::rename(const char* from, const char* to) {
+    return ::rename(hostPath(from).c_str(), hostPath(to).c_str()) == 0;
+}
+
+bool FS::mkdir(const char* path) {
+    return ::mkdir(hostPath(path).c_str(), 0755) == 0 || errno == EEXIST;
+}
+
+bool FS::rmdir(const char* path) {
+    return ::rmdir(hostPath(path).c_str()) == 0;
+}
+
+bool LittleFSFS::begin(bool formatOnFail, const char*, uint8_t, const char*) {
+    String root = hostPath("");
+    struct stat st;
+    if (stat(root.c_str(), &st) == 0) return S_ISDIR(st.st_mode);
+    return formatOnFail && ::mkdir(root.c_str(), 0755) == 0;
+}
+
+static size_t usedBytesIn(const String& dirPath) {
+    size_t total = 0;
+    DIR* d = opendir(dirPath.c_str());
+    if (!d) return 0;
+    struct dirent* entry;
+    while ((entry = readdir(d)) != nullptr) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) continue;
+        String child = dirPath + "/" + entry->d_name;
+        struct stat st;
+        if (stat(child.c_str(), &st) != 0) continue;
+        total += S_ISDIR(st.st_mode) ? usedBytesIn(child) : (size_t)st.st_size;
+    }
+    closedir(d);
+    return total;
+}
+
+size_t LittleFSFS::usedBytes() {
+    return usedBytesIn(hostPath(""));
+}
+
+} // namespace fs
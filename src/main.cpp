@@ -11,7 +11,16 @@
 
 #include <Arduino.h>
 #include "config.h"
+#include "panel_color.h"
 #include "weather_icons.h"
+#include "text_strip.h"
+#include "text_metrics.h"
+#include "icon_spans.h"
+#include "icon_arena.h"
+#include "name_index.h"
+#include "render_timing.h"
+#include "command_queue.h"
+#include "snapshot_buffers.h"
 
 // Display
 #include <ESP32-HUB75-MatrixPanel-I2S-DMA.h>
@@ -38,11 +47,16 @@
 // PNG decoding
 #include <PNGdec.h>
 
+// GIF decoding
+#include <AnimatedGIF.h>
+#include <new>
+
 // Compact font for small text (IP address, status)
 #include <Fonts/TomThumb.h>
 
 // NTP
 #include <time.h>
+#include <sys/time.h>
 
 // HTTPS for LaMetric icon download
 #include <WiFiClientSecure.h>
@@ -58,9 +72,19 @@
 #define MAX_ZONES 4
 #define MAX_TEXT_SEGMENTS 8
 
+// Layout an app renders with, resolved from its ID by appCompile()
+enum AppKind : uint8_t {
+    APP_KIND_CUSTOM,
+    APP_KIND_CLOCK,
+    APP_KIND_DATE,
+    APP_KIND_WEATHERCLOCK,
+    APP_KIND_TRACKER
+};
+
 struct TextSegment {
-    uint8_t offset;   // Visual char index where this color starts
-    uint32_t color;   // 0xRRGGBB
+    uint8_t offset;       // Visual char index where this color starts
+    uint16_t colorPanel;  // color packed for the panel
+    uint32_t color;       // 0xRRGGBB
 };
 
 struct AppZone {
@@ -68,22 +92,29 @@ struct AppZone {
     char icon[32];
     char label[32];
     uint32_t textColor;
+    uint16_t textColorPanel;    // textColor packed for the panel
     TextSegment textSegments[MAX_TEXT_SEGMENTS];
     uint8_t textSegmentCount;
     TextSegment labelSegments[MAX_TEXT_SEGMENTS];
     uint8_t labelSegmentCount;
+    int16_t textWidth;          // Cached by appCompile(), default font
+    int16_t labelWidth;         // Cached by appCompile(), TomThumb
+    uint32_t iconHash;          // nameHash(icon), cached by appCompile()
 };
 
 struct AppItem {
     char id[24];
     char text[64];
     char icon[32];
+    char gif[32];               // Animation name, replaces the layout when set
     char label[32];
     uint32_t textColor;
+    uint16_t textColorPanel;    // textColor packed for the panel
     uint16_t duration;          // Display duration in ms
     uint32_t lifetime;          // Expiration time (0 = permanent)
     uint32_t createdAt;         // Creation timestamp
     int8_t priority;            // -10 to 10 (higher = more important)
+    uint8_t transition;         // TransitionType, or TRANSITION_GLOBAL
     uint8_t zoneCount;          // 0 or 1 = single layout, 2/3/4 = multi-zone
     bool active;
     bool isSystem;              // System apps cannot be deleted
@@ -91,6 +122,13 @@ struct AppItem {
     uint8_t textSegmentCount;
     TextSegment labelSegments[MAX_TEXT_SEGMENTS];
     uint8_t labelSegmentCount;
+    // Render plan, rebuilt by appCompile() whenever the fields above change
+    uint8_t kind;               // AppKind
+    int16_t textWidth;          // Default font
+    int16_t labelWidth;         // TomThumb
+    uint32_t iconHash;          // nameHash(icon)
+    uint32_t textSignature;     // Text strip content (text, color, segments)
+    uint32_t signature;         // Everything the single-zone layout draws
     AppZone zones[3];           // zones 1-3 (zone 0 = main text/icon/textColor)
 };
 
@@ -101,6 +139,13 @@ struct AppItem {
 // Display
 MatrixPanel_I2S_DMA *dma_display = nullptr;
 
+// Off-screen RGB565 frame, pushed to the DMA buffer by displayFlush().
+// One shadow copy per DMA buffer remembers what that buffer already shows.
+#define FRAME_SHADOW_COUNT (DOUBLE_BUFFER ? 2 : 1)
+GFXcanvas16 *canvas = nullptr;
+uint16_t* frameShadow[FRAME_SHADOW_COUNT] = { nullptr };
+uint8_t frameShadowIndex = 0;  // Shadow of the buffer currently being written
+
 // Network
 WiFiClient wifiClient;
 WiFiManager wifiManager;
@@ -113,7 +158,7 @@ PubSubClient mqttClient(wifiClient);
 
 // State
 bool wifiConnected = false;
-bool mqttConnected = false;
+std::atomic<bool> mqttConnected(false);  // Written by the MQTT task
 bool filesystemReady = false;
 uint8_t currentBrightness = DEFAULT_BRIGHTNESS;
 bool pendingReboot = false;
@@ -138,32 +183,403 @@ struct ScrollState {
 };
 ScrollState appScrollState;
 
+// Text Strip Cache (scrolling text rasterized once, rebuilt on text/color change)
+struct TextStripCache {
+    TextStripCanvas* strip;   // nullptr if the text could not be cached
+    uint32_t signature;
+    bool built;
+};
+TextStripCache appTextStrip = { nullptr, 0, false };
+TextStripCache notifTextStrip = { nullptr, 0, false };
+
+// Glyph advances of the two fonts, filled at boot from the GFX font data
+FontMetrics fontDefault;
+FontMetrics fontTomThumb;
+
+// Damage Tracking
+// Partial-redraw layouts (clock, weather clock, single-zone apps) record the
+// rectangles that changed each frame and only clear/redraw what intersects them.
+// Any layout or content change falls back to a full-screen redraw.
+#define MAX_DIRTY_RECTS 8
+#define DAMAGE_HASH_SEED 2166136261u  // FNV-1a offset basis
+
+struct DirtyRect {
+    int16_t x;
+    int16_t y;
+    int16_t w;
+    int16_t h;
+};
+
+enum DamageLayout : uint8_t {
+    DAMAGE_LAYOUT_NONE = 0,  // Screen owned by a full-redraw function
+    DAMAGE_LAYOUT_CLOCK,
+    DAMAGE_LAYOUT_WEATHER,
+    DAMAGE_LAYOUT_APP,
+    DAMAGE_LAYOUT_GIF
+};
+
+struct DamageState {
+    DirtyRect rects[MAX_DIRTY_RECTS];
+    uint8_t rectCount;
+    bool fullFrame;              // Current frame redraws the whole screen
+    bool indicatorsChanged;      // Indicator config changed since last frame
+    DamageLayout layout;         // Layout currently on screen
+    uint32_t signature;          // Content hash of the layout on screen
+};
+DamageState damage;
+
+struct DisplayFrameStats {
+    uint32_t frames;
+    uint32_t partialFrames;
+    uint32_t lastPixelsTouched;
+    uint64_t totalPixelsTouched;
+    uint32_t lastPixelsPushed;   // Pixels that actually changed in the DMA buffer
+    uint32_t lastSpansPushed;    // Driver writes needed to push them
+};
+DisplayFrameStats displayFrameStats;
+int16_t appLastDrawnTextX = 0;
+uint8_t appLastDrawnIconFrame = 0;
+
+// App transitions: outgoing/incoming apps are rendered into two off-screen
+// frames, then composited into the canvas for TRANSITION_DURATION. The
+// frames only exist while a transition runs.
+struct TransitionState {
+    bool capturing;             // Rendering the incoming app, flushes are held back
+    bool active;
+    TransitionType type;
+    unsigned long startTime;
+    unsigned long nextFrame;
+};
+TransitionState transition;
+GFXcanvas16* transitionFrom = nullptr;
+GFXcanvas16* transitionTo = nullptr;
+
+// GIF playback: a single decoder, allocated while a GIF app is on screen.
+// Frames are streamed from LittleFS and decoded line by line straight into
+// the canvas, so working memory is the decoder state plus one palette
+// whatever the length of the animation.
+struct GifPlayer {
+    AnimatedGIF* decoder;       // nullptr when released
+    bool open;                  // A file is open in the decoder
+    bool failed;                // Open/decode error, app falls back to its text layout
+    uint32_t signature;         // App + animation the decoder was opened for
+    int16_t offsetX;            // GIF canvas position on the display
+    int16_t offsetY;
+    unsigned long nextFrameAt;
+    uint16_t palette[256];      // Current frame palette packed for the panel
+    bool globalPaletteReady;    // palette holds the global color table
+    DirtyRect frameRect;        // Area covered by the last decoded frame
+    uint8_t frameDisposal;
+    uint16_t corners[NUM_INDICATORS][INDICATOR_FOOTPRINT * INDICATOR_FOOTPRINT];  // Animation under the indicators
+    uint32_t frames;            // Frames decoded since boot
+    uint32_t lateFrames;        // Frames that missed their slot, schedule re-anchored
+};
+GifPlayer gifPlayer;
+
+// Render task: frames are produced on RENDER_TASK_CORE at a fixed rate.
+// The network side (loop(), AsyncTCP handlers, MQTT callbacks) must hold
+// the state lock while reading settings, icons or the canvas, and reads
+// apps, notifications and trackers from the published StateSnapshot.
+// Changes are queued as commands (see below) and applied by the frame.
+SemaphoreHandle_t stateMutex = nullptr;
+TaskHandle_t renderTaskHandle = nullptr;
+volatile bool renderSuspended = false;  // OTA owns the display
+
+struct RenderTaskStats {
+    uint32_t frames;
+    uint32_t wakeups;           // Frames started early by a queued command
+    uint32_t jitterUs;          // Wake-up lateness of the last timed frame
+    uint32_t jitterAvgUs;       // Moving average (1/16 weight)
+    uint32_t jitterMaxUs;       // Worst lateness over the last window
+    uint32_t frameUs;           // Render time of the last frame
+    uint32_t frameMaxUs;        // Worst render time over the last window
+    uint32_t overruns;          // Frames that took longer than the period
+    uint32_t ingestUs;          // Command queued to end of the frame that drew it
+    uint32_t ingestAvgUs;       // Moving average (1/16 weight)
+    uint32_t ingestMaxUs;       // Worst over the last window
+    uint32_t frameRate;         // Frames per second over the last window
+    uint32_t busyPermille;      // Share of the last window spent rendering
+    uint32_t windowJitterMaxUs;
+    uint32_t windowFrameMaxUs;
+    uint32_t windowIngestMaxUs;
+    uint32_t windowBusyUs;
+    uint32_t windowFrames;
+    unsigned long windowStart;
+};
+RenderTaskStats renderStats;
+
+// Earliest millis() at which a subsystem has something to draw. Each one
+// offers its deadlines (next scroll step, GIF frame, app expiry...) and the
+// render task sleeps until the earliest, unless a command wakes it first.
+struct FrameDeadline {
+    unsigned long at;
+
+    // A time already past means the next frame
+    void need(unsigned long when) {
+        if ((long)(when - at) < 0) at = when;
+    }
+};
+
+void stateLock();
+void stateUnlock();
+bool stateLockHeld();
+
+// Holds the state lock for the enclosing scope
+struct StateLock {
+    StateLock() { stateLock(); }
+    ~StateLock() { stateUnlock(); }
+};
+
+// Render timing histograms, recorded by the render task under the state lock
+enum RenderTimingId : uint8_t {
+    TIMING_SHOW_APP,
+    TIMING_SHOW_WEATHERCLOCK,
+    TIMING_SHOW_TRACKER,
+    TIMING_SHOW_MULTIZONE,
+    TIMING_SHOW_NOTIFICATION,
+    TIMING_GET_ICON,
+    TIMING_LOAD_ICON,
+    TIMING_GIF_FRAME,
+    TIMING_COUNT
+};
+static const char* const RENDER_TIMING_NAMES[TIMING_COUNT] = {
+    "displayShowApp", "displayShowWeatherClock", "displayShowTracker",
+    "displayShowMultiZone", "displayShowNotification", "getIcon", "loadIcon",
+    "gifPlayFrame"
+};
+TimingHistogram renderTimings[TIMING_COUNT];
+
+#if ENABLE_RENDER_TIMING
+    #define RENDER_TIMED(id) ScopedTiming renderTiming(&renderTimings[id])
+#else
+    #define RENDER_TIMED(id)
+#endif
+
+// Persistence is deferred to loop() so flash writes never run under the lock
+volatile bool settingsSavePending = false;
+volatile bool appsSavePending = false;
+
+// Mutating REST and MQTT requests never wait for the state lock: they are
+// queued as commands and applied at the start of the next frame. One ring
+// per producer task (AsyncTCP, MQTT) keeps each ring single-producer.
+enum CommandType : uint8_t {
+    CMD_BRIGHTNESS,
+    CMD_SETTINGS,
+    CMD_CUSTOM,
+    CMD_CUSTOM_DELETE,
+    CMD_NOTIFY,
+    CMD_DISMISS,
+    CMD_INDICATOR,
+    CMD_INDICATOR_OFF,
+    CMD_WEATHER,
+    CMD_TRACKER,
+    CMD_TRACKER_DELETE,
+    CMD_SLEEP,
+    CMD_SLEEP_UNTIL,
+    CMD_WAKE,
+    CMD_BATCH
+};
+
+struct Command {
+    uint8_t type;                   // CommandType
+    uint8_t index;                  // Indicator index
+    uint8_t large;                  // restLargeBodies index, COMMAND_INLINE for body
+    char name[24];                  // App id, tracker name or notification id
+    uint16_t length;
+    uint32_t queuedUs;              // micros() when queued, for ingest latency
+    char body[COMMAND_BODY_SIZE];   // JSON payload, not terminated
+};
+
+typedef CommandRing<Command, COMMAND_QUEUE_SIZE> CommandQueue;
+CommandQueue restCommands;  // Filled by AsyncTCP handlers
+CommandQueue mqttCommands;  // Filled by mqttCallback() on the MQTT task
+uint32_t commandsApplied = 0;
+uint32_t commandsRejected = 0;  // Queued payloads that failed to parse or validate
+
+// REST payloads larger than a slot (multi-zone apps, long texts, batches)
+// wait in one of these and the queued command only points at it. A buffer
+// is claimed by the AsyncTCP handler and released once the frame parsed it.
+// MQTT payloads always fit a slot, PubSubClient's buffer is the same size.
+#define COMMAND_INLINE 0xFF
+struct CommandLargeBody {
+    std::atomic<bool> busy;
+    uint16_t length;
+    char body[COMMAND_LARGE_SIZE];
+};
+CommandLargeBody restLargeBodies[COMMAND_LARGE_COUNT];
+uint32_t batchesApplied = 0;
+
+// MQTT outbox: messages built by loop(), published by the MQTT task
+struct MqttMessage {
+    char topic[16];               // Relative to the prefix
+    bool retained;
+    uint16_t length;
+    char payload[MQTT_BUFFER_SIZE];
+};
+
+CommandRing<MqttMessage, MQTT_OUTBOX_SIZE> mqttOutbox;
+TaskHandle_t mqttTaskHandle = nullptr;
+
+// Connection settings as the MQTT task uses them. Copied from settings
+// under the state lock when mqttConfigChanged is set, so a settings write
+// never hands the client a half-updated host or prefix.
+struct MqttConfig {
+    bool enabled;
+    char server[64];
+    uint16_t port;
+    char user[32];
+    char password[32];
+    char prefix[32];
+};
+MqttConfig mqttConfig;
+std::atomic<bool> mqttConfigChanged(true);
+
+uint8_t mqttFailures = 0;         // Consecutive failed connects, drives the backoff
+unsigned long mqttRetryAt = 0;    // Earliest next connect attempt
+uint32_t mqttBackoff = 0;         // Last reconnect delay (ms)
+uint32_t mqttConnects = 0;
+uint32_t mqttConnectFailures = 0;
+
 // Icon Cache
+// One frame of a cached icon; still icons have a single frame
+struct IconFrame {
+    uint16_t firstSpan;  // Index of the frame's first run in CachedIcon::spans
+    uint16_t spanCount;
+    uint16_t delay;      // Display time in ms (animated icons)
+};
+
 struct CachedIcon {
     char name[32];
-    uint16_t* pixels;  // RGB565 format
+    uint32_t hash;     // nameHash(name), key of iconIndex
+    uint8_t* data;     // Arena block holding frames, pixels and spans (sidecar body)
+    uint16_t* pixels;  // RGB565 format, frameCount frames back to back
+    IconSpan* spans;   // Opaque runs of all frames, built at load time
+    IconFrame* frames;
+    uint16_t spanCount;
+    uint8_t frameCount;
+    uint8_t frame;     // Frame currently shown, advanced by getIcon()
     uint8_t width;
     uint8_t height;
     bool valid;
+    bool loading;      // Data block reserved, being filled without the state lock
+    uint32_t bytes;    // Size of the data block
+    uint32_t pass;     // Last draw pass that used this icon
+    unsigned long nextFrameAt;
     unsigned long lastUsed;
 };
 CachedIcon iconCache[MAX_ICON_CACHE];
+// Icon data lives in one pool taken at boot (PSRAM when present) and never
+// touches the heap afterwards, eviction is by bytes of this pool
+static uint8_t* iconArenaPool = nullptr;
+IconArena iconArena;
+uint8_t iconLoads = 0;  // Slots loading, the arena is not compacted meanwhile
+
+// Name lookups go through a hash index, misses are remembered for a while
+// so a missing icon does not probe the filesystem on every redraw
+#define ICON_INDEX_SIZE 32
+static_assert(ICON_INDEX_SIZE > MAX_ICON_CACHE && (ICON_INDEX_SIZE & (ICON_INDEX_SIZE - 1)) == 0,
+              "ICON_INDEX_SIZE must be a power of two larger than MAX_ICON_CACHE");
+NameIndex<ICON_INDEX_SIZE> iconIndex;
+
+struct IconMiss {
+    char name[32];
+    uint32_t hash;
+    unsigned long expiresAt;
+};
+IconMiss iconMisses[MAX_ICON_MISSES];
+
+struct IconLookupStats {
+    uint32_t hits;          // Served from the cache
+    uint32_t misses;        // Loaded (or failed to load) from the filesystem
+    uint32_t negativeHits;  // Known missing, filesystem not touched
+};
+IconLookupStats iconLookupStats;
+uint32_t iconPrefetches = 0;  // Icons loaded ahead of their first draw
+char iconPrefetchName[32] = "";  // Picked by the frame, loaded by the icon worker
+uint32_t iconPass = 0;  // Incremented by each top-level redraw
 PNG png;
 
-// Failed icon download blacklist (prevents retry every frame)
-#define MAX_FAILED_ICON_DOWNLOADS 8
-#define FAILED_ICON_RETRY_DELAY 300000  // 5 minutes
+// Pre-decoded icon sidecar (/icons/<name>.pxi), written once per source
+// image so cache misses are a header check and one read:
+// [IconFileHeader][IconFrame x frameCount][RGB565 frames][IconSpan x spanCount]
+// Pixels are packed for the panel, so the sidecar is tied to COLOR_DEPTH.
+#define ICON_FILE_EXT ".pxi"
+#define ICON_FILE_MAGIC 0x31495850u  // "PXI1"
+#define ICON_FILE_VERSION 1
+
+struct IconFileHeader {
+    uint32_t magic;
+    uint8_t version;
+    uint8_t colorDepth;
+    uint8_t width;
+    uint8_t height;
+    uint8_t frameCount;
+    uint8_t reserved;
+    uint16_t spanCount;
+};
+
+// Icons with a source image but no sidecar, decoded by loop(). A name
+// stays queued until it is cached, renders draw the placeholder meanwhile.
+char iconTranscodeQueue[ICON_TRANSCODE_QUEUE][32];
+uint8_t iconTranscodeCount = 0;
+
+// The PNG decoder and its draw target are shared by the tasks that decode
+// icons (loop(), upload handler, download worker); they take turns on this
+// lock instead of the state lock. The render task never decodes.
+SemaphoreHandle_t iconDecodeMutex = nullptr;
+
+// LaMetric icon downloads run on their own task so a slow CDN never stalls
+// rendering; getIcon() draws a placeholder until the icon is imported.
+// Failed names stay in the table and back off before they are retried.
+// The same worker loads the icons picked for prefetch.
+enum IconDownloadState {
+    ICON_DOWNLOAD_FREE = 0,
+    ICON_DOWNLOAD_QUEUED,
+    ICON_DOWNLOAD_ACTIVE,
+    ICON_DOWNLOAD_FAILED
+};
 
-struct FailedIconDownload {
+struct IconDownload {
     char name[32];
-    unsigned long failedAt;
+    uint32_t iconId;
+    uint8_t state;            // IconDownloadState
+    uint8_t failures;         // Consecutive failures, drives the backoff
+    unsigned long queuedAt;
+    unsigned long retryAt;    // Failed: earliest time it is requested again
 };
 
-FailedIconDownload failedIconDownloads[MAX_FAILED_ICON_DOWNLOADS];
+IconDownload iconDownloads[MAX_ICON_DOWNLOADS];
+TaskHandle_t iconDownloadTaskHandle = nullptr;
+uint32_t iconDownloadsDone = 0;
+uint32_t iconDownloadsFailed = 0;
+
+// Drawn while a LaMetric icon is being downloaded
+CachedIcon iconPlaceholder;
+IconFrame iconPlaceholderFrame;
+IconSpan iconPlaceholderSpans[32];
+#define IP_D panelColor(70, 70, 70)
+const uint16_t iconPlaceholderPixels[64] PROGMEM = {
+    IP_D, IP_D, 0,    IP_D, IP_D, 0,    IP_D, IP_D,
+    IP_D, 0,    0,    0,    0,    0,    0,    IP_D,
+    0,    0,    0,    0,    0,    0,    0,    0,
+    IP_D, 0,    0,    0,    0,    0,    0,    IP_D,
+    IP_D, 0,    0,    0,    0,    0,    0,    IP_D,
+    0,    0,    0,    0,    0,    0,    0,    0,
+    IP_D, 0,    0,    0,    0,    0,    0,    IP_D,
+    IP_D, IP_D, 0,    IP_D, IP_D, 0,    IP_D, IP_D,
+};
+#undef IP_D
+
+// Builtin sprites, served by getIcon() ahead of the cache. Pixels stay in
+// the PROGMEM atlas, only the span lists live in RAM.
+CachedIcon iconAtlas[WEATHER_SPRITE_COUNT];
+IconFrame iconAtlasFrames[WEATHER_SPRITE_COUNT];
+IconSpan iconAtlasSpans[WEATHER_ATLAS_SPANS];
 
 // Temporary buffer for PNG decode callback
 uint16_t* pngDecodeTarget = nullptr;
 uint8_t pngDecodeWidth = 0;
+uint8_t pngDecodeHeight = 0;
 
 struct SleepSlot {
     uint8_t startHour;
@@ -197,6 +613,7 @@ struct Settings {
     uint8_t brightness;
     bool autoRotate;
     uint16_t defaultDuration;
+    TransitionType transition;
     char ntpServer[48];
     char tzPosix[64];
     bool clockEnabled;
@@ -250,6 +667,8 @@ struct TrackerData {
     uint8_t sparklineCount;
     uint32_t symbolColor;     // Header color (0xRRGGBB)
     uint32_t sparklineColor;  // Chart color
+    uint16_t symbolColorPanel;     // Packed for the panel
+    uint16_t sparklineColorPanel;
     char bottomText[32];      // Optional footer
     unsigned long lastUpdate;
     bool valid;
@@ -268,6 +687,7 @@ enum IndicatorMode : uint8_t {
 struct IndicatorData {
     IndicatorMode mode;
     uint32_t color;          // 0xRRGGBB
+    uint16_t colorPanel;     // color packed for the panel
     uint16_t blinkInterval;  // ms (default INDICATOR_BLINK_INTERVAL)
     uint16_t fadePeriod;     // ms (default INDICATOR_FADE_PERIOD)
 };
@@ -284,9 +704,13 @@ IndicatorAnimState indicatorAnimState[NUM_INDICATORS];
 struct NotificationItem {
     char id[24];              // Unique ID ("notif_<millis>" or user-provided)
     char text[128];           // Notification text (longer than app's 64 chars)
+    int16_t textWidth;        // Drawn width of text, set with it
+    uint32_t textSignature;   // Text strip content, set with it
     char icon[32];            // Icon filename
     uint32_t textColor;       // RGB color
     uint32_t backgroundColor; // RGB color for area outside card frame (0 = none)
+    uint16_t textColorPanel;  // Packed for the panel
+    uint16_t backgroundColorPanel;
     uint16_t duration;        // Display duration in ms (0 = hold mode)
     bool hold;                // Explicit hold flag (never auto-expires)
     bool urgent;              // Jumps to front of queue
@@ -301,8 +725,43 @@ int8_t savedAppIndex = -1;          // App to restore after notifications end
 ScrollState notifScrollState;
 unsigned long lastNotifScrollUpdate = 0;
 
+// Read-only copy of the app, notification and tracker model for the API
+// and MQTT side. The render frame is the only writer of the model (commands
+// are applied at its start), so it renders from a consistent view; readers
+// pin the published copy instead of taking the state lock. A frame that
+// changed the model fills a copy no reader holds and publishes it; with
+// every usable copy pinned the refresh waits for a later frame. With two
+// copies readers never wait. With one (boards without PSRAM) a reader that
+// arrives during the refresh waits on the state lock the frame holds.
+struct StateSnapshot {
+    uint32_t version;           // stateVersion the copy was taken at
+    AppItem apps[MAX_APPS];
+    uint8_t appCount;
+    int8_t currentAppIndex;
+    bool appRotationEnabled;
+    NotificationItem notifications[MAX_NOTIFICATIONS];
+    uint8_t notificationCount;
+    int8_t currentNotifIndex;
+    TrackerData trackers[MAX_TRACKERS];
+    uint8_t trackerCount;
+};
+SnapshotBuffers<StateSnapshot, STATE_SNAPSHOT_COPIES> stateSnapshots;
+uint32_t stateVersion = 1;        // Bumped by every change to what the snapshot copies
+uint32_t snapshotVersion = 0;     // stateVersion of the published copy
+uint32_t snapshotPublishes = 0;
+uint32_t snapshotDeferrals = 0;   // Refreshes put off because readers held every other copy
+
+uint8_t snapshotPin();
+
+// Holds the published snapshot for the enclosing scope
+struct SnapshotPin {
+    uint8_t index;
+    const StateSnapshot* state;
+    SnapshotPin() : index(snapshotPin()), state(&stateSnapshots.copies[index]) {}
+    ~SnapshotPin() { stateSnapshots.unpin(index); }
+};
+
 // Timing
-unsigned long lastMqttReconnectAttempt = 0;
 unsigned long lastStatsPublish = 0;
 unsigned long lastDisplayUpdate = 0;
 unsigned long lastTimeUpdate = 0;
@@ -447,10 +906,10 @@ const char ICONS_HTML[] PROGMEM = R"rawliteral(
                 });
                 const d = await r.json();
                 if (d.success) {
-                    showMsg('Icon downloaded from LaMetric', false);
+                    showMsg('Download queued, the icon appears once fetched', false);
                     document.getElementById('lmId').value = '';
                     document.getElementById('lmName').value = '';
-                    load();
+                    setTimeout(load, 3000);
                 } else {
                     showMsg(d.error || 'Download failed', true);
                 }
@@ -499,6 +958,17 @@ void loopMQTT();
 void loopDisplay();
 void loopApps();
 void loopSleepTransition();
+void loopPersistence();
+void displayDeadline(FrameDeadline& next);
+void appsDeadline(FrameDeadline& next);
+void sleepDeadline(FrameDeadline& next);
+
+void setupRenderTask();
+void renderTask(void* param);
+void renderWake();
+void renderRecordIngest(uint32_t ingestUs);
+unsigned long renderFrame();
+void snapshotPublish();
 
 void displayShowBoot();
 void displayShowIP();
@@ -507,25 +977,63 @@ void displayShowDate();
 void displayShowApp(AppItem* app);
 void displayShowWeatherClock(uint16_t appDuration = 10000);
 void drawDropIcon(int16_t x, int16_t y, uint16_t color);
+void drawDegreeSign(Adafruit_GFX* gfx, int16_t x, int16_t y, uint16_t color);
 void drawSeparatorLine(int16_t y, uint16_t color);
 void drawIconAtScale(CachedIcon* icon, int16_t x, int16_t y, uint8_t scale);
 void displayClear();
+void displayFlush();
 void displaySetBrightness(uint8_t brightness);
 
+// Damage tracking
+uint32_t damageHash(uint32_t hash, const void* data, size_t len);
+bool damageBegin(DamageLayout layout, uint32_t signature);
+void damageAdd(int16_t x, int16_t y, int16_t w, int16_t h);
+bool damageIntersects(int16_t x, int16_t y, int16_t w, int16_t h);
+void damageClear();
+void damageEnd();
+void damageInvalidate();
+void damageFullFrame();
+void displayRecordFrame(uint32_t pixelsTouched, bool partial);
+
+// App transitions
+const char* transitionToString(uint8_t type);
+uint8_t transitionFromString(const char* name, uint8_t fallback);
+TransitionType transitionForApp(const AppItem* app);
+bool transitionBegin(TransitionType type);
+void transitionCommit();
+void transitionCancel();
+bool transitionStep(unsigned long now);
+
 int16_t calculateTextWidth(const char* text);
 bool textNeedsScroll(const char* text, int16_t availableWidth);
 void resetScrollState();
 
+bool displayShowGif(AppItem* app, int8_t appIndex);
+bool gifFrameDue(unsigned long now);
+void gifStop(bool releaseDecoder);
+
 int pngDrawCallback(PNGDRAW *pDraw);
 CachedIcon* loadIcon(const char* name);
 CachedIcon* getIcon(const char* name);
-int8_t findLRUSlot();
+CachedIcon* getIconHashed(const char* name, uint32_t hash);
+int8_t iconReserveSlot(uint32_t bytes);
+void iconFree(CachedIcon* icon);
+bool iconImport(const char* name);
+void iconRemoveSidecar(const char* name);
+void loopIconTranscode();
+void loopIconPrefetch();
+bool iconAnimationDue(unsigned long now);
+void iconAnimationDeadline(FrameDeadline& next);
 void drawIcon(CachedIcon* icon, int16_t x, int16_t y);
 void initIconCache();
 void invalidateCachedIcon(const char* name);
 bool validatePngHeader(const uint8_t* data, size_t len);
 bool validateGifHeader(const uint8_t* data, size_t len);
 bool downloadLaMetricIcon(uint32_t iconId, const char* saveName);
+bool iconDownloadRequest(uint32_t iconId, const char* name, bool force);
+bool iconDownloadPending(const char* name);
+void setupIconDownloads();
+void loopIconDownloads();
 void handleApiIconsList(AsyncWebServerRequest *request);
 void handleApiIconsServe(AsyncWebServerRequest *request, const String& name);
 void handleApiIconsDelete(AsyncWebServerRequest *request);
@@ -533,7 +1041,7 @@ void handleApiIconsDelete(AsyncWebServerRequest *request);
 bool loadSettings();
 bool saveSettings();
 void initDefaultSettings();
-void printTextWithSpecialChars(const char* text, int16_t x, int16_t y);
+void printTextWithSpecialChars(Adafruit_GFX* gfx, const char* text, int16_t x, int16_t y);
 bool ensureDirectories();
 bool loadApps();
 bool saveApps();
@@ -545,8 +1053,10 @@ bool appRemove(const char* id);
 bool appUpdate(const char* id, const char* text, const char* icon,
                uint32_t textColor);
 int8_t appFind(const char* id);
+void appCompile(AppItem* app);
 void appCleanExpired();
 AppItem* appGetNext();
+int8_t appPeekNext();
 AppItem* appGetCurrent();
 void appSetZones(int8_t appIndex, JsonArray zonesArray);
 void displayShowMultiZone(AppItem* app);
@@ -555,6 +1065,7 @@ void displayShowZone(AppZone* zone, int16_t x, int16_t y, int16_t w, int16_t h);
 // Tracker management
 TrackerData* trackerFind(const char* name);
 TrackerData* trackerAllocate(const char* name);
+void trackerPackColors(TrackerData* tracker);
 bool trackerRemove(const char* name);
 void trackerInit();
 void displayShowTracker(TrackerData* tracker);
@@ -567,11 +1078,16 @@ void parseTextFieldWithSegments(JsonVariant field, char* textBuffer, size_t text
                                 TextSegment* segments, uint8_t* segmentCount, uint32_t defaultColor);
 void serializeTextField(JsonObject& obj, const char* fieldName, const char* text,
                         const TextSegment* segments, uint8_t segmentCount);
-void printTextWithSegments(const char* text, int16_t x, int16_t y,
-                           uint32_t defaultColor, const TextSegment* segments, uint8_t segmentCount);
+void printTextWithSegments(Adafruit_GFX* gfx, const char* text, int16_t x, int16_t y,
+                           uint16_t defaultColor, const TextSegment* segments, uint8_t segmentCount);
 void printLabelWithSegments(const char* text, int16_t x, int16_t y,
-                            uint32_t defaultColor, const TextSegment* segments, uint8_t segmentCount,
+                            uint16_t defaultColor, const TextSegment* segments, uint8_t segmentCount,
                             bool dimDefault);
+uint32_t textStripSignature(const char* text, uint16_t defaultColor,
+                            const TextSegment* segments, uint8_t segmentCount);
+TextStripCanvas* textStripPrepare(TextStripCache* cache, uint32_t signature, const char* text,
+                                  uint16_t defaultColor, const TextSegment* segments, uint8_t segmentCount);
+void textStripRelease(TextStripCache* cache);
 
 // Notification management
 void notifInit();
@@ -581,6 +1097,7 @@ int8_t notifAdd(const char* id, const char* text, const char* icon,
 bool notifDismiss();
 void notifClearAll();
 NotificationItem* notifGetCurrent();
+int8_t notifPeekNext();
 NotificationItem* notifGetNext();
 bool notifIsExpired(NotificationItem* notif);
 void displayShowNotification(NotificationItem* notif);
@@ -591,30 +1108,34 @@ void indicatorInit();
 void indicatorSet(uint8_t index, IndicatorMode mode, uint32_t color,
                   uint16_t blinkInterval, uint16_t fadePeriod);
 void indicatorOff(uint8_t index);
+void indicatorOrigin(uint8_t index, int16_t* x, int16_t* y);
 void drawIndicators();
 bool indicatorNeedsRedraw();
+void indicatorDeadline(FrameDeadline& next, unsigned long lastDraw);
 void handleIndicatorApi(AsyncWebServerRequest *request, JsonVariant &json, uint8_t index);
 
 void mqttCallback(char* topic, byte* payload, unsigned int length);
 bool mqttConnect();
 void mqttPublishStats();
-void mqttHandleCustom(const char* name, JsonObject& doc);
-void mqttHandleCustomDelete(const char* name);
-void mqttHandleNotify(JsonObject& doc);
-void mqttHandleDismiss();
-void mqttHandleIndicator(uint8_t index, JsonObject& doc);
-void mqttHandleWeather(JsonObject& doc);
-void mqttHandleTracker(const char* name, JsonObject& doc);
-void mqttHandleTrackerDelete(const char* name);
-void mqttHandleSettings(JsonObject& doc);
-void mqttHandleBrightness(JsonObject& doc);
-void mqttHandleReboot();
+bool mqttQueue(const char* topic, const char* payload, size_t length, bool retained);
+
+bool commandPost(CommandQueue& queue, uint8_t type, uint8_t index, const char* name,
+                 const char* payload, size_t length);
+void commandRespond(AsyncWebServerRequest* request, uint8_t type, uint8_t index, const char* name,
+                    JsonVariant json, const char* response);
+void handleBatchApi(AsyncWebServerRequest* request, JsonVariant& json);
+static bool batchOpParse(JsonObject op, uint8_t* type, uint8_t* index, String& errorOut);
+bool commandDrain(uint32_t* queuedUs);
+static bool commandHasBody(uint8_t type);
 
 void handleApiStats(AsyncWebServerRequest *request);
+void buildTimingJson(JsonObject root);
+void buildCommandQueueJson(JsonObject root, const CommandQueue& queue);
 void handleApiSettings(AsyncWebServerRequest *request);
 void handleApiApps(AsyncWebServerRequest *request);
 
 void logMemory();
+void* bootAlloc(size_t bytes, const char* what);
 
 bool sleepIsActive();
 static bool dayIndexFromName(const char* name, uint8_t& outIndex);
@@ -623,6 +1144,7 @@ static bool parseHourMinute(const char* text, uint8_t& outHour, uint8_t& outMinu
 static void formatHourMinute(uint8_t hour, uint8_t minute, char* out, size_t outSize);
 static const char* sleepReasonToString(SleepReason reason);
 static void buildSleepConfigJson(JsonObject root);
+static bool sleepParseUpdate(JsonObject body, SleepSchedule& scratch, String& errorOut);
 static bool applySleepUpdate(JsonObject body, String& errorOut);
 static void wakeNow();
 
@@ -634,6 +1156,18 @@ void setup() {
     Serial.begin(115200);
     delay(100);
 
+    stateMutex = xSemaphoreCreateRecursiveMutex();
+    iconDecodeMutex = xSemaphoreCreateMutex();
+    StateSnapshot* snapshotCopies = (StateSnapshot*)bootAlloc(
+        sizeof(StateSnapshot) * STATE_SNAPSHOT_COPIES, "state snapshot");
+    if (!snapshotCopies) {
+        Serial.println("[ERROR] State snapshot allocation failed!");
+        while (true) { delay(1000); }
+    }
+    stateSnapshots.attach(snapshotCopies);
+    fontMetricsInit(&fontDefault, nullptr);
+    fontMetricsInit(&fontTomThumb, &TomThumb);
+
     Serial.println();
     Serial.println("========================================");
     Serial.println("   ESP32-PixelCast v" VERSION_STRING);
@@ -686,20 +1220,23 @@ void setup() {
         ArduinoOTA.setHostname(MDNS_NAME);
         ArduinoOTA.onStart([]() {
             Serial.println("[OTA] Update starting...");
-            dma_display->fillScreen(0);
-            dma_display->setTextSize(1);
-            dma_display->setTextColor(dma_display->color565(255, 165, 0));
+            StateLock lock;
+            renderSuspended = true;
+            transitionCancel();
+            gifStop(true);
+            canvas->fillScreen(0);
+            damageFullFrame();
+            canvas->setTextSize(1);
+            canvas->setTextColor(panelColor(255, 165, 0));
             // "OTA" default font, centered (3 chars x 6px = 18px)
-            dma_display->setCursor(23, 4);
-            dma_display->print("OTA");
+            canvas->setCursor(23, 4);
+            canvas->print("OTA");
             // "UPDATE" same font, centered (6 chars x 6px = 36px)
-            dma_display->setCursor(14, 18);
-            dma_display->print("UPDATE");
+            canvas->setCursor(14, 18);
+            canvas->print("UPDATE");
             // Progress bar frame near bottom
-            dma_display->drawRect(4, 46, 56, 7, dma_display->color565(80, 80, 80));
-            #if DOUBLE_BUFFER
-                dma_display->flipDMABuffer();
-            #endif
+            canvas->drawRect(4, 46, 56, 7, panelColor(80, 80, 80));
+            displayFlush();
         });
         ArduinoOTA.onProgress([](unsigned int progress, unsigned int total) {
             static uint8_t lastPercent = 255;
@@ -707,45 +1244,47 @@ void setup() {
             // Only redraw every 5% to avoid slowing down OTA transfer
             if (percent == lastPercent || (percent % 5 != 0 && percent != 100)) return;
             lastPercent = percent;
+            StateLock lock;
             uint8_t barWidth = (uint8_t)((progress * 54) / total);
             if (barWidth > 0) {
-                dma_display->fillRect(5, 47, barWidth, 5,
-                    dma_display->color565(255, 165, 0));
+                canvas->fillRect(5, 47, barWidth, 5,
+                    panelColor(255, 165, 0));
             }
-            dma_display->fillRect(0, 56, 64, 8, 0);
+            canvas->fillRect(0, 56, 64, 8, 0);
             char buf[8];
             snprintf(buf, sizeof(buf), "%d%%", percent);
-            dma_display->setFont(&TomThumb);
-            dma_display->setTextColor(dma_display->color565(150, 150, 150));
-            int16_t textW = strlen(buf) * 4;
-            dma_display->setCursor((64 - textW) / 2, 60);
-            dma_display->print(buf);
-            dma_display->setFont(NULL);
+            canvas->setFont(&TomThumb);
+            canvas->setTextColor(panelColor(150, 150, 150));
+            int16_t textW = fontTextWidth(&fontTomThumb, buf);
+            canvas->setCursor((64 - textW) / 2, 60);
+            canvas->print(buf);
+            canvas->setFont(NULL);
+            displayFlush();
         });
         ArduinoOTA.onEnd([]() {
             Serial.println("[OTA] Update complete!");
-            dma_display->fillScreen(0);
-            dma_display->setTextColor(dma_display->color565(0, 255, 0));
-            dma_display->setCursor(13, 24);
-            dma_display->print("DONE");
-            dma_display->setFont(&TomThumb);
-            dma_display->setTextColor(dma_display->color565(100, 100, 100));
-            dma_display->setCursor(8, 38);
-            dma_display->print("Rebooting...");
-            dma_display->setFont(NULL);
-            #if DOUBLE_BUFFER
-                dma_display->flipDMABuffer();
-            #endif
+            StateLock lock;
+            canvas->fillScreen(0);
+            canvas->setTextColor(panelColor(0, 255, 0));
+            canvas->setCursor(13, 24);
+            canvas->print("DONE");
+            canvas->setFont(&TomThumb);
+            canvas->setTextColor(panelColor(100, 100, 100));
+            canvas->setCursor(8, 38);
+            canvas->print("Rebooting...");
+            canvas->setFont(NULL);
+            displayFlush();
         });
         ArduinoOTA.onError([](ota_error_t error) {
-            Serial.printf("[OTA] Error[%u]\n", error);
-            dma_display->fillScreen(0);
-            dma_display->setTextColor(dma_display->color565(255, 0, 0));
-            dma_display->setCursor(7, 28);
-            dma_display->print("OTA ERR");
-            #if DOUBLE_BUFFER
-                dma_display->flipDMABuffer();
-            #endif
+            Serial.printf("[OTA] Error[%d]\n", (int)error);
+            StateLock lock;
+            renderSuspended = false;
+            canvas->fillScreen(0);
+            damageFullFrame();
+            canvas->setTextColor(panelColor(255, 0, 0));
+            canvas->setCursor(7, 28);
+            canvas->print("OTA ERR");
+            displayFlush();
         });
         ArduinoOTA.begin();
 
@@ -797,6 +1336,10 @@ void setup() {
         weatherData.valid = true;
     }
 
+    Serial.println("[INIT] Starting render task...");
+    setupRenderTask();
+    setupIconDownloads();
+
     logMemory();
     Serial.println("[INIT] Setup complete!");
     Serial.println();
@@ -809,6 +1352,7 @@ void setup() {
 void loop() {
     // Handle pending reboot (allow response to be sent first)
     if (pendingReboot && (millis() - rebootRequestTime > 500)) {
+        loopPersistence();
         Serial.println("[SYSTEM] Rebooting...");
         ESP.restart();
     }
@@ -816,11 +1360,194 @@ void loop() {
     ArduinoOTA.handle();
     loopWiFi();
     loopMQTT();
+    loopPersistence();
+    loopIconTranscode();
+    loopIconDownloads();
+
+    // Fallback when the render task could not be created
+    if (!renderTaskHandle) {
+        renderFrame();
+    }
+
+    delay(LOOP_DELAY);
+}
+
+// ============================================================================
+// Render Task
+// ============================================================================
+
+void stateLock() {
+    if (stateMutex) xSemaphoreTakeRecursive(stateMutex, portMAX_DELAY);
+}
+
+void stateUnlock() {
+    if (stateMutex) xSemaphoreGiveRecursive(stateMutex);
+}
+
+// True when the calling task holds the state lock
+bool stateLockHeld() {
+    return stateMutex && xSemaphoreGetMutexHolder(stateMutex) == xTaskGetCurrentTaskHandle();
+}
+
+void setupRenderTask() {
+    BaseType_t created = xTaskCreatePinnedToCore(renderTask, "render", RENDER_TASK_STACK,
+                                                 nullptr, RENDER_TASK_PRIORITY,
+                                                 &renderTaskHandle, RENDER_TASK_CORE);
+    if (created != pdPASS) {
+        renderTaskHandle = nullptr;
+        Serial.println("[RENDER] Failed to create render task, rendering from loop()");
+        return;
+    }
+    Serial.printf("[RENDER] Task started on core %d (%d-%d ms frames)\n",
+                  RENDER_TASK_CORE, RENDER_FRAME_PERIOD, RENDER_IDLE_PERIOD);
+}
+
+// Run the next frame now instead of at its deadline, after queueing a command
+void renderWake() {
+    if (renderTaskHandle) xTaskNotifyGive(renderTaskHandle);
+}
+
+// When the next frame is due: the earliest deadline offered by the
+// subsystems, at least a frame period after this frame started and at most
+// the idle period. Under the state lock.
+static unsigned long renderNextFrameAt(unsigned long frameStart) {
+    FrameDeadline next;
+    next.at = frameStart + RENDER_IDLE_PERIOD;
+    sleepDeadline(next);
+    appsDeadline(next);
+    displayDeadline(next);
+
+    unsigned long earliest = frameStart + RENDER_FRAME_PERIOD;
+    if ((long)(next.at - earliest) < 0) next.at = earliest;
+    return next.at;
+}
+
+// One frame: app rotation, notifications and display update. Returns the
+// millis() at which the next one is due.
+unsigned long renderFrame() {
+    unsigned long frameStart = millis();
+    if (renderSuspended) return frameStart + RENDER_IDLE_PERIOD;
+    uint32_t startUs = micros();
+    StateLock lock;
+    uint32_t queuedUs;
+    bool ingested = commandDrain(&queuedUs);
     loopSleepTransition();
     loopApps();
     loopDisplay();
+    snapshotPublish();
+    if (ingested) renderRecordIngest(micros() - queuedUs);
 
-    delay(LOOP_DELAY);
+    // Spend what is left of a quiet frame picking upcoming icons to warm
+    if (micros() - startUs < ICON_PREFETCH_IDLE_US) {
+        loopIconPrefetch();
+    }
+    return renderNextFrameAt(frameStart);
+}
+
+// ============================================================================
+// State Snapshot
+// ============================================================================
+
+// Render task, under the state lock
+void snapshotPublish() {
+    if (snapshotVersion == stateVersion) return;
+    uint8_t index;
+    StateSnapshot* snap = stateSnapshots.beginWrite(&index);
+    if (!snap) {
+        snapshotDeferrals++;
+        return;
+    }
+    snap->version = stateVersion;
+    memcpy(snap->apps, apps, sizeof(apps));
+    snap->appCount = appCount;
+    snap->currentAppIndex = currentAppIndex;
+    snap->appRotationEnabled = appRotationEnabled;
+    memcpy(snap->notifications, notifications, sizeof(notifications));
+    snap->notificationCount = notificationCount;
+    snap->currentNotifIndex = currentNotifIndex;
+    memcpy(snap->trackers, trackers, sizeof(trackers));
+    snap->trackerCount = trackerCount;
+    stateSnapshots.publish(index);
+    snapshotVersion = stateVersion;
+    snapshotPublishes++;
+}
+
+// Only a single copy can be caught mid-refresh. The frame fills it under
+// the state lock, so once the lock is ours the copy is complete.
+uint8_t snapshotPin() {
+    uint8_t index;
+    if (stateSnapshots.tryPin(&index)) return index;
+    StateLock lock;
+    while (!stateSnapshots.tryPin(&index)) {}
+    return index;
+}
+
+static void renderWindowRoll(RenderTaskStats& st) {
+    unsigned long now = millis();
+    unsigned long windowMs = now - st.windowStart;
+    if (windowMs < RENDER_STATS_WINDOW) return;
+
+    st.jitterMaxUs = st.windowJitterMaxUs;
+    st.frameMaxUs = st.windowFrameMaxUs;
+    st.ingestMaxUs = st.windowIngestMaxUs;
+    st.frameRate = st.windowFrames * 1000UL / windowMs;
+    st.busyPermille = st.windowBusyUs / windowMs;  // us per ms
+    st.windowJitterMaxUs = 0;
+    st.windowFrameMaxUs = 0;
+    st.windowIngestMaxUs = 0;
+    st.windowBusyUs = 0;
+    st.windowFrames = 0;
+    st.windowStart = now;
+}
+
+static void renderRecordFrame(uint32_t jitterUs, uint32_t frameUs, bool woken) {
+    RenderTaskStats& st = renderStats;
+    st.frames++;
+    st.frameUs = frameUs;
+    if (frameUs > RENDER_FRAME_PERIOD * 1000UL) st.overruns++;
+    if (frameUs > st.windowFrameMaxUs) st.windowFrameMaxUs = frameUs;
+    st.windowBusyUs += frameUs;
+    st.windowFrames++;
+
+    if (woken) {
+        st.wakeups++;
+    } else {
+        st.jitterUs = jitterUs;
+        st.jitterAvgUs = st.jitterAvgUs - (st.jitterAvgUs >> 4) + (jitterUs >> 4);
+        if (jitterUs > st.windowJitterMaxUs) st.windowJitterMaxUs = jitterUs;
+    }
+    renderWindowRoll(st);
+}
+
+// Frame that applied queued commands, under the state lock
+void renderRecordIngest(uint32_t ingestUs) {
+    RenderTaskStats& st = renderStats;
+    st.ingestUs = ingestUs;
+    st.ingestAvgUs = st.ingestAvgUs - (st.ingestAvgUs >> 4) + (ingestUs >> 4);
+    if (ingestUs > st.windowIngestMaxUs) st.windowIngestMaxUs = ingestUs;
+}
+
+// Event-driven frame clock: sleeps until the deadline returned by the last
+// frame, or until renderWake() signals a queued command. Jitter is how late
+// a timed wake-up is against its deadline.
+void renderTask(void* param) {
+    renderStats.windowStart = millis();
+    unsigned long nextAt = millis();
+
+    while (true) {
+        bool woken = false;
+        long waitMs = (long)(nextAt - millis());
+        uint32_t dueUs = micros() + (waitMs > 0 ? waitMs * 1000UL : 0);
+        if (waitMs > 0) {
+            woken = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(waitMs)) > 0;
+        }
+        uint32_t wakeUs = micros();
+        int32_t lateness = (int32_t)(wakeUs - dueUs);
+
+        nextAt = renderFrame();
+
+        renderRecordFrame(lateness > 0 ? (uint32_t)lateness : 0, micros() - wakeUs, woken);
+    }
 }
 
 // ============================================================================
@@ -865,41 +1592,53 @@ void setupDisplay() {
     }
 
     dma_display->setBrightness8(currentBrightness);
-    dma_display->setTextWrap(false);  // Prevent ghost characters on text scroll
     dma_display->clearScreen();
 
+    // Off-screen frame: every displayShow* draws here, displayFlush() pushes the diff
+    canvas = new GFXcanvas16(DISPLAY_WIDTH, DISPLAY_HEIGHT);
+    for (uint8_t i = 0; i < FRAME_SHADOW_COUNT; i++) {
+        frameShadow[i] = (uint16_t*)calloc(DISPLAY_WIDTH * DISPLAY_HEIGHT, sizeof(uint16_t));
+    }
+    if (!canvas->getBuffer() || !frameShadow[0] || !frameShadow[FRAME_SHADOW_COUNT - 1]) {
+        Serial.println("[ERROR] Frame buffer allocation failed!");
+        while (true) { delay(1000); }
+    }
+
+    canvas->setTextWrap(false);  // Prevent ghost characters on text scroll
+    canvas->fillScreen(0);
+
     Serial.printf("[DISPLAY] Initialized %dx%d panel (E_PIN=%d)\n", PANEL_WIDTH, PANEL_HEIGHT, E_PIN);
 }
 
 void displayShowBoot() {
-    dma_display->clearScreen();
-    dma_display->setTextColor(dma_display->color565(0, 150, 255));
-    dma_display->setTextSize(1);
-    dma_display->setCursor(4, 24);
-    dma_display->print("PixelCast");
-    dma_display->setCursor(4, 36);
-    dma_display->setTextColor(dma_display->color565(100, 100, 100));
-    dma_display->print("v" VERSION_STRING);
-
-    #if DOUBLE_BUFFER
-        dma_display->flipDMABuffer();
-    #endif
+    canvas->fillScreen(0);
+    damageFullFrame();
+    canvas->setTextColor(panelColor(0, 150, 255));
+    canvas->setTextSize(1);
+    canvas->setCursor(4, 24);
+    canvas->print("PixelCast");
+    canvas->setCursor(4, 36);
+    canvas->setTextColor(panelColor(100, 100, 100));
+    canvas->print("v" VERSION_STRING);
+
+    displayFlush();
 }
 
 void displayShowIP() {
-    dma_display->clearScreen();
+    canvas->fillScreen(0);
+    damageFullFrame();
 
     // "WiFi OK" in default font, centered
-    dma_display->setFont(NULL);
-    dma_display->setTextSize(1);
-    dma_display->setTextColor(dma_display->color565(0, 255, 0));
-    dma_display->setCursor(11, 12);
-    dma_display->print("WiFi OK");
+    canvas->setFont(NULL);
+    canvas->setTextSize(1);
+    canvas->setTextColor(panelColor(0, 255, 0));
+    canvas->setCursor(11, 12);
+    canvas->print("WiFi OK");
 
     // IP address in default font, split across 2 lines for readability
     // e.g. "192.168" on line 1, "1.100" on line 2
     String ip = WiFi.localIP().toString();
-    dma_display->setTextColor(dma_display->color565(255, 255, 255));
+    canvas->setTextColor(panelColor(255, 255, 255));
 
     // Find the second dot to split the IP into 2 halves
     int firstDot = ip.indexOf('.');
@@ -910,25 +1649,21 @@ void displayShowIP() {
     // Line 1: first two octets (NULL font, 6px per char)
     int16_t line1Width = line1.length() * 6;
     int16_t line1X = (DISPLAY_WIDTH - line1Width) / 2;
-    dma_display->setCursor(line1X, 28);
-    dma_display->print(line1);
+    canvas->setCursor(line1X, 28);
+    canvas->print(line1);
 
     // Line 2: last two octets
     int16_t line2Width = line2.length() * 6;
     int16_t line2X = (DISPLAY_WIDTH - line2Width) / 2;
-    dma_display->setCursor(line2X, 40);
-    dma_display->print(line2);
+    canvas->setCursor(line2X, 40);
+    canvas->print(line2);
 
-    #if DOUBLE_BUFFER
-        dma_display->flipDMABuffer();
-    #endif
+    displayFlush();
 
     delay(3000);
 }
 
 void displayShowTime() {
-    dma_display->clearScreen();
-
     time_t nowUtc = time(nullptr);
     struct tm localTm;
     localtime_r(&nowUtc, &localTm);
@@ -949,30 +1684,42 @@ void displayShowTime() {
         snprintf(timeStr, sizeof(timeStr), "%02d:%02d", hours, minutes);
     }
 
-    // Extract RGB from color
-    uint8_t r = (settings.clockColor >> 16) & 0xFF;
-    uint8_t g = (settings.clockColor >> 8) & 0xFF;
-    uint8_t b = settings.clockColor & 0xFF;
-
-    // Draw time centered
-    dma_display->setTextColor(dma_display->color565(r, g, b));
-    dma_display->setTextSize(1);
-
     // Center text based on format
     int textWidth = settings.clockShowSeconds ? 48 : 30;
     int xPos = (DISPLAY_WIDTH - textWidth) / 2;
-    dma_display->setCursor(xPos, 28);
-    dma_display->print(timeStr);
+
+    // Only the digits that changed since the last frame are redrawn
+    uint32_t signature = damageHash(DAMAGE_HASH_SEED, &settings.clockColor, sizeof(settings.clockColor));
+    signature = damageHash(signature, &settings.clockShowSeconds, sizeof(settings.clockShowSeconds));
+    damageBegin(DAMAGE_LAYOUT_CLOCK, signature);
+
+    static char lastTimeStr[9] = "";
+    for (uint8_t i = 0; timeStr[i] != '\0'; i++) {
+        if (timeStr[i] != lastTimeStr[i]) {
+            damageAdd(xPos + i * 6, 28, 6, 8);
+        }
+    }
+    strlcpy(lastTimeStr, timeStr, sizeof(lastTimeStr));
+
+    damageClear();
+
+    // Draw time centered
+    if (damageIntersects(xPos, 28, textWidth, 8)) {
+        canvas->setTextColor(panelColorRGB(settings.clockColor));
+        canvas->setTextSize(1);
+        canvas->setCursor(xPos, 28);
+        canvas->print(timeStr);
+    }
 
     drawIndicators();
+    damageEnd();
 
-    #if DOUBLE_BUFFER
-        dma_display->flipDMABuffer();
-    #endif
+    displayFlush();
 }
 
 void displayShowDate() {
-    dma_display->clearScreen();
+    canvas->fillScreen(0);
+    damageFullFrame();
 
     time_t nowUtc = time(nullptr);
     struct tm localTm;
@@ -993,48 +1740,36 @@ void displayShowDate() {
         snprintf(dateStr, sizeof(dateStr), "%02u/%02u/%04u", day, month, year);
     }
 
-    // Extract RGB from color
-    uint8_t r = (settings.dateColor >> 16) & 0xFF;
-    uint8_t g = (settings.dateColor >> 8) & 0xFF;
-    uint8_t b = settings.dateColor & 0xFF;
-
     // Draw date centered
-    dma_display->setTextColor(dma_display->color565(r, g, b));
-    dma_display->setTextSize(1);
+    canvas->setTextColor(panelColorRGB(settings.dateColor));
+    canvas->setTextSize(1);
 
     int textWidth = 60;
     int xPos = (DISPLAY_WIDTH - textWidth) / 2;
-    dma_display->setCursor(xPos, 28);
-    dma_display->print(dateStr);
+    canvas->setCursor(xPos, 28);
+    canvas->print(dateStr);
 
     drawIndicators();
 
-    #if DOUBLE_BUFFER
-        dma_display->flipDMABuffer();
-    #endif
+    displayFlush();
 }
 
-// Draw icon at explicit scale (1 = native, 2 = upscale x2)
+// Draw icon at explicit integer scale (1 = native, 2 = upscale x2, 3 = x3)
 void drawIconAtScale(CachedIcon* icon, int16_t x, int16_t y, uint8_t scale) {
-    if (!icon || !icon->valid || !icon->pixels) return;
-
-    for (uint8_t py = 0; py < icon->height; py++) {
-        for (uint8_t px = 0; px < icon->width; px++) {
-            uint16_t pixel = icon->pixels[py * icon->width + px];
-            if (pixel != 0) {
-                if (scale == 2) {
-                    int16_t dx = x + px * 2;
-                    int16_t dy = y + py * 2;
-                    dma_display->drawPixel(dx, dy, pixel);
-                    dma_display->drawPixel(dx + 1, dy, pixel);
-                    dma_display->drawPixel(dx, dy + 1, pixel);
-                    dma_display->drawPixel(dx + 1, dy + 1, pixel);
-                } else {
-                    dma_display->drawPixel(x + px, y + py, pixel);
-                }
-            }
-        }
-    }
+    if (!icon || !icon->valid || !icon->pixels || !icon->spans) return;
+
+    const IconFrame& frame = icon->frames[icon->frame];
+    const uint16_t* pixels = icon->pixels + icon->frame * icon->width * icon->height;
+    drawIconSpans(canvas, pixels, icon->width, icon->spans + frame.firstSpan, frame.spanCount,
+                  x, y, scale);
+}
+
+// Draw a degree sign (3x3 ring, top-left at x, y)
+void drawDegreeSign(Adafruit_GFX* gfx, int16_t x, int16_t y, uint16_t color) {
+    gfx->drawPixel(x + 1, y,     color);
+    gfx->drawPixel(x,     y + 1, color);
+    gfx->drawPixel(x + 2, y + 1, color);
+    gfx->drawPixel(x + 1, y + 2, color);
 }
 
 // Draw a small water drop icon (5px tall)
@@ -1044,22 +1779,138 @@ void drawDropIcon(int16_t x, int16_t y, uint16_t color) {
     //   XXX
     //   XXX
     //   .X.
-    dma_display->drawPixel(x + 1, y,     color);
-    dma_display->drawPixel(x + 1, y + 1, color);
-    dma_display->drawPixel(x,     y + 2, color);
-    dma_display->drawPixel(x + 1, y + 2, color);
-    dma_display->drawPixel(x + 2, y + 2, color);
-    dma_display->drawPixel(x,     y + 3, color);
-    dma_display->drawPixel(x + 1, y + 3, color);
-    dma_display->drawPixel(x + 2, y + 3, color);
-    dma_display->drawPixel(x + 1, y + 4, color);
+    canvas->drawPixel(x + 1, y,     color);
+    canvas->drawPixel(x + 1, y + 1, color);
+    canvas->drawPixel(x,     y + 2, color);
+    canvas->drawPixel(x + 1, y + 2, color);
+    canvas->drawPixel(x + 2, y + 2, color);
+    canvas->drawPixel(x,     y + 3, color);
+    canvas->drawPixel(x + 1, y + 3, color);
+    canvas->drawPixel(x + 2, y + 3, color);
+    canvas->drawPixel(x + 1, y + 4, color);
 }
 
 // Draw a thin horizontal separator line
 void drawSeparatorLine(int16_t y, uint16_t color) {
     for (int16_t x = 4; x < DISPLAY_WIDTH - 4; x++) {
-        dma_display->drawPixel(x, y, color);
+        canvas->drawPixel(x, y, color);
+    }
+}
+
+// ============================================================================
+// Damage Tracking
+// ============================================================================
+
+// FNV-1a, used to build layout content signatures
+uint32_t damageHash(uint32_t hash, const void* data, size_t len) {
+    const uint8_t* bytes = (const uint8_t*)data;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Start a frame for a partial-redraw layout.
+// Returns true when the whole screen must be redrawn (layout or signature changed).
+bool damageBegin(DamageLayout layout, uint32_t signature) {
+    damage.fullFrame = (layout != damage.layout || signature != damage.signature);
+    damage.layout = layout;
+    damage.signature = signature;
+    damage.rectCount = 0;
+
+    // Animated or reconfigured indicators dirty their corners
+    if (damage.indicatorsChanged || indicatorNeedsRedraw()) {
+        damageAdd(0, 0, INDICATOR_FOOTPRINT, INDICATOR_FOOTPRINT);
+        damageAdd(DISPLAY_WIDTH - INDICATOR_FOOTPRINT, 0, INDICATOR_FOOTPRINT, INDICATOR_FOOTPRINT);
+        damageAdd(DISPLAY_WIDTH - INDICATOR_FOOTPRINT, DISPLAY_HEIGHT - INDICATOR_FOOTPRINT,
+                  INDICATOR_FOOTPRINT, INDICATOR_FOOTPRINT);
+        damage.indicatorsChanged = false;
+    }
+
+    return damage.fullFrame;
+}
+
+// Mark a rectangle as changed this frame (clipped to the screen)
+void damageAdd(int16_t x, int16_t y, int16_t w, int16_t h) {
+    if (x < 0) { w += x; x = 0; }
+    if (y < 0) { h += y; y = 0; }
+    if (x + w > DISPLAY_WIDTH) w = DISPLAY_WIDTH - x;
+    if (y + h > DISPLAY_HEIGHT) h = DISPLAY_HEIGHT - y;
+    if (w <= 0 || h <= 0) return;
+
+    if (damage.rectCount < MAX_DIRTY_RECTS) {
+        damage.rects[damage.rectCount++] = { x, y, w, h };
+        return;
+    }
+
+    // Out of slots: grow the last rect to cover the new one
+    DirtyRect& last = damage.rects[MAX_DIRTY_RECTS - 1];
+    int16_t x2 = max((int16_t)(last.x + last.w), (int16_t)(x + w));
+    int16_t y2 = max((int16_t)(last.y + last.h), (int16_t)(y + h));
+    last.x = min(last.x, x);
+    last.y = min(last.y, y);
+    last.w = x2 - last.x;
+    last.h = y2 - last.y;
+}
+
+bool damageIntersects(int16_t x, int16_t y, int16_t w, int16_t h) {
+    if (damage.fullFrame) return true;
+
+    for (uint8_t i = 0; i < damage.rectCount; i++) {
+        const DirtyRect& r = damage.rects[i];
+        if (x < r.x + r.w && r.x < x + w && y < r.y + r.h && r.y < y + h) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Clear the damaged area before redrawing the elements that intersect it
+void damageClear() {
+    if (damage.fullFrame) {
+        canvas->fillScreen(0);
+        return;
+    }
+
+    for (uint8_t i = 0; i < damage.rectCount; i++) {
+        const DirtyRect& r = damage.rects[i];
+        canvas->fillRect(r.x, r.y, r.w, r.h, 0);
+    }
+}
+
+void damageEnd() {
+    uint32_t pixelsTouched = 0;
+    if (damage.fullFrame) {
+        pixelsTouched = DISPLAY_WIDTH * DISPLAY_HEIGHT;
+    } else {
+        // Overlapping rects are counted twice (upper bound)
+        for (uint8_t i = 0; i < damage.rectCount; i++) {
+            pixelsTouched += damage.rects[i].w * damage.rects[i].h;
+        }
+    }
+
+    displayRecordFrame(pixelsTouched, !damage.fullFrame);
+}
+
+// Force the next partial-redraw layout to start with a full redraw
+void damageInvalidate() {
+    damage.layout = DAMAGE_LAYOUT_NONE;
+}
+
+// Called by layouts that always clear and redraw the whole screen
+void damageFullFrame() {
+    damageInvalidate();
+    displayRecordFrame(DISPLAY_WIDTH * DISPLAY_HEIGHT, false);
+}
+
+void displayRecordFrame(uint32_t pixelsTouched, bool partial) {
+    displayFrameStats.frames++;
+    if (partial) {
+        displayFrameStats.partialFrames++;
     }
+    displayFrameStats.lastPixelsTouched = pixelsTouched;
+    displayFrameStats.totalPixelsTouched += pixelsTouched;
 }
 
 // ============================================================================
@@ -1075,6 +1926,11 @@ TrackerData* trackerFind(const char* name) {
     return nullptr;
 }
 
+void trackerPackColors(TrackerData* tracker) {
+    tracker->symbolColorPanel = panelColorRGB(tracker->symbolColor);
+    tracker->sparklineColorPanel = panelColorRGB(tracker->sparklineColor);
+}
+
 TrackerData* trackerAllocate(const char* name) {
     // Check if already exists
     TrackerData* existing = trackerFind(name);
@@ -1087,8 +1943,10 @@ TrackerData* trackerAllocate(const char* name) {
             strlcpy(trackers[i].name, name, sizeof(trackers[i].name));
             trackers[i].symbolColor = 0xFFFFFF;    // Default white
             trackers[i].sparklineColor = 0x00D4FF;  // Default cyan
+            trackerPackColors(&trackers[i]);
             trackers[i].valid = true;
             trackerCount++;
+            stateVersion++;
             return &trackers[i];
         }
     }
@@ -1101,6 +1959,7 @@ bool trackerRemove(const char* name) {
 
     tracker->valid = false;
     trackerCount--;
+    stateVersion++;
 
     // Remove corresponding app from rotation
     char appId[32];
@@ -1127,6 +1986,7 @@ void notifInit() {
     currentNotifIndex = -1;
     savedAppIndex = -1;
     memset(&notifScrollState, 0, sizeof(notifScrollState));
+    stateVersion++;
     Serial.println("[NOTIF] Initialized");
 }
 
@@ -1163,12 +2023,16 @@ int8_t notifAdd(const char* id, const char* text, const char* icon,
     }
 
     strlcpy(notif->text, text, sizeof(notif->text));
+    notif->textWidth = calculateTextWidth(notif->text);
     if (icon) {
         strlcpy(notif->icon, icon, sizeof(notif->icon));
     }
 
     notif->textColor = textColor;
     notif->backgroundColor = bgColor;
+    notif->textColorPanel = panelColorRGB(textColor);
+    notif->backgroundColorPanel = panelColorRGB(bgColor);
+    notif->textSignature = textStripSignature(notif->text, notif->textColorPanel, nullptr, 0);
     notif->duration = duration;
     notif->hold = hold;
     notif->urgent = urgent;
@@ -1177,6 +2041,7 @@ int8_t notifAdd(const char* id, const char* text, const char* icon,
     notif->displayedAt = 0;  // Not yet shown
 
     notificationCount++;
+    stateVersion++;
 
     // If urgent, force it to be picked up next
     if (urgent) {
@@ -1197,6 +2062,7 @@ bool notifDismiss() {
     notifications[currentNotifIndex].active = false;
     notificationCount--;
     currentNotifIndex = -1;
+    stateVersion++;
     return true;
 }
 
@@ -1206,6 +2072,7 @@ void notifClearAll() {
     }
     notificationCount = 0;
     currentNotifIndex = -1;
+    stateVersion++;
     Serial.println("[NOTIF] Cleared all");
 }
 
@@ -1216,26 +2083,33 @@ NotificationItem* notifGetCurrent() {
     return nullptr;
 }
 
-NotificationItem* notifGetNext() {
-    if (notificationCount == 0) return nullptr;
+// Index of the notification notifGetNext() would show (-1 if none)
+int8_t notifPeekNext() {
+    if (notificationCount == 0) return -1;
 
     // First pass: find urgent notifications not yet displayed
     for (uint8_t i = 0; i < MAX_NOTIFICATIONS; i++) {
         if (notifications[i].active && notifications[i].urgent && notifications[i].displayedAt == 0) {
-            currentNotifIndex = i;
-            return &notifications[i];
+            return i;
         }
     }
 
     // Second pass: find any active notification not yet displayed
     for (uint8_t i = 0; i < MAX_NOTIFICATIONS; i++) {
         if (notifications[i].active && notifications[i].displayedAt == 0) {
-            currentNotifIndex = i;
-            return &notifications[i];
+            return i;
         }
     }
 
-    return nullptr;
+    return -1;
+}
+
+NotificationItem* notifGetNext() {
+    int8_t idx = notifPeekNext();
+    if (idx < 0) return nullptr;
+    if (currentNotifIndex != idx) stateVersion++;
+    currentNotifIndex = idx;
+    return &notifications[idx];
 }
 
 bool notifIsExpired(NotificationItem* notif) {
@@ -1295,6 +2169,7 @@ void parseTextFieldWithSegments(JsonVariant field, char* textBuffer, size_t text
         if (!obj["color"].isNull()) {
             segments[0].offset = 0;
             segments[0].color = parseColorValue(obj["color"], defaultColor);
+            segments[0].colorPanel = panelColorRGB(segments[0].color);
             *segmentCount = 1;
         }
         return;
@@ -1314,6 +2189,7 @@ void parseTextFieldWithSegments(JsonVariant field, char* textBuffer, size_t text
             // Record segment offset and color
             segments[count].offset = (uint8_t)pos;
             segments[count].color = parseColorValue(seg["c"], defaultColor);
+            segments[count].colorPanel = panelColorRGB(segments[count].color);
             count++;
 
             // Concatenate text
@@ -1381,7 +2257,7 @@ void drawSparkline(const uint16_t* data, uint8_t count, int16_t x, int16_t y, in
         // Invert Y: high value = top of chart
         int16_t y0 = y + h - 1 - (int32_t)(data[i] - dataMin) * (h - 1) / dataRange;
         int16_t y1 = y + h - 1 - (int32_t)(data[i + 1] - dataMin) * (h - 1) / dataRange;
-        dma_display->drawLine(x0, y0, x1, y1, color);
+        canvas->drawLine(x0, y0, x1, y1, color);
     }
 }
 
@@ -1393,26 +2269,26 @@ void drawTrackerArrow(int16_t x, int16_t y, bool up, uint16_t color) {
         //   XXXXX
         //   ..X..
         //   ..X..
-        dma_display->drawPixel(x + 2, y,     color);
-        dma_display->drawPixel(x + 1, y + 1, color);
-        dma_display->drawPixel(x + 2, y + 1, color);
-        dma_display->drawPixel(x + 3, y + 1, color);
-        for (int16_t i = 0; i < 5; i++) dma_display->drawPixel(x + i, y + 2, color);
-        dma_display->drawPixel(x + 2, y + 3, color);
-        dma_display->drawPixel(x + 2, y + 4, color);
+        canvas->drawPixel(x + 2, y,     color);
+        canvas->drawPixel(x + 1, y + 1, color);
+        canvas->drawPixel(x + 2, y + 1, color);
+        canvas->drawPixel(x + 3, y + 1, color);
+        for (int16_t i = 0; i < 5; i++) canvas->drawPixel(x + i, y + 2, color);
+        canvas->drawPixel(x + 2, y + 3, color);
+        canvas->drawPixel(x + 2, y + 4, color);
     } else {
         //   ..X..
         //   ..X..
         //   XXXXX
         //   .XXX.
         //   ..X..
-        dma_display->drawPixel(x + 2, y,     color);
-        dma_display->drawPixel(x + 2, y + 1, color);
-        for (int16_t i = 0; i < 5; i++) dma_display->drawPixel(x + i, y + 2, color);
-        dma_display->drawPixel(x + 1, y + 3, color);
-        dma_display->drawPixel(x + 2, y + 3, color);
-        dma_display->drawPixel(x + 3, y + 3, color);
-        dma_display->drawPixel(x + 2, y + 4, color);
+        canvas->drawPixel(x + 2, y,     color);
+        canvas->drawPixel(x + 2, y + 1, color);
+        for (int16_t i = 0; i < 5; i++) canvas->drawPixel(x + i, y + 2, color);
+        canvas->drawPixel(x + 1, y + 3, color);
+        canvas->drawPixel(x + 2, y + 3, color);
+        canvas->drawPixel(x + 3, y + 3, color);
+        canvas->drawPixel(x + 2, y + 4, color);
     }
 }
 
@@ -1450,35 +2326,31 @@ void formatTrackerValue(float value, char* buffer, size_t bufSize) {
 
 // Display tracker layout on 64x64 matrix
 void displayShowTracker(TrackerData* tracker) {
+    RENDER_TIMED(TIMING_SHOW_TRACKER);
     if (!tracker) return;
 
-    dma_display->clearScreen();
+    canvas->fillScreen(0);
+    damageFullFrame();
 
     unsigned long trackerAge = millis() - tracker->lastUpdate;
     bool isStale = (trackerAge > TRACKER_STALE_TIMEOUT);
 
     // Color helpers
-    uint16_t white = dma_display->color565(255, 255, 255);
-    uint16_t dimWhite = isStale ? dma_display->color565(60, 60, 60) : dma_display->color565(150, 150, 150);
-    uint16_t dimGray = dma_display->color565(40, 40, 40);
-    uint16_t green = isStale ? dma_display->color565(0, 60, 0) : dma_display->color565(0, 200, 0);
-    uint16_t red = isStale ? dma_display->color565(60, 0, 0) : dma_display->color565(200, 0, 0);
-
-    uint8_t symR = (tracker->symbolColor >> 16) & 0xFF;
-    uint8_t symG = (tracker->symbolColor >> 8) & 0xFF;
-    uint8_t symB = tracker->symbolColor & 0xFF;
-    uint16_t symbolColor565 = isStale
-        ? dma_display->color565(symR / 4, symG / 4, symB / 4)
-        : dma_display->color565(symR, symG, symB);
+    uint16_t white = panelColor(255, 255, 255);
+    uint16_t dimWhite = isStale ? panelColor(60, 60, 60) : panelColor(150, 150, 150);
+    uint16_t dimGray = panelColor(40, 40, 40);
+    uint16_t green = isStale ? panelColor(0, 60, 0) : panelColor(0, 200, 0);
+    uint16_t red = isStale ? panelColor(60, 0, 0) : panelColor(200, 0, 0);
 
-    uint8_t spkR = (tracker->sparklineColor >> 16) & 0xFF;
-    uint8_t spkG = (tracker->sparklineColor >> 8) & 0xFF;
-    uint8_t spkB = tracker->sparklineColor & 0xFF;
+    // Stale data is drawn at a quarter of the configured color
+    uint16_t symbolColor565 = isStale
+        ? panelDim(tracker->symbolColorPanel, 64)
+        : tracker->symbolColorPanel;
     uint16_t sparklineColor565 = isStale
-        ? dma_display->color565(spkR / 4, spkG / 4, spkB / 4)
-        : dma_display->color565(spkR, spkG, spkB);
+        ? panelDim(tracker->sparklineColorPanel, 64)
+        : tracker->sparklineColorPanel;
 
-    uint16_t valueColor = isStale ? dma_display->color565(60, 60, 60) : white;
+    uint16_t valueColor = isStale ? panelColor(60, 60, 60) : white;
 
     // --- Row 1: Icon + Symbol (y=0..11) ---
     CachedIcon* icon = nullptr;
@@ -1491,27 +2363,27 @@ void displayShowTracker(TrackerData* tracker) {
     }
 
     // Symbol text at (13, 4) in symbolColor
-    dma_display->setFont(NULL);  // Default 5x7 font
-    dma_display->setTextSize(1);
-    dma_display->setTextColor(symbolColor565);
-    dma_display->setCursor(13, 4);
-    dma_display->print(tracker->symbol);
+    canvas->setFont(NULL);  // Default 5x7 font
+    canvas->setTextSize(1);
+    canvas->setTextColor(symbolColor565);
+    canvas->setCursor(13, 4);
+    canvas->print(tracker->symbol);
 
     // --- Row 2: Price value (y=14..22) ---
     char valueBuf[20];
     formatTrackerValue(tracker->currentValue, valueBuf, sizeof(valueBuf));
-    dma_display->setTextColor(valueColor);
-    dma_display->setCursor(2, 16);
-    dma_display->print(valueBuf);
+    canvas->setTextColor(valueColor);
+    canvas->setCursor(2, 16);
+    canvas->print(valueBuf);
 
     // Currency symbol right-aligned in TomThumb
     if (strlen(tracker->currencySymbol) > 0) {
-        dma_display->setFont(&TomThumb);
-        dma_display->setTextColor(dimWhite);
-        int16_t currWidth = strlen(tracker->currencySymbol) * 4;
-        dma_display->setCursor(62 - currWidth, 22);
-        dma_display->print(tracker->currencySymbol);
-        dma_display->setFont(NULL);  // Reset to default
+        canvas->setFont(&TomThumb);
+        canvas->setTextColor(dimWhite);
+        int16_t currWidth = fontTextWidth(&fontTomThumb, tracker->currencySymbol);
+        canvas->setCursor(62 - currWidth, 22);
+        canvas->print(tracker->currencySymbol);
+        canvas->setFont(NULL);  // Reset to default
     }
 
     // --- Row 3: Arrow + Change % (y=25..33) ---
@@ -1523,19 +2395,19 @@ void displayShowTracker(TrackerData* tracker) {
     char changeBuf[16];
     snprintf(changeBuf, sizeof(changeBuf), "%s%.2f%%",
              isPositive ? "+" : "", tracker->changePercent);
-    dma_display->setTextColor(changeColor);
-    dma_display->setCursor(9, 27);
-    dma_display->print(changeBuf);
+    canvas->setTextColor(changeColor);
+    canvas->setCursor(9, 27);
+    canvas->print(changeBuf);
 
     // --- Separator line (y=37) ---
     drawSeparatorLine(37, dimGray);
 
     // --- "24h" label right-aligned (y=39) ---
-    dma_display->setFont(&TomThumb);
-    dma_display->setTextColor(dimWhite);
-    dma_display->setCursor(51, 43);
-    dma_display->print("24h");
-    dma_display->setFont(NULL);
+    canvas->setFont(&TomThumb);
+    canvas->setTextColor(dimWhite);
+    canvas->setCursor(51, 43);
+    canvas->print("24h");
+    canvas->setFont(NULL);
 
     // --- Sparkline chart (y=40..53, x=2..61) ---
     if (tracker->sparklineCount >= 2) {
@@ -1548,33 +2420,32 @@ void displayShowTracker(TrackerData* tracker) {
 
     // --- Bottom text centered (y=57..63) ---
     if (strlen(tracker->bottomText) > 0) {
-        dma_display->setFont(&TomThumb);
-        dma_display->setTextColor(dimWhite);
-        int16_t textWidth = strlen(tracker->bottomText) * 4;
+        canvas->setFont(&TomThumb);
+        canvas->setTextColor(dimWhite);
+        int16_t textWidth = fontTextWidth(&fontTomThumb, tracker->bottomText);
         int16_t textX = (DISPLAY_WIDTH - textWidth) / 2;
-        dma_display->setCursor(textX, 62);
-        dma_display->print(tracker->bottomText);
-        dma_display->setFont(NULL);
+        canvas->setCursor(textX, 62);
+        canvas->print(tracker->bottomText);
+        canvas->setFont(NULL);
     }
 
     // --- Stale badge ---
     if (isStale) {
-        uint16_t staleRed = dma_display->color565(200, 0, 0);
-        dma_display->setFont(&TomThumb);
-        dma_display->setTextColor(staleRed);
-        dma_display->setCursor(42, 6);
-        dma_display->print("STALE");
-        dma_display->setFont(NULL);
+        uint16_t staleRed = panelColor(200, 0, 0);
+        canvas->setFont(&TomThumb);
+        canvas->setTextColor(staleRed);
+        canvas->setCursor(42, 6);
+        canvas->print("STALE");
+        canvas->setFont(NULL);
     }
 
     drawIndicators();
 
-    #if DOUBLE_BUFFER
-        dma_display->flipDMABuffer();
-    #endif
+    displayFlush();
 }
 
 void displayShowWeatherClock(uint16_t appDuration) {
+    RENDER_TIMED(TIMING_SHOW_WEATHERCLOCK);
     // Fallback to time display if weather data is stale or missing
     unsigned long weatherAge = millis() - weatherData.lastUpdate;
     if (!weatherData.valid || weatherAge > 3600000) {
@@ -1584,6 +2455,7 @@ void displayShowWeatherClock(uint16_t appDuration) {
 
     // Use global weatherLastDrawnMinute / weatherLastUpdateDrawn
     // (reset by displayShowApp on app switch to force full redraw)
+    damageBegin(DAMAGE_LAYOUT_WEATHER, 0);
 
     time_t nowUtc = time(nullptr);
     struct tm localTm;
@@ -1596,8 +2468,8 @@ void displayShowWeatherClock(uint16_t appDuration) {
         hours -= 12;
     }
 
-    bool needsFullRedraw = (weatherLastDrawnMinute != minutes) ||
-                           (weatherLastUpdateDrawn != weatherData.lastUpdate);
+    bool headerChanged = (weatherLastDrawnMinute != minutes) ||
+                         (weatherLastUpdateDrawn != weatherData.lastUpdate);
 
     // Forecast pagination
     uint8_t forecastPageCount = max((uint8_t)1,
@@ -1614,17 +2486,28 @@ void displayShowWeatherClock(uint16_t appDuration) {
         }
     }
 
-    bool needsForecastRedraw = needsFullRedraw || pageChanged;
+    // Sections: header (y=0-10), clock (y=11-20), date (y=21-31), forecast (y=32-63)
+    if (headerChanged) {
+        damageAdd(0, 0, DISPLAY_WIDTH, 11);
+        damageAdd(0, 21, DISPLAY_WIDTH, 11);
+    }
+    if (headerChanged || pageChanged) {
+        damageAdd(0, 32, DISPLAY_WIDTH, 32);
+    }
+    damageAdd(0, 11, DISPLAY_WIDTH, 10);  // Clock redrawn every second
+    damageClear();
+
+    bool needsFullRedraw = damageIntersects(0, 0, DISPLAY_WIDTH, 11) ||
+                           damageIntersects(0, 21, DISPLAY_WIDTH, 11);
+    bool needsForecastRedraw = damageIntersects(0, 32, DISPLAY_WIDTH, 32);
 
-    uint16_t white = dma_display->color565(255, 255, 255);
-    uint16_t dimGray = dma_display->color565(40, 40, 40);
-    uint16_t cyan = dma_display->color565(0, 180, 255);
-    uint16_t mintGreen = dma_display->color565(100, 255, 180);
-    uint16_t gray = dma_display->color565(140, 140, 140);
-    uint16_t coral = dma_display->color565(255, 140, 100);
-    uint16_t coldBlue = dma_display->color565(80, 140, 255);
-    uint16_t warmRed = dma_display->color565(255, 50, 30);
-    uint16_t black = dma_display->color565(0, 0, 0);
+    uint16_t white = panelColor(255, 255, 255);
+    uint16_t dimGray = panelColor(40, 40, 40);
+    uint16_t mintGreen = panelColor(100, 255, 180);
+    uint16_t gray = panelColor(140, 140, 140);
+    uint16_t coral = panelColor(255, 140, 100);
+    uint16_t coldBlue = panelColor(80, 140, 255);
+    uint16_t warmRed = panelColor(255, 50, 30);
 
     // ============================================================
     // Layout map (64x64 display)
@@ -1644,73 +2527,60 @@ void displayShowWeatherClock(uint16_t appDuration) {
     // ============================================================
 
     if (needsFullRedraw) {
-        // Clear and redraw each section individually to avoid full-screen flicker
+        // Damaged sections were cleared above, redraw without full-screen flicker
 
         // ---- Current weather (y=0-10) ----
-        dma_display->fillRect(0, 0, DISPLAY_WIDTH, 11, black);
         int16_t weatherTextX = 2;
-        const uint16_t* builtinCurrentIcon = getBuiltinWeatherIcon(weatherData.currentIcon);
-        if (builtinCurrentIcon) {
-            drawProgmemIcon(dma_display, builtinCurrentIcon, 1, 1, 1);
+        CachedIcon* currentIcon = getIcon(weatherData.currentIcon);
+        if (currentIcon && currentIcon->valid) {
+            drawIconAtScale(currentIcon, 1, 1, 1);
             weatherTextX = 11;
-        } else {
-            CachedIcon* currentIcon = getIcon(weatherData.currentIcon);
-            if (currentIcon && currentIcon->valid) {
-                drawIconAtScale(currentIcon, 1, 1, 1);
-                weatherTextX = 11;
-            }
         }
 
         // Temperature (NULL font, top at y=2 to align with icon)
-        dma_display->setFont(NULL);
-        dma_display->setTextSize(1);
-        dma_display->setTextColor(white);
+        canvas->setFont(NULL);
+        canvas->setTextSize(1);
+        canvas->setTextColor(white);
 
         char tempStr[8];
         snprintf(tempStr, sizeof(tempStr), "%d", weatherData.currentTemp);
-        dma_display->setCursor(weatherTextX, 2);
-        dma_display->print(tempStr);
+        canvas->setCursor(weatherTextX, 2);
+        canvas->print(tempStr);
 
         // Degree symbol (small circle, superscript position)
-        int16_t degreeX = weatherTextX + strlen(tempStr) * 6;
-        dma_display->drawPixel(degreeX + 1, 1, white);
-        dma_display->drawPixel(degreeX,     2, white);
-        dma_display->drawPixel(degreeX + 2, 2, white);
-        dma_display->drawPixel(degreeX + 1, 3, white);
+        int16_t degreeX = weatherTextX + fontTextWidth(&fontDefault, tempStr);
+        drawDegreeSign(canvas, degreeX, 1, white);
 
         // "C" after degree (NULL font, same top as temp)
-        int16_t cX = degreeX + 4;
-        dma_display->setCursor(cX, 2);
-        dma_display->print("C");
+        int16_t cX = degreeX + TEXT_DEGREE_WIDTH;
+        canvas->setCursor(cX, 2);
+        canvas->print("C");
 
         // Today's min/max on right side (NULL font, right-aligned)
         char todayMinStr[8], todayMaxStr[8];
         snprintf(todayMinStr, sizeof(todayMinStr), "%d", weatherData.currentTempMin);
         snprintf(todayMaxStr, sizeof(todayMaxStr), "%d", weatherData.currentTempMax);
-        int16_t todayMinW = strlen(todayMinStr) * 4;
-        int16_t todaySlashW = 4;
-        int16_t todayMaxW = strlen(todayMaxStr) * 4;
+        int16_t todayMinW = fontTextWidth(&fontTomThumb, todayMinStr);
+        int16_t todaySlashW = fontTextWidth(&fontTomThumb, "/");
+        int16_t todayMaxW = fontTextWidth(&fontTomThumb, todayMaxStr);
         int16_t todayTotalW = todayMinW + todaySlashW + todayMaxW;
         int16_t todayX = DISPLAY_WIDTH - todayTotalW - 1;
 
-        dma_display->setFont(&TomThumb);
-        dma_display->setTextColor(coldBlue);
-        dma_display->setCursor(todayX, 8);
-        dma_display->print(todayMinStr);
-        dma_display->setTextColor(gray);
-        dma_display->setCursor(todayX + todayMinW, 8);
-        dma_display->print("/");
-        dma_display->setTextColor(warmRed);
-        dma_display->setCursor(todayX + todayMinW + todaySlashW, 8);
-        dma_display->print(todayMaxStr);
+        canvas->setFont(&TomThumb);
+        canvas->setTextColor(coldBlue);
+        canvas->setCursor(todayX, 8);
+        canvas->print(todayMinStr);
+        canvas->setTextColor(gray);
+        canvas->setCursor(todayX + todayMinW, 8);
+        canvas->print("/");
+        canvas->setTextColor(warmRed);
+        canvas->setCursor(todayX + todayMinW + todaySlashW, 8);
+        canvas->print(todayMaxStr);
 
         // ---- Separator (y=10) ----
-        dma_display->fillRect(0, 10, DISPLAY_WIDTH, 1, black);
         drawSeparatorLine(10, dimGray);
 
         // ---- Date (y=21-30) ----
-        dma_display->fillRect(0, 21, DISPLAY_WIDTH, 10, black);
-
         static const char* dayNamesFr[] = {"DIM", "LUN", "MAR", "MER", "JEU", "VEN", "SAM"};
         static const char* monthNamesFr[] = {"JAN", "FEV", "MAR", "AVR", "MAI", "JUN",
                                              "JUL", "AOU", "SEP", "OCT", "NOV", "DEC"};
@@ -1721,14 +2591,14 @@ void displayShowWeatherClock(uint16_t appDuration) {
                  localTm.tm_mday,
                  monthNamesFr[localTm.tm_mon]);
 
-        dma_display->setFont(NULL);
-        dma_display->setTextSize(1);
-        dma_display->setTextColor(gray);
+        canvas->setFont(NULL);
+        canvas->setTextSize(1);
+        canvas->setTextColor(gray);
 
-        int16_t dateWidth = strlen(dateStr) * 6;
+        int16_t dateWidth = fontTextWidth(&fontDefault, dateStr);
         int16_t dateX = (DISPLAY_WIDTH - dateWidth) / 2;
-        dma_display->setCursor(dateX, 22);
-        dma_display->print(dateStr);
+        canvas->setCursor(dateX, 22);
+        canvas->print(dateStr);
 
         // ---- Separator (y=31) ----
         drawSeparatorLine(31, dimGray);
@@ -1739,8 +2609,6 @@ void displayShowWeatherClock(uint16_t appDuration) {
 
     // ---- Forecast (y=33-63) - redrawn on full redraw or page change ----
     if (needsForecastRedraw) {
-        dma_display->fillRect(0, 32, DISPLAY_WIDTH, 32, black);
-
         // Compute which forecast days to display on the current page
         uint8_t pageStart = forecastPage * FORECAST_COLUMNS;
         uint8_t displayCount = min((uint8_t)FORECAST_COLUMNS,
@@ -1760,44 +2628,39 @@ void displayShowWeatherClock(uint16_t appDuration) {
             }
 
             // Day name (TomThumb baseline=39, glyphs y=34-38)
-            dma_display->setFont(&TomThumb);
-            dma_display->setTextColor(coral);
-            int16_t dayNameWidth = strlen(weatherData.forecast[forecastIndex].dayName) * 4;
-            dma_display->setCursor(colCenter - dayNameWidth / 2, 39);
-            dma_display->print(weatherData.forecast[forecastIndex].dayName);
+            canvas->setFont(&TomThumb);
+            canvas->setTextColor(coral);
+            int16_t dayNameWidth = fontTextWidth(&fontTomThumb, weatherData.forecast[forecastIndex].dayName);
+            canvas->setCursor(colCenter - dayNameWidth / 2, 39);
+            canvas->print(weatherData.forecast[forecastIndex].dayName);
 
             // Forecast icon (8x8 native, y=41-48)
-            const uint16_t* builtinForecastIcon = getBuiltinWeatherIcon(weatherData.forecast[forecastIndex].icon);
-            if (builtinForecastIcon) {
-                drawProgmemIcon(dma_display, builtinForecastIcon, colCenter - 4, 41, 1);
-            } else {
-                CachedIcon* forecastIcon = getIcon(weatherData.forecast[forecastIndex].icon);
-                if (forecastIcon && forecastIcon->valid) {
-                    drawIconAtScale(forecastIcon, colCenter - 4, 41, 1);
-                }
+            CachedIcon* forecastIcon = getIcon(weatherData.forecast[forecastIndex].icon);
+            if (forecastIcon && forecastIcon->valid) {
+                drawIconAtScale(forecastIcon, colCenter - 4, 41, 1);
             }
 
             // Min temp in blue (TomThumb baseline=56, glyphs y=51-55)
             char minStr[8];
             snprintf(minStr, sizeof(minStr), "%d", weatherData.forecast[forecastIndex].tempMin);
-            dma_display->setFont(&TomThumb);
-            dma_display->setTextColor(coldBlue);
-            int16_t minWidth = strlen(minStr) * 4;
-            dma_display->setCursor(colCenter - minWidth / 2, 56);
-            dma_display->print(minStr);
+            canvas->setFont(&TomThumb);
+            canvas->setTextColor(coldBlue);
+            int16_t minWidth = fontTextWidth(&fontTomThumb, minStr);
+            canvas->setCursor(colCenter - minWidth / 2, 56);
+            canvas->print(minStr);
 
             // Max temp in red (TomThumb baseline=63, glyphs y=58-62)
             char maxStr[8];
             snprintf(maxStr, sizeof(maxStr), "%d", weatherData.forecast[forecastIndex].tempMax);
-            dma_display->setTextColor(warmRed);
-            int16_t maxWidth = strlen(maxStr) * 4;
-            dma_display->setCursor(colCenter - maxWidth / 2, 63);
-            dma_display->print(maxStr);
+            canvas->setTextColor(warmRed);
+            int16_t maxWidth = fontTextWidth(&fontTomThumb, maxStr);
+            canvas->setCursor(colCenter - maxWidth / 2, 63);
+            canvas->print(maxStr);
         }
 
         // Page indicator squares (vertical, right edge, just below second separator)
         if (forecastPageCount > 1) {
-            uint16_t activeDot = dma_display->color565(120, 60, 200);  // Dark violet
+            uint16_t activeDot = panelColor(120, 60, 200);  // Dark violet
             int squareSize = 2;
             int gap = 1;
             int step = squareSize + gap;  // 3px per indicator
@@ -1805,56 +2668,53 @@ void displayShowWeatherClock(uint16_t appDuration) {
             int dotStartY = 33;          // Just below separator at y=31
             for (int d = 0; d < forecastPageCount; d++) {
                 uint16_t dotColor = (d == forecastPage) ? activeDot : dimGray;
-                dma_display->fillRect(dotX, dotStartY + d * step, squareSize, squareSize, dotColor);
+                canvas->fillRect(dotX, dotStartY + d * step, squareSize, squareSize, dotColor);
             }
         }
     }
 
-    // ---- Clock (y=13-20) - redrawn every second ----
-    // Clear only the clock region (y=11 to y=20) to avoid full-screen flicker
-    dma_display->fillRect(0, 11, DISPLAY_WIDTH, 10, black);
-
-    dma_display->setTextColor(mintGreen);
+    // ---- Clock (y=13-20) - redrawn every second (region cleared above) ----
+    canvas->setTextColor(mintGreen);
 
     // HH:MM in NULL font (5 chars * 6px = 30px)
     char hmStr[6];
     snprintf(hmStr, sizeof(hmStr), "%02d:%02d", hours, minutes);
-    dma_display->setFont(NULL);
-    dma_display->setTextSize(1);
+    canvas->setFont(NULL);
+    canvas->setTextSize(1);
 
     int16_t hmX = (DISPLAY_WIDTH - 30) / 2 - 6;  // Shift left for seconds
-    dma_display->setCursor(hmX, 13);
-    dma_display->print(hmStr);
+    canvas->setCursor(hmX, 13);
+    canvas->print(hmStr);
 
     // Seconds in TomThumb (baseline=20, bottom-aligned with NULL font y=13+6=19)
-    dma_display->setFont(&TomThumb);
+    canvas->setFont(&TomThumb);
     char secStr[4];
     snprintf(secStr, sizeof(secStr), ":%02d", seconds);
-    dma_display->setCursor(hmX + 31, 20);
-    dma_display->print(secStr);
+    canvas->setCursor(hmX + 31, 20);
+    canvas->print(secStr);
 
     // Reset font
-    dma_display->setFont(NULL);
+    canvas->setFont(NULL);
 
     drawIndicators();
+    damageEnd();
 
-    #if DOUBLE_BUFFER
-        dma_display->flipDMABuffer();
-    #endif
+    displayFlush();
 }
 
 void displayShowApp(AppItem* app) {
+    RENDER_TIMED(TIMING_SHOW_APP);
     if (!app) return;
+    iconPass++;
 
     // Detect app switch and clear screen to prevent ghosting
-    int8_t appIndex = appFind(app->id);
+    int8_t appIndex = app - apps;
     if (appIndex != lastDisplayedAppIndex) {
-        dma_display->clearScreen();
-        #if DOUBLE_BUFFER
-            dma_display->flipDMABuffer();
-            dma_display->clearScreen();
-        #endif
+        canvas->fillScreen(0);
+        damageInvalidate();
         lastDisplayedAppIndex = appIndex;
+        // Keep the GIF decoder allocated only if the incoming app needs it
+        gifStop(app->gif[0] == '\0');
         // Reset weather display cache to force full redraw
         weatherLastDrawnMinute = -1;
         weatherLastUpdateDrawn = 0;
@@ -1864,23 +2724,22 @@ void displayShowApp(AppItem* app) {
     }
 
     // Handle system apps
-    if (strcmp(app->id, "clock") == 0) {
-        displayShowTime();
-        return;
-    }
-
-    if (strcmp(app->id, "date") == 0) {
-        displayShowDate();
-        return;
-    }
-
-    if (strcmp(app->id, "weatherclock") == 0) {
-        displayShowWeatherClock(app->duration);
-        return;
+    switch (app->kind) {
+        case APP_KIND_CLOCK:
+            displayShowTime();
+            return;
+        case APP_KIND_DATE:
+            displayShowDate();
+            return;
+        case APP_KIND_WEATHERCLOCK:
+            displayShowWeatherClock(app->duration);
+            return;
+        default:
+            break;
     }
 
     // Tracker layout apps (ID starts with "tracker_")
-    if (strncmp(app->id, TRACKER_ID_PREFIX, strlen(TRACKER_ID_PREFIX)) == 0) {
+    if (app->kind == APP_KIND_TRACKER) {
         const char* trackerName = app->id + strlen(TRACKER_ID_PREFIX);
         TrackerData* tracker = trackerFind(trackerName);
         if (tracker && tracker->valid) {
@@ -1890,6 +2749,11 @@ void displayShowApp(AppItem* app) {
         // Fallback to default custom app layout if no data
     }
 
+    // GIF apps, falling back to the custom layout if the animation cannot play
+    if (app->gif[0] != '\0' && displayShowGif(app, appIndex)) {
+        return;
+    }
+
     // Multi-zone layout apps
     if (app->zoneCount >= 2) {
         displayShowMultiZone(app);
@@ -1897,7 +2761,6 @@ void displayShowApp(AppItem* app) {
     }
 
     // Custom apps (single-zone)
-    dma_display->clearScreen();
 
     // Layout calculation - VERTICAL layout for 64x64 panel
     // +----------64px-----------+
@@ -1913,30 +2776,32 @@ void displayShowApp(AppItem* app) {
 
     // Try to load icon if specified
     CachedIcon* icon = nullptr;
-    if (strlen(app->icon) > 0) {
-        icon = getIcon(app->icon);
+    if (app->iconHash) {
+        icon = getIconHashed(app->icon, app->iconHash);
     }
 
     // Adjust layout if icon is present - VERTICAL layout
+    int16_t iconX = 0;
+    int16_t iconY = 2;  // 2px from top
+    uint8_t iconDisplayW = 0;
+    uint8_t iconDisplayH = 0;
     if (icon && icon->valid) {
         // Calculate displayed size (upscale x2 for 8x8 icons)
         uint8_t scale = (icon->width <= 8 && icon->height <= 8) ? 2 : 1;
-        uint8_t displayWidth = icon->width * scale;
-        uint8_t displayHeight = icon->height * scale;
+        iconDisplayW = icon->width * scale;
+        iconDisplayH = icon->height * scale;
 
-        // Draw icon centered horizontally at top
-        int16_t iconX = (DISPLAY_WIDTH - displayWidth) / 2;
-        int16_t iconY = 2;  // 2px from top
-        drawIcon(icon, iconX, iconY);
+        // Icon centered horizontally at top
+        iconX = (DISPLAY_WIDTH - iconDisplayW) / 2;
 
         // Text starts below icon with gap
-        textYPos = iconY + displayHeight + 6;  // 6px gap below icon
+        textYPos = iconY + iconDisplayH + 6;  // 6px gap below icon
+    } else {
+        icon = nullptr;
     }
 
-    dma_display->setTextSize(1);
-
-    // Calculate text width and check if scrolling needed
-    int16_t textWidth = calculateTextWidth(app->text);
+    // Cached text width, check if scrolling needed
+    int16_t textWidth = app->textWidth;
     bool needsScroll = textWidth > textAreaWidth;
 
     // Update scroll state if this is new text or scroll requirements changed
@@ -1956,25 +2821,337 @@ void displayShowApp(AppItem* app) {
         xPos = textAreaX - appScrollState.scrollOffset;
     }
 
-    // Draw text with segment-aware coloring
-    printTextWithSegments(app->text, xPos, textYPos, app->textColor,
-                          app->textSegments, app->textSegmentCount);
+    // Text band spans the full width; degree symbols sit 6px above the cursor
+    int16_t textBandY = textYPos - 6;
+    int16_t textBandH = 14;
 
-    // Draw label below text if present (TomThumb font, dimmed color)
-    if (app->label[0] != '\0') {
-        int16_t labelWidth = strlen(app->label) * 4;
-        int16_t labelX = (DISPLAY_WIDTH - labelWidth) / 2;
-        if (labelX < 2) labelX = 2;
-        int16_t labelY = textYPos + 12;
-        printLabelWithSegments(app->label, labelX, labelY, app->textColor,
-                               app->labelSegments, app->labelSegmentCount, true);
+    // Label below text (TomThumb baseline, glyphs ~5px above)
+    int16_t labelWidth = app->labelWidth;
+    int16_t labelX = (DISPLAY_WIDTH - labelWidth) / 2;
+    if (labelX < 2) labelX = 2;
+    int16_t labelY = textYPos + 12;
+
+    // Any content change redraws the whole app, scrolling only dirties the text band
+    uint32_t signature = damageHash(app->signature, &appIndex, sizeof(appIndex));
+    signature = damageHash(signature, &icon, sizeof(icon));
+    damageBegin(DAMAGE_LAYOUT_APP, signature);
+
+    if (xPos != appLastDrawnTextX) {
+        damageAdd(0, textBandY, DISPLAY_WIDTH, textBandH);
+        appLastDrawnTextX = xPos;
+    }
+    if (icon && icon->frame != appLastDrawnIconFrame) {
+        damageAdd(iconX, iconY, iconDisplayW, iconDisplayH);
+        appLastDrawnIconFrame = icon->frame;
     }
 
-    drawIndicators();
+    damageClear();
 
-    #if DOUBLE_BUFFER
-        dma_display->flipDMABuffer();
-    #endif
+    if (icon && damageIntersects(iconX, iconY, iconDisplayW, iconDisplayH)) {
+        drawIcon(icon, iconX, iconY);
+    }
+
+    canvas->setTextSize(1);
+
+    // Draw text with segment-aware coloring (pre-rendered strip, direct draw as fallback)
+    if (damageIntersects(0, textBandY, DISPLAY_WIDTH, textBandH)) {
+        TextStripCanvas* strip = textStripPrepare(&appTextStrip, app->textSignature, app->text,
+                                                  app->textColorPanel, app->textSegments,
+                                                  app->textSegmentCount);
+        if (strip) {
+            drawTextStrip(canvas, strip, xPos, textYPos);
+        } else {
+            printTextWithSegments(canvas, app->text, xPos, textYPos, app->textColorPanel,
+                                  app->textSegments, app->textSegmentCount);
+        }
+    }
+
+    // Draw label below text if present (TomThumb font, dimmed color)
+    if (app->label[0] != '\0' && damageIntersects(labelX, labelY - 5, labelWidth, 7)) {
+        printLabelWithSegments(app->label, labelX, labelY, app->textColorPanel,
+                               app->labelSegments, app->labelSegmentCount, true);
+    }
+
+    drawIndicators();
+    damageEnd();
+
+    displayFlush();
+}
+
+// ============================================================================
+// GIF Playback
+// ============================================================================
+
+// LittleFS file callbacks, shared by the GIF and PNG decoders
+static void* lfsFileOpen(const char* path, int32_t* size) {
+    File* file = new File(LittleFS.open(path, "r"));
+    if (!*file) {
+        delete file;
+        return nullptr;
+    }
+    *size = file->size();
+    return file;
+}
+
+static void lfsFileClose(void* handle) {
+    File* file = (File*)handle;
+    if (file) {
+        file->close();
+        delete file;
+    }
+}
+
+static int32_t gifFileRead(GIFFILE* gifFile, uint8_t* buffer, int32_t length) {
+    File* file = (File*)gifFile->fHandle;
+    int32_t remaining = gifFile->iSize - gifFile->iPos;
+    if (length > remaining) length = remaining;
+    if (length <= 0) return 0;
+    int32_t bytesRead = file->read(buffer, length);
+    gifFile->iPos = file->position();
+    return bytesRead;
+}
+
+static int32_t gifFileSeek(GIFFILE* gifFile, int32_t position) {
+    File* file = (File*)gifFile->fHandle;
+    file->seek(position);
+    gifFile->iPos = file->position();
+    return gifFile->iPos;
+}
+
+// Pack a new frame's palette once instead of converting every pixel.
+// The global color table is only packed again after a local one.
+static void gifPackPalette(const GIFDRAW* pDraw, uint16_t* palette, bool* globalReady) {
+    if (pDraw->ucIsGlobalPalette && *globalReady) return;
+    const uint8_t* rgb = pDraw->pPalette24;
+    for (uint16_t i = 0; i < 256; i++, rgb += 3) {
+        palette[i] = panelColor(rgb[0], rgb[1], rgb[2]);
+    }
+    *globalReady = pDraw->ucIsGlobalPalette;
+}
+
+// Copy `width` decoded pixels, leaving transparent ones untouched
+static void gifBlitLine(const GIFDRAW* pDraw, const uint8_t* src, const uint16_t* palette,
+                        uint16_t* dst, int16_t width) {
+    if (pDraw->ucHasTransparency) {
+        uint8_t transparent = pDraw->ucTransparent;
+        for (int16_t i = 0; i < width; i++) {
+            if (src[i] != transparent) dst[i] = palette[src[i]];
+        }
+    } else {
+        for (int16_t i = 0; i < width; i++) {
+            dst[i] = palette[src[i]];
+        }
+    }
+}
+
+static AnimatedGIF* gifAllocDecoder() {
+    // Refuse to start rather than starve the network stack
+    uint32_t largestBlock = ESP.getMaxAllocHeap();
+    if (largestBlock < sizeof(AnimatedGIF) + GIF_HEAP_RESERVE) {
+        Serial.printf("[GIF] Not enough memory for decoder (%u bytes, largest block %u)\n",
+                      (unsigned)sizeof(AnimatedGIF), largestBlock);
+        return nullptr;
+    }
+    AnimatedGIF* decoder = new (std::nothrow) AnimatedGIF;
+    if (!decoder) {
+        Serial.println("[GIF] Decoder allocation failed");
+        return nullptr;
+    }
+    decoder->begin(GIF_PALETTE_RGB888);
+    return decoder;
+}
+
+// Called once per decoded line, writes it straight into the canvas
+static void gifDrawLine(GIFDRAW* pDraw) {
+    GifPlayer& player = gifPlayer;
+
+    if (pDraw->y == 0) {
+        gifPackPalette(pDraw, player.palette, &player.globalPaletteReady);
+        player.frameRect = { (int16_t)(player.offsetX + pDraw->iX), (int16_t)(player.offsetY + pDraw->iY),
+                             (int16_t)pDraw->iWidth, (int16_t)pDraw->iHeight };
+        player.frameDisposal = pDraw->ucDisposalMethod;
+        damageAdd(player.frameRect.x, player.frameRect.y, player.frameRect.w, player.frameRect.h);
+    }
+
+    int16_t y = player.offsetY + pDraw->iY + pDraw->y;
+    if (y < 0 || y >= DISPLAY_HEIGHT) return;
+    int16_t x = player.offsetX + pDraw->iX;
+    int16_t width = pDraw->iWidth;
+    const uint8_t* src = pDraw->pPixels;
+    if (x < 0) { src -= x; width += x; x = 0; }
+    if (x + width > DISPLAY_WIDTH) width = DISPLAY_WIDTH - x;
+    if (width <= 0) return;
+
+    gifBlitLine(pDraw, src, player.palette, canvas->getBuffer() + y * DISPLAY_WIDTH + x, width);
+}
+
+// Animations live in /gifs, animated icons uploaded to /icons work too
+static bool gifResolvePath(const char* name, char* path, size_t len) {
+    snprintf(path, len, "%s/%s.gif", FS_GIFS_PATH, name);
+    if (LittleFS.exists(path)) return true;
+    snprintf(path, len, "%s/%s.gif", FS_ICONS_PATH, name);
+    return LittleFS.exists(path);
+}
+
+// Close the open animation; the decoder itself is freed only on request
+void gifStop(bool releaseDecoder) {
+    GifPlayer& player = gifPlayer;
+    if (player.open) {
+        player.decoder->close();
+        player.open = false;
+    }
+    player.failed = false;
+    if (releaseDecoder && player.decoder) {
+        delete player.decoder;
+        player.decoder = nullptr;
+        Serial.println("[GIF] Decoder released");
+    }
+}
+
+static bool gifOpen(const char* name) {
+    GifPlayer& player = gifPlayer;
+    gifStop(false);
+
+    if (!player.decoder) {
+        player.decoder = gifAllocDecoder();
+        if (!player.decoder) return false;
+    }
+
+    char path[48];
+    if (!gifResolvePath(name, path, sizeof(path))) {
+        Serial.printf("[GIF] Animation not found: %s\n", name);
+        return false;
+    }
+
+    if (!player.decoder->open(path, lfsFileOpen, lfsFileClose, gifFileRead, gifFileSeek, gifDrawLine)) {
+        Serial.printf("[GIF] Failed to open %s (error %d)\n", path, player.decoder->getLastError());
+        return false;
+    }
+    player.open = true;
+
+    int16_t width = player.decoder->getCanvasWidth();
+    int16_t height = player.decoder->getCanvasHeight();
+    if (width > DISPLAY_WIDTH || height > DISPLAY_HEIGHT) {
+        Serial.printf("[GIF] %s is %dx%d, larger than the display\n", path, width, height);
+        gifStop(false);
+        return false;
+    }
+
+    player.offsetX = (DISPLAY_WIDTH - width) / 2;
+    player.offsetY = (DISPLAY_HEIGHT - height) / 2;
+    player.globalPaletteReady = false;
+    player.frameDisposal = 0;
+    Serial.printf("[GIF] Playing %s (%dx%d)\n", path, width, height);
+    return true;
+}
+
+// Decode the next frame over the previous one and schedule the one after.
+// DISPOSE_PREVIOUS is handled like "none": restoring it would need a copy
+// of the frame area, which the memory budget does not allow.
+static void gifPlayFrame(unsigned long now) {
+    RENDER_TIMED(TIMING_GIF_FRAME);
+    GifPlayer& player = gifPlayer;
+
+    if (player.frameDisposal == DISPOSE_BACKGROUND) {
+        const DirtyRect& r = player.frameRect;
+        canvas->fillRect(r.x, r.y, r.w, r.h, 0);
+        damageAdd(r.x, r.y, r.w, r.h);
+    }
+    player.frameDisposal = 0;
+
+    // Returns 0 after the last frame, the decoder rewinds by itself
+    int delayMs = 0;
+    if (player.decoder->playFrame(false, &delayMs) < 0) {
+        Serial.printf("[GIF] Decode error %d\n", player.decoder->getLastError());
+        gifStop(false);
+        player.failed = true;
+        return;
+    }
+    player.frames++;
+
+    if (delayMs < GIF_MIN_FRAME_DELAY) delayMs = GIF_DEFAULT_FRAME_DELAY;
+
+    // Frames stay on a timeline anchored on the first one so per-frame
+    // delays are honored on average. When decoding falls more than a frame
+    // behind, restart the timeline instead of bursting to catch up.
+    player.nextFrameAt += delayMs;
+    if ((long)(now - player.nextFrameAt) >= 0) {
+        player.nextFrameAt = now + delayMs;
+        player.lateFrames++;
+    }
+}
+
+// The animation under the indicator corners, kept after each decoded frame
+// so a corner an indicator leaves (blink, fade, turned off) shows the GIF
+// again instead of black
+static void gifSaveCorners() {
+    const uint16_t* buffer = canvas->getBuffer();
+    for (uint8_t i = 0; i < NUM_INDICATORS; i++) {
+        int16_t x, y;
+        indicatorOrigin(i, &x, &y);
+        for (int16_t row = 0; row < INDICATOR_FOOTPRINT; row++) {
+            memcpy(gifPlayer.corners[i] + row * INDICATOR_FOOTPRINT,
+                   buffer + (y + row) * DISPLAY_WIDTH + x, INDICATOR_FOOTPRINT * sizeof(uint16_t));
+        }
+    }
+}
+
+static void gifRestoreCorners() {
+    uint16_t* buffer = canvas->getBuffer();
+    for (uint8_t i = 0; i < NUM_INDICATORS; i++) {
+        int16_t x, y;
+        indicatorOrigin(i, &x, &y);
+        for (int16_t row = 0; row < INDICATOR_FOOTPRINT; row++) {
+            memcpy(buffer + (y + row) * DISPLAY_WIDTH + x,
+                   gifPlayer.corners[i] + row * INDICATOR_FOOTPRINT, INDICATOR_FOOTPRINT * sizeof(uint16_t));
+        }
+    }
+}
+
+bool gifFrameDue(unsigned long now) {
+    return gifPlayer.open && (long)(now - gifPlayer.nextFrameAt) >= 0;
+}
+
+// Full redraws (app switch, after a notification...) restart the animation,
+// later calls only decode a frame when it is due. Returns false when the
+// animation cannot be played.
+bool displayShowGif(AppItem* app, int8_t appIndex) {
+    GifPlayer& player = gifPlayer;
+
+    uint32_t signature = damageHash(DAMAGE_HASH_SEED, &appIndex, sizeof(appIndex));
+    signature = damageHash(signature, app->gif, strlen(app->gif) + 1);
+    if (player.failed && player.signature == signature) return false;
+
+    unsigned long now = millis();
+    if (damageBegin(DAMAGE_LAYOUT_GIF, signature)) {
+        canvas->fillScreen(0);
+        if (player.open && player.signature == signature) {
+            player.decoder->reset();
+        } else if (!gifOpen(app->gif)) {
+            player.signature = signature;
+            player.failed = true;
+            damageInvalidate();
+            return false;
+        }
+        player.signature = signature;
+        player.frameDisposal = 0;
+        player.nextFrameAt = now;
+        gifPlayFrame(now);
+        gifSaveCorners();
+    } else {
+        // Only indicator corners can be dirty here, the GIF owns the rest.
+        // Put the animation back under them before the indicators redraw.
+        gifRestoreCorners();
+        if (gifFrameDue(now)) {
+            gifPlayFrame(now);
+            gifSaveCorners();
+        }
+    }
+
+    drawIndicators();
+    damageEnd();
+    displayFlush();
+    return true;
 }
 
 // ============================================================================
@@ -1985,12 +3162,12 @@ void displayShowApp(AppItem* app) {
 void displayShowZone(AppZone* zone, int16_t x, int16_t y, int16_t w, int16_t h) {
     if (!zone) return;
 
-    dma_display->setTextSize(1);
+    canvas->setTextSize(1);
 
     // Try to load icon
     CachedIcon* icon = nullptr;
-    if (strlen(zone->icon) > 0) {
-        icon = getIcon(zone->icon);
+    if (zone->iconHash) {
+        icon = getIconHashed(zone->icon, zone->iconHash);
     }
 
     bool isFullWidth = (w >= 48);
@@ -2026,20 +3203,20 @@ void displayShowZone(AppZone* zone, int16_t x, int16_t y, int16_t w, int16_t h)
 
         // Truncate text to fit available width
         int16_t availableWidth = (x + w) - textX;
-        int16_t maxChars = availableWidth / 6;  // 6px per char (5x7 font + 1px spacing)
         char truncatedText[32];
         strlcpy(truncatedText, zone->text, sizeof(truncatedText));
-        if ((int16_t)strlen(truncatedText) > maxChars && maxChars > 0) {
-            truncatedText[maxChars] = '\0';
+        if (zone->textWidth > availableWidth) {
+            size_t fit = textSpecialFitLength(&fontDefault, truncatedText, availableWidth);
+            if (fit > 0) truncatedText[fit] = '\0';
         }
 
-        printTextWithSegments(truncatedText, textX, textY, zone->textColor,
+        printTextWithSegments(canvas, truncatedText, textX, textY, zone->textColorPanel,
                               zone->textSegments, zone->textSegmentCount);
 
         // Draw label in lower portion of zone (TomThumb, dimmed)
         if (hasLabel) {
             int16_t labelY = y + h - 6;  // Near bottom of zone
-            printLabelWithSegments(zone->label, textX, labelY, zone->textColor,
+            printLabelWithSegments(zone->label, textX, labelY, zone->textColorPanel,
                                    zone->labelSegments, zone->labelSegmentCount, true);
         }
     } else {
@@ -2059,37 +3236,35 @@ void displayShowZone(AppZone* zone, int16_t x, int16_t y, int16_t w, int16_t h)
             textX = iconX + icon->width + 1;
         }
 
-        // Check if text fits in default font (6px/char), fallback to TomThumb (4px/char)
+        // Check if text fits in default font, fallback to TomThumb (printed raw)
         int16_t availableWidth = (x + w) - textX;
-        int16_t textLen = (int16_t)strlen(zone->text);
-        bool useCompactText = (textLen * 6 > availableWidth);
-        int16_t charWidth = useCompactText ? 4 : 6;
+        bool useCompactText = zone->textWidth > availableWidth;
 
-        int16_t maxChars = availableWidth / charWidth;
         char truncatedText[32];
         strlcpy(truncatedText, zone->text, sizeof(truncatedText));
-        if (textLen > maxChars && maxChars > 0) {
-            truncatedText[maxChars] = '\0';
+        if (useCompactText) {
+            size_t fit = fontFitLength(&fontTomThumb, truncatedText, availableWidth);
+            if (fit > 0) truncatedText[fit] = '\0';
         }
 
         if (useCompactText) {
             // TomThumb: baseline positioning, adjust Y (+5px from top for baseline)
             int16_t compactY = hasLabel ? y + 8 : y + (h / 2) + 2;
-            printLabelWithSegments(truncatedText, textX, compactY, zone->textColor,
+            printLabelWithSegments(truncatedText, textX, compactY, zone->textColorPanel,
                                    zone->textSegments, zone->textSegmentCount, false);
         } else {
             // Default font
-            printTextWithSegments(truncatedText, textX, textY, zone->textColor,
+            printTextWithSegments(canvas, truncatedText, textX, textY, zone->textColorPanel,
                                   zone->textSegments, zone->textSegmentCount);
         }
 
         // Draw label at bottom of zone with good margin
         if (hasLabel) {
-            int16_t labelWidth = strlen(zone->label) * 4;
+            int16_t labelWidth = zone->labelWidth;
             int16_t labelX = x + (w - labelWidth) / 2;
             if (labelX < x) labelX = x;
             int16_t labelY = y + h - 6;
-            printLabelWithSegments(zone->label, labelX, labelY, zone->textColor,
+            printLabelWithSegments(zone->label, labelX, labelY, zone->textColorPanel,
                                    zone->labelSegments, zone->labelSegmentCount, true);
         }
     }
@@ -2097,9 +3272,11 @@ void displayShowZone(AppZone* zone, int16_t x, int16_t y, int16_t w, int16_t h)
 
 // Render multi-zone layout for an app
 void displayShowMultiZone(AppItem* app) {
+    RENDER_TIMED(TIMING_SHOW_MULTIZONE);
     if (!app || app->zoneCount < 2) return;
 
-    dma_display->clearScreen();
+    canvas->fillScreen(0);
+    damageFullFrame();
 
     // Build array of all zones (zone 0 from main app fields, zones 1-3 from zones[])
     AppZone zone0;
@@ -2107,10 +3284,14 @@ void displayShowMultiZone(AppItem* app) {
     strlcpy(zone0.icon, app->icon, sizeof(zone0.icon));
     strlcpy(zone0.label, app->label, sizeof(zone0.label));
     zone0.textColor = app->textColor;
+    zone0.textColorPanel = app->textColorPanel;
     memcpy(zone0.textSegments, app->textSegments, sizeof(app->textSegments));
     zone0.textSegmentCount = app->textSegmentCount;
     memcpy(zone0.labelSegments, app->labelSegments, sizeof(app->labelSegments));
     zone0.labelSegmentCount = app->labelSegmentCount;
+    zone0.textWidth = app->textWidth;
+    zone0.labelWidth = app->labelWidth;
+    zone0.iconHash = app->iconHash;
 
     AppZone* allZones[MAX_ZONES] = { &zone0, nullptr, nullptr, nullptr };
     for (uint8_t i = 1; i < app->zoneCount && i < MAX_ZONES; i++) {
@@ -2118,13 +3299,13 @@ void displayShowMultiZone(AppItem* app) {
     }
 
     // Separator line color (dark gray)
-    uint16_t separatorColor = dma_display->color565(40, 40, 40);
+    uint16_t separatorColor = panelColor(40, 40, 40);
 
     switch (app->zoneCount) {
         case 2: {
             // Two horizontal rows: zone0 top (64x31), zone1 bottom (64x31)
             // Separator at y=31
-            dma_display->drawFastHLine(0, 31, 64, separatorColor);
+            canvas->drawFastHLine(0, 31, 64, separatorColor);
 
             displayShowZone(allZones[0], 0, 0, 64, 31);
             displayShowZone(allZones[1], 0, 33, 64, 31);
@@ -2133,9 +3314,9 @@ void displayShowMultiZone(AppItem* app) {
         case 3: {
             // Top row full-width (zone0, 64x31), bottom row split (zone1 + zone2, 31x31 each)
             // Horizontal separator at y=31
-            dma_display->drawFastHLine(0, 31, 64, separatorColor);
+            canvas->drawFastHLine(0, 31, 64, separatorColor);
             // Vertical separator in bottom half at x=31
-            dma_display->drawFastVLine(31, 33, 31, separatorColor);
+            canvas->drawFastVLine(31, 33, 31, separatorColor);
 
             displayShowZone(allZones[0], 0, 0, 64, 31);
             displayShowZone(allZones[1], 0, 33, 31, 31);
@@ -2145,9 +3326,9 @@ void displayShowMultiZone(AppItem* app) {
         case 4: {
             // Four quadrants (31x31 each)
             // Horizontal separator at y=31
-            dma_display->drawFastHLine(0, 31, 64, separatorColor);
+            canvas->drawFastHLine(0, 31, 64, separatorColor);
             // Vertical separator at x=31
-            dma_display->drawFastVLine(31, 0, 64, separatorColor);
+            canvas->drawFastVLine(31, 0, 64, separatorColor);
 
             displayShowZone(allZones[0], 0, 0, 31, 31);
             displayShowZone(allZones[1], 33, 0, 31, 31);
@@ -2159,27 +3340,242 @@ void displayShowMultiZone(AppItem* app) {
 
     drawIndicators();
 
-    #if DOUBLE_BUFFER
-        dma_display->flipDMABuffer();
-    #endif
+    displayFlush();
 }
 
 void displayClear() {
-    dma_display->clearScreen();
+    canvas->fillScreen(0);
+    damageFullFrame();
+    displayFlush();
+}
+
+// Push the off-screen frame to the panel: rows identical to what the DMA buffer
+// already shows are skipped, and each damaged segment of a changed row is sent
+// as spans. The driver has no bulk RGB565 row write, so a span is one
+// drawFastHLine per run of equal color (its fast DMA path) and single pixels
+// fall back to drawPixelRGB565.
+void displayFlush() {
+    // The incoming app of a transition is rendered off-screen only
+    if (transition.capturing) return;
+
+    const uint16_t* pixels = canvas->getBuffer();
+    uint16_t* shadow = frameShadow[frameShadowIndex];
+    uint32_t pushed = 0;
+    uint32_t spans = 0;
+
+    for (int16_t y = 0; y < DISPLAY_HEIGHT; y++) {
+        const uint16_t* row = pixels + y * DISPLAY_WIDTH;
+        uint16_t* shadowRow = shadow + y * DISPLAY_WIDTH;
+        if (memcmp(row, shadowRow, DISPLAY_WIDTH * sizeof(uint16_t)) == 0) continue;
+
+        int16_t x = 0;
+        while (x < DISPLAY_WIDTH) {
+            if (row[x] == shadowRow[x]) {
+                x++;
+                continue;
+            }
+            // Damaged segment [x, end)
+            int16_t end = x + 1;
+            while (end < DISPLAY_WIDTH && row[end] != shadowRow[end]) end++;
+            memcpy(shadowRow + x, row + x, (end - x) * sizeof(uint16_t));
+            pushed += end - x;
+
+            while (x < end) {
+                int16_t run = x + 1;
+                while (run < end && row[run] == row[x]) run++;
+                if (run - x > 1) {
+                    dma_display->drawFastHLine(x, y, run - x, row[x]);
+                } else {
+                    dma_display->drawPixelRGB565(x, y, row[x]);
+                }
+                spans++;
+                x = run;
+            }
+        }
+    }
+    displayFrameStats.lastPixelsPushed = pushed;
+    displayFrameStats.lastSpansPushed = spans;
+
     #if DOUBLE_BUFFER
         dma_display->flipDMABuffer();
+        frameShadowIndex = (frameShadowIndex + 1) % FRAME_SHADOW_COUNT;
     #endif
 }
 
+// ============================================================================
+// App Transitions
+// ============================================================================
+
+#define TRANSITION_FRAME_BYTES (DISPLAY_WIDTH * DISPLAY_HEIGHT * sizeof(uint16_t))
+
+const char* transitionToString(uint8_t type) {
+    switch (type) {
+        case TRANSITION_FADE:       return "fade";
+        case TRANSITION_SLIDE_LEFT: return "slide_left";
+        case TRANSITION_SLIDE_UP:   return "slide_up";
+        case TRANSITION_GLOBAL:     return "global";
+        default:                    return "none";
+    }
+}
+
+uint8_t transitionFromString(const char* name, uint8_t fallback) {
+    if (!name || name[0] == '\0') return fallback;
+    if (strcmp(name, "none") == 0) return TRANSITION_NONE;
+    if (strcmp(name, "fade") == 0) return TRANSITION_FADE;
+    if (strcmp(name, "slide_left") == 0) return TRANSITION_SLIDE_LEFT;
+    if (strcmp(name, "slide_up") == 0) return TRANSITION_SLIDE_UP;
+    if (strcmp(name, "global") == 0) return TRANSITION_GLOBAL;
+    return fallback;
+}
+
+TransitionType transitionForApp(const AppItem* app) {
+    if (app && app->transition != TRANSITION_GLOBAL) {
+        return (TransitionType)app->transition;
+    }
+    return settings.transition;
+}
+
+static GFXcanvas16* transitionAllocFrame() {
+    GFXcanvas16* frame = new GFXcanvas16(DISPLAY_WIDTH, DISPLAY_HEIGHT);
+    if (!frame->getBuffer()) {
+        delete frame;
+        return nullptr;
+    }
+    return frame;
+}
+
+// Give the 2 x TRANSITION_FRAME_BYTES back to the heap between transitions
+static void transitionReleaseFrames() {
+    delete transitionFrom;
+    delete transitionTo;
+    transitionFrom = nullptr;
+    transitionTo = nullptr;
+}
+
+// Snapshot the outgoing frame. Returns false (hard cut) when no transition
+// is configured or the off-screen frames cannot be allocated.
+bool transitionBegin(TransitionType type) {
+    transitionCancel();
+    if (type == TRANSITION_NONE || !canvas) return false;
+
+    transitionFrom = transitionAllocFrame();
+    transitionTo = transitionAllocFrame();
+    if (!transitionFrom || !transitionTo) {
+        transitionReleaseFrames();
+        Serial.println("[TRANSITION] Frame allocation failed, falling back to cut");
+        return false;
+    }
+
+    memcpy(transitionFrom->getBuffer(), canvas->getBuffer(), TRANSITION_FRAME_BYTES);
+    transition.type = type;
+    transition.capturing = true;
+    return true;
+}
+
+// Called once the incoming app has been drawn into the canvas
+void transitionCommit() {
+    if (!transition.capturing) return;
+    memcpy(transitionTo->getBuffer(), canvas->getBuffer(), TRANSITION_FRAME_BYTES);
+    transition.capturing = false;
+    transition.active = true;
+    transition.startTime = millis();
+    transition.nextFrame = transition.startTime;
+}
+
+// Stop any running transition, leaving the incoming frame in the canvas
+void transitionCancel() {
+    if (transition.active) {
+        memcpy(canvas->getBuffer(), transitionTo->getBuffer(), TRANSITION_FRAME_BYTES);
+    }
+    transition.capturing = false;
+    transition.active = false;
+    transitionReleaseFrames();
+}
+
+// Blend two RGB565 pixels, alpha in 0..32 (0 = from, 32 = to).
+// Channels are spread as 0b00000gggggg00000rrrrr000000bbbbb so a single
+// multiply blends all three without overflowing into each other.
+static inline uint16_t transitionBlend565(uint16_t from, uint16_t to, uint8_t alpha) {
+    uint32_t a = (from | ((uint32_t)from << 16)) & 0x07E0F81F;
+    uint32_t b = (to | ((uint32_t)to << 16)) & 0x07E0F81F;
+    uint32_t mixed = ((((b - a) * alpha) >> 5) + a) & 0x07E0F81F;
+    return (uint16_t)(mixed | (mixed >> 16));
+}
+
+// Composite the next frame. Frames are paced on a fixed timeline so late
+// loop iterations drop frames instead of stretching the animation.
+// Returns false once the transition is over.
+bool transitionStep(unsigned long now) {
+    if (!transition.active) return false;
+    if ((long)(now - transition.nextFrame) < 0) return true;
+
+    uint16_t* dst = canvas->getBuffer();
+    const uint16_t* from = transitionFrom->getBuffer();
+    const uint16_t* to = transitionTo->getBuffer();
+    unsigned long elapsed = now - transition.startTime;
+
+    if (elapsed >= TRANSITION_DURATION) {
+        memcpy(dst, to, TRANSITION_FRAME_BYTES);
+        transition.active = false;
+        transitionReleaseFrames();
+        displayRecordFrame(DISPLAY_WIDTH * DISPLAY_HEIGHT, false);
+        displayFlush();
+        return false;
+    }
+
+    // Progress in Q8 fixed point (0..256)
+    uint16_t progress = (uint16_t)((elapsed << 8) / TRANSITION_DURATION);
+
+    switch (transition.type) {
+        case TRANSITION_FADE: {
+            uint8_t alpha = progress >> 3;
+            for (uint16_t i = 0; i < DISPLAY_WIDTH * DISPLAY_HEIGHT; i++) {
+                dst[i] = transitionBlend565(from[i], to[i], alpha);
+            }
+            break;
+        }
+        case TRANSITION_SLIDE_LEFT: {
+            int16_t offset = (DISPLAY_WIDTH * progress) >> 8;
+            for (int16_t y = 0; y < DISPLAY_HEIGHT; y++) {
+                uint16_t* row = dst + y * DISPLAY_WIDTH;
+                memcpy(row, from + y * DISPLAY_WIDTH + offset,
+                       (DISPLAY_WIDTH - offset) * sizeof(uint16_t));
+                memcpy(row + DISPLAY_WIDTH - offset, to + y * DISPLAY_WIDTH,
+                       offset * sizeof(uint16_t));
+            }
+            break;
+        }
+        case TRANSITION_SLIDE_UP: {
+            int16_t offset = (DISPLAY_HEIGHT * progress) >> 8;
+            memcpy(dst, from + offset * DISPLAY_WIDTH,
+                   (DISPLAY_HEIGHT - offset) * DISPLAY_WIDTH * sizeof(uint16_t));
+            memcpy(dst + (DISPLAY_HEIGHT - offset) * DISPLAY_WIDTH, to,
+                   offset * DISPLAY_WIDTH * sizeof(uint16_t));
+            break;
+        }
+        default:
+            memcpy(dst, to, TRANSITION_FRAME_BYTES);
+            break;
+    }
+
+    displayRecordFrame(DISPLAY_WIDTH * DISPLAY_HEIGHT, false);
+    displayFlush();
+
+    do {
+        transition.nextFrame += TRANSITION_FRAME_INTERVAL;
+    } while ((long)(now - transition.nextFrame) >= 0);
+    return true;
+}
+
 void displaySetBrightness(uint8_t brightness) {
     currentBrightness = constrain(brightness, MIN_BRIGHTNESS, MAX_BRIGHTNESS);
     dma_display->setBrightness8(currentBrightness);
     Serial.printf("[DISPLAY] Brightness set to %d\n", currentBrightness);
 }
 
+// Width of main text in the default font, as drawn by printTextWithSpecialChars()
 int16_t calculateTextWidth(const char* text) {
-    // Default 5x7 font with 1px spacing = 6 pixels per character
-    return strlen(text) * 6;
+    return textSpecialWidth(&fontDefault, text);
 }
 
 bool textNeedsScroll(const char* text, int16_t availableWidth) {
@@ -2209,11 +3605,15 @@ void resetNotifScrollState() {
 // ============================================================================
 
 void displayShowNotification(NotificationItem* notif) {
+    RENDER_TIMED(TIMING_SHOW_NOTIFICATION);
     if (!notif || !notif->active) return;
+    iconPass++;
+    transitionCancel();
 
     // Mark display timestamp on first render
     if (notif->displayedAt == 0) {
         notif->displayedAt = millis();
+        stateVersion++;
     }
 
     // Layout: horizontal separators with background color margins
@@ -2227,33 +3627,24 @@ void displayShowNotification(NotificationItem* notif) {
     const int16_t textAreaWidth = DISPLAY_WIDTH - textPadding * 2;         // 60
 
     // Colors
-    uint8_t tr = (notif->textColor >> 16) & 0xFF;
-    uint8_t tg = (notif->textColor >> 8) & 0xFF;
-    uint8_t tb = notif->textColor & 0xFF;
-    uint16_t lineColor = dma_display->color565(tr, tg, tb);
-    uint16_t black = dma_display->color565(0, 0, 0);
-
-    uint16_t bgFill = black;
-    if (notif->backgroundColor != 0) {
-        uint8_t br = (notif->backgroundColor >> 16) & 0xFF;
-        uint8_t bg = (notif->backgroundColor >> 8) & 0xFF;
-        uint8_t bb = notif->backgroundColor & 0xFF;
-        bgFill = dma_display->color565(br, bg, bb);
-    }
+    uint16_t lineColor = notif->textColorPanel;
+    uint16_t black = panelColor(0, 0, 0);
+    uint16_t bgFill = notif->backgroundColorPanel;
 
     // === Build frame (no clearScreen to avoid DMA flicker) ===
+    damageFullFrame();
 
     // 1. Background color margins (top and bottom strips)
-    dma_display->fillRect(0, 0, DISPLAY_WIDTH, marginHeight, bgFill);
-    dma_display->fillRect(0, DISPLAY_HEIGHT - marginHeight, DISPLAY_WIDTH, marginHeight, bgFill);
+    canvas->fillRect(0, 0, DISPLAY_WIDTH, marginHeight, bgFill);
+    canvas->fillRect(0, DISPLAY_HEIGHT - marginHeight, DISPLAY_WIDTH, marginHeight, bgFill);
 
     // 2. Content area (black)
-    dma_display->fillRect(0, marginHeight, DISPLAY_WIDTH, DISPLAY_HEIGHT - marginHeight * 2, black);
+    canvas->fillRect(0, marginHeight, DISPLAY_WIDTH, DISPLAY_HEIGHT - marginHeight * 2, black);
 
     // 3. Separator lines
     uint16_t separatorColor = (bgFill != black) ? bgFill : lineColor;
-    dma_display->drawFastHLine(0, separatorTopY, DISPLAY_WIDTH, separatorColor);
-    dma_display->drawFastHLine(0, separatorBottomY, DISPLAY_WIDTH, separatorColor);
+    canvas->drawFastHLine(0, separatorTopY, DISPLAY_WIDTH, separatorColor);
+    canvas->drawFastHLine(0, separatorBottomY, DISPLAY_WIDTH, separatorColor);
 
     // 4. Load icon
     CachedIcon* icon = nullptr;
@@ -2290,10 +3681,7 @@ void displayShowNotification(NotificationItem* notif) {
     }
 
     // 7. Draw text (full width, scrolls off-screen naturally - no clipping needed)
-    dma_display->setTextColor(lineColor);
-    dma_display->setTextSize(1);
-
-    int16_t textWidth = calculateTextWidth(notif->text);
+    int16_t textWidth = notif->textWidth;
     bool needsScroll = textWidth > textAreaWidth;
 
     if (notifScrollState.textWidth != textWidth || notifScrollState.availableWidth != textAreaWidth) {
@@ -2313,13 +3701,19 @@ void displayShowNotification(NotificationItem* notif) {
         xPos = textPadding - notifScrollState.scrollOffset;
     }
 
-    printTextWithSpecialChars(notif->text, xPos, textYPos);
+    TextStripCanvas* strip = textStripPrepare(&notifTextStrip, notif->textSignature, notif->text,
+                                              notif->textColorPanel, nullptr, 0);
+    if (strip) {
+        drawTextStrip(canvas, strip, xPos, textYPos);
+    } else {
+        canvas->setTextColor(lineColor);
+        canvas->setTextSize(1);
+        printTextWithSpecialChars(canvas, notif->text, xPos, textYPos);
+    }
 
     drawIndicators();
 
-    #if DOUBLE_BUFFER
-        dma_display->flipDMABuffer();
-    #endif
+    displayFlush();
 }
 
 // ============================================================================
@@ -2336,6 +3730,7 @@ void indicatorInit() {
     indicators[2].color = 0x0000FF;
 
     for (uint8_t i = 0; i < NUM_INDICATORS; i++) {
+        indicators[i].colorPanel = panelColorRGB(indicators[i].color);
         indicators[i].blinkInterval = INDICATOR_BLINK_INTERVAL;
         indicators[i].fadePeriod = INDICATOR_FADE_PERIOD;
     }
@@ -2347,6 +3742,7 @@ void indicatorSet(uint8_t index, IndicatorMode mode, uint32_t color,
 
     indicators[index].mode = mode;
     indicators[index].color = color;
+    indicators[index].colorPanel = panelColorRGB(color);
     indicators[index].blinkInterval = blinkInterval > 0 ? blinkInterval : INDICATOR_BLINK_INTERVAL;
     indicators[index].fadePeriod = fadePeriod > 0 ? fadePeriod : INDICATOR_FADE_PERIOD;
 
@@ -2354,11 +3750,13 @@ void indicatorSet(uint8_t index, IndicatorMode mode, uint32_t color,
     indicatorAnimState[index].lastToggle = millis();
     indicatorAnimState[index].blinkOn = true;
     indicatorAnimState[index].cycleStart = millis();
+    damage.indicatorsChanged = true;
 }
 
 void indicatorOff(uint8_t index) {
     if (index >= NUM_INDICATORS) return;
     indicators[index].mode = INDICATOR_OFF;
+    damage.indicatorsChanged = true;
 }
 
 bool indicatorNeedsRedraw() {
@@ -2370,26 +3768,40 @@ bool indicatorNeedsRedraw() {
     return false;
 }
 
+// Blinking indicators change at their next toggle, fading ones on every
+// redraw loopDisplay() allows for them (more than 50 ms after the last one)
+void indicatorDeadline(FrameDeadline& next, unsigned long lastDraw) {
+    unsigned long allowed = lastDraw + 51;
+    for (uint8_t i = 0; i < NUM_INDICATORS; i++) {
+        if (indicators[i].mode == INDICATOR_BLINK) {
+            unsigned long toggle = indicatorAnimState[i].lastToggle + indicators[i].blinkInterval;
+            next.need((long)(toggle - allowed) > 0 ? toggle : allowed);
+        } else if (indicators[i].mode == INDICATOR_FADE) {
+            next.need(allowed);
+        }
+    }
+}
+
+// Top-left corner of an indicator's footprint
+void indicatorOrigin(uint8_t index, int16_t* x, int16_t* y) {
+    switch (index) {
+        case 0: *x = 0; *y = 0; break;                                             // Top-left
+        case 1: *x = DISPLAY_WIDTH - INDICATOR_FOOTPRINT; *y = 0; break;           // Top-right
+        default: *x = DISPLAY_WIDTH - INDICATOR_FOOTPRINT;                          // Bottom-right
+                 *y = DISPLAY_HEIGHT - INDICATOR_FOOTPRINT; break;
+    }
+}
+
 void drawIndicators() {
     unsigned long now = millis();
 
     for (uint8_t i = 0; i < NUM_INDICATORS; i++) {
         if (indicators[i].mode == INDICATOR_OFF) continue;
 
-        // Compute corner position
         int16_t x, y;
-        switch (i) {
-            case 0: x = 0; y = 0; break;                                             // Top-left
-            case 1: x = DISPLAY_WIDTH - INDICATOR_FOOTPRINT; y = 0; break;           // Top-right
-            case 2: x = DISPLAY_WIDTH - INDICATOR_FOOTPRINT;                          // Bottom-right
-                    y = DISPLAY_HEIGHT - INDICATOR_FOOTPRINT; break;
-            default: continue;
-        }
+        indicatorOrigin(i, &x, &y);
 
-        // Extract base color
-        uint8_t r = (indicators[i].color >> 16) & 0xFF;
-        uint8_t g = (indicators[i].color >> 8) & 0xFF;
-        uint8_t b = indicators[i].color & 0xFF;
+        uint16_t color = indicators[i].colorPanel;
 
         // Apply mode effect
         switch (indicators[i].mode) {
@@ -2416,9 +3828,7 @@ void drawIndicators() {
                 } else {
                     brightness = 10 + (uint16_t)(245 * (indicators[i].fadePeriod - elapsed)) / halfPeriod;
                 }
-                r = (uint16_t)r * brightness / 255;
-                g = (uint16_t)g * brightness / 255;
-                b = (uint16_t)b * brightness / 255;
+                color = panelDim(color, brightness);
                 break;
             }
 
@@ -2427,13 +3837,37 @@ void drawIndicators() {
         }
 
         // Draw black border (full footprint)
-        dma_display->fillRect(x, y, INDICATOR_FOOTPRINT, INDICATOR_FOOTPRINT,
-                              dma_display->color565(0, 0, 0));
+        canvas->fillRect(x, y, INDICATOR_FOOTPRINT, INDICATOR_FOOTPRINT,
+                              panelColor(0, 0, 0));
 
         // Draw colored core (inset by border size)
-        dma_display->fillRect(x + INDICATOR_BORDER_SIZE, y + INDICATOR_BORDER_SIZE,
-                              INDICATOR_CORE_SIZE, INDICATOR_CORE_SIZE,
-                              dma_display->color565(r, g, b));
+        canvas->fillRect(x + INDICATOR_BORDER_SIZE, y + INDICATOR_BORDER_SIZE,
+                              INDICATOR_CORE_SIZE, INDICATOR_CORE_SIZE, color);
+    }
+}
+
+// "mode" of an indicator request; an absent mode means solid when a color is
+// given, off otherwise. False for an unknown mode.
+static bool indicatorModeFromBody(JsonObject body, IndicatorMode* mode) {
+    const char* modeStr = body["mode"] | "";
+    if (modeStr[0] == '\0') {
+        *mode = body["color"].isNull() ? INDICATOR_OFF : INDICATOR_SOLID;
+        return true;
+    }
+    if (strcmp(modeStr, "solid") == 0) *mode = INDICATOR_SOLID;
+    else if (strcmp(modeStr, "blink") == 0) *mode = INDICATOR_BLINK;
+    else if (strcmp(modeStr, "fade") == 0) *mode = INDICATOR_FADE;
+    else if (strcmp(modeStr, "off") == 0) *mode = INDICATOR_OFF;
+    else return false;
+    return true;
+}
+
+static const char* indicatorModeToString(IndicatorMode mode) {
+    switch (mode) {
+        case INDICATOR_SOLID: return "solid";
+        case INDICATOR_BLINK: return "blink";
+        case INDICATOR_FADE:  return "fade";
+        default:              return "off";
     }
 }
 
@@ -2444,159 +3878,70 @@ void handleIndicatorApi(AsyncWebServerRequest *request, JsonVariant &json, uint8
     }
 
     JsonObject body = json.as<JsonObject>();
-
-    // Parse mode string
-    const char* modeStr = body["mode"] | "";
     IndicatorMode mode = INDICATOR_OFF;
-
-    if (strlen(modeStr) > 0) {
-        if (strcmp(modeStr, "solid") == 0) mode = INDICATOR_SOLID;
-        else if (strcmp(modeStr, "blink") == 0) mode = INDICATOR_BLINK;
-        else if (strcmp(modeStr, "fade") == 0) mode = INDICATOR_FADE;
-        else if (strcmp(modeStr, "off") == 0) mode = INDICATOR_OFF;
-        else {
-            request->send(400, "application/json", "{\"error\":\"Invalid mode. Use: off, solid, blink, fade\"}");
-            return;
-        }
-    } else if (!body["color"].isNull()) {
-        // Default to solid if color provided but no mode
-        mode = INDICATOR_SOLID;
+    if (!indicatorModeFromBody(body, &mode)) {
+        request->send(400, "application/json", "{\"error\":\"Invalid mode. Use: off, solid, blink, fade\"}");
+        return;
     }
 
     if (mode == INDICATOR_OFF) {
-        indicatorOff(index);
-        saveSettings();
-        Serial.printf("[API] Indicator %d turned off\n", index + 1);
-        request->send(200, "application/json", "{\"success\":true,\"mode\":\"off\"}");
+        commandRespond(request, CMD_INDICATOR, index, "", json, "{\"success\":true,\"mode\":\"off\"}");
         return;
     }
 
-    // Parse color (reuse parseColorValue helper)
+    // Echo the color the command will set, the current one when none is given
     uint32_t color = parseColorValue(body["color"], indicators[index].color);
-
-    // Parse optional timing parameters
-    uint16_t blinkInterval = body["blinkInterval"] | (uint16_t)INDICATOR_BLINK_INTERVAL;
-    uint16_t fadePeriod = body["fadePeriod"] | (uint16_t)INDICATOR_FADE_PERIOD;
-
-    indicatorSet(index, mode, color, blinkInterval, fadePeriod);
-    saveSettings();
-
-    Serial.printf("[API] Indicator %d set: mode=%s color=0x%06X\n",
-                  index + 1, modeStr[0] ? modeStr : "solid", color);
-
     char colorHex[8];
     formatColorHex(color, colorHex, sizeof(colorHex));
     char response[128];
     snprintf(response, sizeof(response),
              "{\"success\":true,\"indicator\":%d,\"mode\":\"%s\",\"color\":\"%s\"}",
-             index + 1,
-             mode == INDICATOR_SOLID ? "solid" : (mode == INDICATOR_BLINK ? "blink" : "fade"),
-             colorHex);
-    request->send(200, "application/json", response);
+             index + 1, indicatorModeToString(mode), colorHex);
+    commandRespond(request, CMD_INDICATOR, index, "", json, response);
 }
 
 // Print text with special character handling
 // Replaces non-ASCII characters with ASCII equivalents or draws them manually
-void printTextWithSpecialChars(const char* text, int16_t x, int16_t y) {
+void printTextWithSpecialChars(Adafruit_GFX* gfx, const char* text, int16_t x, int16_t y) {
     int16_t cursorX = x;
-    const uint8_t charWidth = 6;  // 5x7 font + 1px spacing
 
-    dma_display->setCursor(cursorX, y);
+    gfx->setCursor(cursorX, y);
 
     const uint8_t* ptr = (const uint8_t*)text;
     while (*ptr) {
-        uint8_t c = *ptr;
+        uint8_t glyph;
+        ptr += textDecodeSpecial(ptr, &glyph);
 
-        // Handle UTF-8 degree symbol (C2 B0)
-        if (c == 0xC2 && *(ptr + 1) == 0xB0) {
+        if (glyph == TEXT_GLYPH_DEGREE) {
             // Draw degree symbol as small circle (3x3 at top)
             // Use white color - will inherit from setTextColor context
-            int16_t dx = cursorX;
-            int16_t dy = y - 6;  // Position at top of character
-            dma_display->drawPixel(dx + 1, dy, 0xFFFF);
-            dma_display->drawPixel(dx, dy + 1, 0xFFFF);
-            dma_display->drawPixel(dx + 2, dy + 1, 0xFFFF);
-            dma_display->drawPixel(dx + 1, dy + 2, 0xFFFF);
-            cursorX += 4;  // Smaller width for degree
-            ptr += 2;  // Skip both UTF-8 bytes
-            dma_display->setCursor(cursorX, y);
-            continue;
-        }
-
-        // Handle Latin-1 degree symbol (direct byte 0xB0)
-        if (c == 0xB0) {
-            int16_t dx = cursorX;
-            int16_t dy = y - 6;
-            dma_display->drawPixel(dx + 1, dy, 0xFFFF);
-            dma_display->drawPixel(dx, dy + 1, 0xFFFF);
-            dma_display->drawPixel(dx + 2, dy + 1, 0xFFFF);
-            dma_display->drawPixel(dx + 1, dy + 2, 0xFFFF);
-            cursorX += 4;
-            ptr++;
-            dma_display->setCursor(cursorX, y);
-            continue;
-        }
-
-        // Handle UTF-8 accented characters (common French)
-        if (c == 0xC3) {
-            uint8_t next = *(ptr + 1);
-            char replacement = '?';
-            switch (next) {
-                case 0xA0: case 0xA2: case 0xA4: replacement = 'a'; break;  // a grave, circumflex, umlaut
-                case 0xA8: case 0xA9: case 0xAA: case 0xAB: replacement = 'e'; break;  // e variants
-                case 0xAC: case 0xAE: case 0xAF: replacement = 'i'; break;  // i variants
-                case 0xB2: case 0xB4: case 0xB6: replacement = 'o'; break;  // o variants
-                case 0xB9: case 0xBB: case 0xBC: replacement = 'u'; break;  // u variants
-                case 0xA7: replacement = 'c'; break;  // c cedilla
-                case 0xB1: replacement = 'n'; break;  // n tilde
-                case 0x80: case 0x89: replacement = 'E'; break;  // E accent
-                case 0x87: replacement = 'C'; break;  // C cedilla
-            }
-            dma_display->print(replacement);
-            cursorX += charWidth;
-            ptr += 2;
-            dma_display->setCursor(cursorX, y);
-            continue;
-        }
-
-        // Standard ASCII character
-        if (c >= 32 && c <= 126) {
-            dma_display->print((char)c);
-            cursorX += charWidth;
+            drawDegreeSign(gfx, cursorX, y - 6, 0xFFFF);
+        } else if (glyph) {
+            gfx->print((char)glyph);
         }
-        // Skip other non-printable characters
-
-        ptr++;
-        dma_display->setCursor(cursorX, y);
+        cursorX += textGlyphAdvance(&fontDefault, glyph);
+        gfx->setCursor(cursorX, y);
     }
 }
 
 // Draw text with per-segment coloring (NULL font, 6px/char)
 // segmentCount==0: uses defaultColor and delegates to printTextWithSpecialChars
 // segmentCount>0: switches color at segment boundaries
-void printTextWithSegments(const char* text, int16_t x, int16_t y,
-                           uint32_t defaultColor, const TextSegment* segments, uint8_t segmentCount) {
+void printTextWithSegments(Adafruit_GFX* gfx, const char* text, int16_t x, int16_t y,
+                           uint16_t defaultColor, const TextSegment* segments, uint8_t segmentCount) {
     if (segmentCount == 0) {
-        uint8_t r = (defaultColor >> 16) & 0xFF;
-        uint8_t g = (defaultColor >> 8) & 0xFF;
-        uint8_t b = defaultColor & 0xFF;
-        dma_display->setTextColor(dma_display->color565(r, g, b));
-        printTextWithSpecialChars(text, x, y);
+        gfx->setTextColor(defaultColor);
+        printTextWithSpecialChars(gfx, text, x, y);
         return;
     }
 
-    const uint8_t charWidth = 6;
     int16_t cursorX = x;
-    dma_display->setCursor(cursorX, y);
+    gfx->setCursor(cursorX, y);
 
     // Start with first segment color or default
     uint8_t currentSegment = 0;
-    uint32_t currentColor = (segmentCount > 0) ? segments[0].color : defaultColor;
-    uint8_t r = (currentColor >> 16) & 0xFF;
-    uint8_t g = (currentColor >> 8) & 0xFF;
-    uint8_t b = currentColor & 0xFF;
-    uint16_t color565 = dma_display->color565(r, g, b);
-    dma_display->setTextColor(color565);
+    uint16_t color565 = segments[0].colorPanel;
+    gfx->setTextColor(color565);
 
     uint8_t charIndex = 0;  // Visual char index (UTF-8 multi-byte = 1 visual char)
     const uint8_t* ptr = (const uint8_t*)text;
@@ -2605,79 +3950,72 @@ void printTextWithSegments(const char* text, int16_t x, int16_t y,
         // Check if we need to switch to next segment color
         if (currentSegment + 1 < segmentCount && charIndex >= segments[currentSegment + 1].offset) {
             currentSegment++;
-            currentColor = segments[currentSegment].color;
-            r = (currentColor >> 16) & 0xFF;
-            g = (currentColor >> 8) & 0xFF;
-            b = currentColor & 0xFF;
-            color565 = dma_display->color565(r, g, b);
-            dma_display->setTextColor(color565);
-        }
-
-        uint8_t c = *ptr;
-
-        // Handle UTF-8 degree symbol (C2 B0)
-        if (c == 0xC2 && *(ptr + 1) == 0xB0) {
-            int16_t dx = cursorX;
-            int16_t dy = y - 6;
-            dma_display->drawPixel(dx + 1, dy, color565);
-            dma_display->drawPixel(dx, dy + 1, color565);
-            dma_display->drawPixel(dx + 2, dy + 1, color565);
-            dma_display->drawPixel(dx + 1, dy + 2, color565);
-            cursorX += 4;
-            ptr += 2;
-            charIndex++;
-            dma_display->setCursor(cursorX, y);
-            continue;
+            color565 = segments[currentSegment].colorPanel;
+            gfx->setTextColor(color565);
         }
 
-        // Handle Latin-1 degree symbol (direct byte 0xB0)
-        if (c == 0xB0) {
-            int16_t dx = cursorX;
-            int16_t dy = y - 6;
-            dma_display->drawPixel(dx + 1, dy, color565);
-            dma_display->drawPixel(dx, dy + 1, color565);
-            dma_display->drawPixel(dx + 2, dy + 1, color565);
-            dma_display->drawPixel(dx + 1, dy + 2, color565);
-            cursorX += 4;
-            ptr++;
-            charIndex++;
-            dma_display->setCursor(cursorX, y);
-            continue;
-        }
+        uint8_t glyph;
+        ptr += textDecodeSpecial(ptr, &glyph);
 
-        // Handle UTF-8 accented characters (common French)
-        if (c == 0xC3) {
-            uint8_t next = *(ptr + 1);
-            char replacement = '?';
-            switch (next) {
-                case 0xA0: case 0xA2: case 0xA4: replacement = 'a'; break;
-                case 0xA8: case 0xA9: case 0xAA: case 0xAB: replacement = 'e'; break;
-                case 0xAC: case 0xAE: case 0xAF: replacement = 'i'; break;
-                case 0xB2: case 0xB4: case 0xB6: replacement = 'o'; break;
-                case 0xB9: case 0xBB: case 0xBC: replacement = 'u'; break;
-                case 0xA7: replacement = 'c'; break;
-                case 0xB1: replacement = 'n'; break;
-                case 0x80: case 0x89: replacement = 'E'; break;
-                case 0x87: replacement = 'C'; break;
-            }
-            dma_display->print(replacement);
-            cursorX += charWidth;
-            ptr += 2;
-            charIndex++;
-            dma_display->setCursor(cursorX, y);
-            continue;
+        if (glyph == TEXT_GLYPH_DEGREE) {
+            drawDegreeSign(gfx, cursorX, y - 6, color565);
+        } else if (glyph) {
+            gfx->print((char)glyph);
         }
+        if (glyph) charIndex++;
+        cursorX += textGlyphAdvance(&fontDefault, glyph);
+        gfx->setCursor(cursorX, y);
+    }
+}
 
-        // Standard ASCII character
-        if (c >= 32 && c <= 126) {
-            dma_display->print((char)c);
-            cursorX += charWidth;
-            charIndex++;
-        }
+uint32_t textStripSignature(const char* text, uint16_t defaultColor,
+                            const TextSegment* segments, uint8_t segmentCount) {
+    uint32_t signature = damageHash(DAMAGE_HASH_SEED, text, strlen(text) + 1);
+    signature = damageHash(signature, &defaultColor, sizeof(defaultColor));
+    return damageHash(signature, segments, sizeof(TextSegment) * segmentCount);
+}
 
-        ptr++;
-        dma_display->setCursor(cursorX, y);
+// Rasterize text into a 1bpp strip with color runs, only when text or colors changed.
+// Returns nullptr when the text cannot be cached (allocation failure, too many
+// color changes); callers then draw the text directly.
+// signature is textStripSignature() of the other arguments, computed when the
+// text was set.
+TextStripCanvas* textStripPrepare(TextStripCache* cache, uint32_t signature, const char* text,
+                                  uint16_t defaultColor, const TextSegment* segments, uint8_t segmentCount) {
+    if (cache->built && cache->signature == signature) {
+        return cache->strip;
+    }
+
+    textStripRelease(cache);
+    cache->signature = signature;
+    cache->built = true;
+
+    int16_t width = calculateTextWidth(text);
+    if (width <= 0) return nullptr;
+
+    TextStripCanvas* strip = new TextStripCanvas(width, TEXT_STRIP_HEIGHT);
+    if (!strip->getBuffer()) {
+        Serial.printf("[TEXT] Strip allocation failed (%dx%d)\n", width, TEXT_STRIP_HEIGHT);
+        delete strip;
+        return nullptr;
+    }
+
+    strip->setTextWrap(false);
+    strip->setTextSize(1);
+    printTextWithSegments(strip, text, 0, TEXT_STRIP_ASCENT, defaultColor, segments, segmentCount);
+    if (strip->runOverflow) {
+        delete strip;
+        return nullptr;
     }
+
+    cache->strip = strip;
+    return strip;
+}
+
+void textStripRelease(TextStripCache* cache) {
+    delete cache->strip;
+    cache->strip = nullptr;
+    cache->built = false;
 }
 
 // Draw label text with per-segment coloring (TomThumb font, baseline positioning)
@@ -2685,35 +4023,23 @@ void printTextWithSegments(const char* text, int16_t x, int16_t y,
 // dimDefault=false: uses defaultColor as-is (compact text in half-width zones)
 // segmentCount>0: uses segment colors at full brightness
 void printLabelWithSegments(const char* text, int16_t x, int16_t y,
-                            uint32_t defaultColor, const TextSegment* segments, uint8_t segmentCount,
+                            uint16_t defaultColor, const TextSegment* segments, uint8_t segmentCount,
                             bool dimDefault) {
-    dma_display->setFont(&TomThumb);
+    canvas->setFont(&TomThumb);
 
     if (segmentCount == 0) {
-        uint8_t r = (defaultColor >> 16) & 0xFF;
-        uint8_t g = (defaultColor >> 8) & 0xFF;
-        uint8_t b = defaultColor & 0xFF;
-        if (dimDefault) {
-            r = r * 3 / 4;
-            g = g * 3 / 4;
-            b = b * 3 / 4;
-        }
-        dma_display->setTextColor(dma_display->color565(r, g, b));
-        dma_display->setCursor(x, y);
-        dma_display->print(text);
-        dma_display->setFont(NULL);
+        canvas->setTextColor(dimDefault ? panelDim(defaultColor, 191) : defaultColor);
+        canvas->setCursor(x, y);
+        canvas->print(text);
+        canvas->setFont(NULL);
         return;
     }
 
     // Per-segment coloring - let GFX library handle cursor advancement
-    dma_display->setCursor(x, y);
+    canvas->setCursor(x, y);
 
     uint8_t currentSegment = 0;
-    uint32_t currentColor = segments[0].color;
-    uint8_t r = (currentColor >> 16) & 0xFF;
-    uint8_t g = (currentColor >> 8) & 0xFF;
-    uint8_t b = currentColor & 0xFF;
-    dma_display->setTextColor(dma_display->color565(r, g, b));
+    canvas->setTextColor(segments[0].colorPanel);
 
     uint8_t charIndex = 0;
     const char* ptr = text;
@@ -2722,19 +4048,15 @@ void printLabelWithSegments(const char* text, int16_t x, int16_t y,
         // Check if we need to switch to next segment color
         if (currentSegment + 1 < segmentCount && charIndex >= segments[currentSegment + 1].offset) {
             currentSegment++;
-            currentColor = segments[currentSegment].color;
-            r = (currentColor >> 16) & 0xFF;
-            g = (currentColor >> 8) & 0xFF;
-            b = currentColor & 0xFF;
-            dma_display->setTextColor(dma_display->color565(r, g, b));
+            canvas->setTextColor(segments[currentSegment].colorPanel);
         }
 
-        dma_display->print(*ptr);
+        canvas->print(*ptr);
         charIndex++;
         ptr++;
     }
 
-    dma_display->setFont(NULL);
+    canvas->setFont(NULL);
 }
 
 // ============================================================================
@@ -2742,25 +4064,59 @@ void printLabelWithSegments(const char* text, int16_t x, int16_t y,
 // ============================================================================
 
 void initIconCache() {
+    iconIndex.clear();
+    memset(iconMisses, 0, sizeof(iconMisses));
     for (uint8_t i = 0; i < MAX_ICON_CACHE; i++) {
         iconCache[i].name[0] = '\0';
+        iconCache[i].data = nullptr;
         iconCache[i].pixels = nullptr;
+        iconCache[i].spans = nullptr;
+        iconCache[i].frames = nullptr;
+        iconCache[i].frameCount = 0;
+        iconCache[i].bytes = 0;
         iconCache[i].width = 0;
         iconCache[i].height = 0;
         iconCache[i].valid = false;
         iconCache[i].lastUsed = 0;
     }
-    Serial.println("[ICON] Cache initialized");
+    if (!iconArenaPool) iconArenaPool = (uint8_t*)bootAlloc(ICON_CACHE_BUDGET, "icon arena");
+    iconArenaInit(&iconArena, iconArenaPool, iconArenaPool ? ICON_CACHE_BUDGET : 0);
+
+    memset(&iconPlaceholder, 0, sizeof(iconPlaceholder));
+    strlcpy(iconPlaceholder.name, "placeholder", sizeof(iconPlaceholder.name));
+    iconPlaceholder.pixels = (uint16_t*)iconPlaceholderPixels;
+    iconPlaceholder.spans = iconPlaceholderSpans;
+    iconPlaceholder.frames = &iconPlaceholderFrame;
+    iconPlaceholder.width = 8;
+    iconPlaceholder.height = 8;
+    iconPlaceholder.frameCount = 1;
+    iconPlaceholder.spanCount = buildIconSpans(iconPlaceholderPixels, 8, 8, iconPlaceholderSpans);
+    iconPlaceholderFrame.spanCount = iconPlaceholder.spanCount;
+    iconPlaceholder.valid = true;
+
+    uint16_t atlasSpans = 0;
+    for (uint8_t i = 0; i < WEATHER_SPRITE_COUNT; i++) {
+        CachedIcon& sprite = iconAtlas[i];
+        memset(&sprite, 0, sizeof(sprite));
+        strlcpy(sprite.name, WEATHER_SPRITE_NAMES[i], sizeof(sprite.name));
+        sprite.hash = nameHash(sprite.name);
+        sprite.pixels = (uint16_t*)weatherSpritePixels(i);
+        sprite.spans = iconAtlasSpans + atlasSpans;
+        sprite.frames = &iconAtlasFrames[i];
+        sprite.width = WEATHER_SPRITE_SIZE;
+        sprite.height = WEATHER_SPRITE_SIZE;
+        sprite.frameCount = 1;
+        sprite.spanCount = buildIconSpans(sprite.pixels, WEATHER_SPRITE_SIZE, WEATHER_SPRITE_SIZE, sprite.spans);
+        iconAtlasFrames[i].firstSpan = 0;
+        iconAtlasFrames[i].spanCount = sprite.spanCount;
+        sprite.valid = true;
+        atlasSpans += sprite.spanCount;
+    }
+    Serial.printf("[ICON] Cache initialized (%u byte arena)\n", (unsigned)iconArena.capacity);
 }
 
 int pngDrawCallback(PNGDRAW *pDraw) {
-    if (!pngDecodeTarget || pDraw->y >= 16) return 1;
-
-    // Debug: log pixel type on first line
-    if (pDraw->y == 0) {
-        Serial.printf("[PNG] PixelType=%d, Width=%d, BPP=%d, HasAlpha=%d\n",
-            pDraw->iPixelType, pDraw->iWidth, pDraw->iBpp, pDraw->iHasAlpha);
-    }
+    if (!pngDecodeTarget || pDraw->y >= pngDecodeHeight) return 1;
 
     uint16_t* dest = pngDecodeTarget + (pDraw->y * pngDecodeWidth);
     uint16_t pixel;
@@ -2800,250 +4156,925 @@ int pngDrawCallback(PNGDRAW *pDraw) {
             a = 255;
         }
 
-        // Debug: log first non-black pixel on line 10
-        if (pDraw->y == 10 && x < 20 && (r > 50 || g > 50 || b > 50)) {
-            Serial.printf("[PNG] y=10 x=%d: R=%d G=%d B=%d A=%d\n", x, r, g, b, a);
-        }
-
-        // Convert to RGB565
+        // Convert to panel RGB565
         if (a < 128) {
             pixel = 0;  // Transparent = black
         } else {
-            pixel = ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+            pixel = panelColor(r, g, b);
         }
         dest[x] = pixel;
     }
     return 1;
 }
 
-int8_t findLRUSlot() {
-    int8_t lruIndex = -1;
-    unsigned long oldestTime = UINT32_MAX;
+void iconFree(CachedIcon* icon) {
+    // Only cache entries are valid, decode temporaries are not indexed
+    if (icon->valid) iconIndex.remove(icon->hash, icon - iconCache);
+    if (icon->data) {
+        iconArenaFree(&iconArena, icon->data);
+    } else {
+        // Decoded but not packed yet, frames and pixels share one heap block
+        free(icon->frames);
+    }
+    icon->data = nullptr;
+    icon->pixels = nullptr;
+    icon->spans = nullptr;
+    icon->frames = nullptr;
+    icon->bytes = 0;
+    icon->valid = false;
+}
 
-    for (uint8_t i = 0; i < MAX_ICON_CACHE; i++) {
-        // First check for empty slots
-        if (!iconCache[i].valid) {
-            return i;
-        }
-        // Then find least recently used
-        if (iconCache[i].lastUsed < oldestTime) {
-            oldestTime = iconCache[i].lastUsed;
-            lruIndex = i;
-        }
-    }
-
-    // Free the LRU slot
-    if (lruIndex >= 0 && iconCache[lruIndex].pixels) {
-        free(iconCache[lruIndex].pixels);
-        iconCache[lruIndex].pixels = nullptr;
-        iconCache[lruIndex].valid = false;
-        Serial.printf("[ICON] Evicted icon: %s\n", iconCache[lruIndex].name);
-    }
+// Find a cache slot and make `bytes` fit in the arena, evicting least
+// recently used icons. Icons drawn by the current pass are kept, the
+// caller may still hold pointers to them.
+int8_t iconReserveSlot(uint32_t bytes) {
+    if (iconArenaBlockSize(bytes) > iconArena.capacity) return -1;
 
-    return lruIndex;
-}
+    while (true) {
+        int8_t freeIndex = -1;
+        int8_t lruIndex = -1;
+        unsigned long oldestTime = ULONG_MAX;
 
-CachedIcon* loadIcon(const char* name) {
-    if (!name || strlen(name) == 0) return nullptr;
-    if (!filesystemReady) return nullptr;
-
-    // Build file path
-    char filePath[64];
-    snprintf(filePath, sizeof(filePath), "%s/%s.png", FS_ICONS_PATH, name);
+        for (uint8_t i = 0; i < MAX_ICON_CACHE; i++) {
+            if (!iconCache[i].valid) {
+                if (freeIndex < 0 && !iconCache[i].loading) freeIndex = i;
+                continue;
+            }
+            if (iconCache[i].pass == iconPass) continue;
+            if (iconCache[i].lastUsed < oldestTime) {
+                oldestTime = iconCache[i].lastUsed;
+                lruIndex = i;
+            }
+        }
 
-    // Check if file exists
-    if (!LittleFS.exists(filePath)) {
-        Serial.printf("[ICON] File not found: %s\n", filePath);
-        return nullptr;
-    }
+        if (freeIndex >= 0 && iconArenaFits(&iconArena, bytes)) {
+            return freeIndex;
+        }
+        if (lruIndex < 0) return -1;
 
-    // Find a cache slot
-    int8_t slot = findLRUSlot();
-    if (slot < 0) {
-        Serial.println("[ICON] No cache slots available");
-        return nullptr;
+        Serial.printf("[ICON] Evicted icon: %s (%u bytes)\n", iconCache[lruIndex].name,
+                      iconCache[lruIndex].bytes);
+        iconFree(&iconCache[lruIndex]);
     }
+}
 
-    CachedIcon* cached = &iconCache[slot];
-
-    // Open file
-    File file = LittleFS.open(filePath, "r");
-    if (!file) {
-        Serial.printf("[ICON] Failed to open: %s\n", filePath);
-        return nullptr;
-    }
+static int32_t pngFileRead(PNGFILE* pngFile, uint8_t* buffer, int32_t length) {
+    File* file = (File*)pngFile->fHandle;
+    int32_t remaining = pngFile->iSize - pngFile->iPos;
+    if (length > remaining) length = remaining;
+    if (length <= 0) return 0;
+    int32_t bytesRead = file->read(buffer, length);
+    pngFile->iPos = file->position();
+    return bytesRead;
+}
 
-    // Read file into buffer
-    size_t fileSize = file.size();
-    uint8_t* fileBuffer = (uint8_t*)malloc(fileSize);
-    if (!fileBuffer) {
-        file.close();
-        Serial.println("[ICON] Failed to allocate file buffer");
-        return nullptr;
-    }
-    file.read(fileBuffer, fileSize);
-    file.close();
+static int32_t pngFileSeek(PNGFILE* pngFile, int32_t position) {
+    File* file = (File*)pngFile->fHandle;
+    file->seek(position);
+    pngFile->iPos = file->position();
+    return pngFile->iPos;
+}
 
-    // Initialize PNG decoder
-    int rc = png.openRAM(fileBuffer, fileSize, pngDrawCallback);
+// PNGdec pulls the file through its own fixed read buffer, the compressed
+// image is never held in RAM
+static bool iconDecodePng(const char* filePath, CachedIcon* entry) {
+    int rc = png.open(filePath, lfsFileOpen, lfsFileClose, pngFileRead, pngFileSeek, pngDrawCallback);
     if (rc != PNG_SUCCESS) {
-        free(fileBuffer);
-        Serial.printf("[ICON] PNG open failed: %d\n", rc);
-        return nullptr;
+        Serial.printf("[ICON] PNG open failed: %s (%d)\n", filePath, rc);
+        return false;
     }
 
     // Get dimensions (limit to 32x32 to preserve RAM)
     uint8_t width = min((int)png.getWidth(), 32);
     uint8_t height = min((int)png.getHeight(), 32);
 
-    // Allocate pixel buffer
-    cached->pixels = (uint16_t*)malloc(width * height * sizeof(uint16_t));
-    if (!cached->pixels) {
+    // Allocate the single frame and its pixels in one block
+    entry->frames = (IconFrame*)malloc(sizeof(IconFrame) + width * height * sizeof(uint16_t));
+    if (!entry->frames) {
         png.close();
-        free(fileBuffer);
         Serial.println("[ICON] Failed to allocate pixel buffer");
-        return nullptr;
+        return false;
     }
+    entry->pixels = (uint16_t*)(entry->frames + 1);
 
     // Set up decode target
-    pngDecodeTarget = cached->pixels;
+    pngDecodeTarget = entry->pixels;
     pngDecodeWidth = width;
+    pngDecodeHeight = height;
 
     // Clear buffer
-    memset(cached->pixels, 0, width * height * sizeof(uint16_t));
+    memset(entry->pixels, 0, width * height * sizeof(uint16_t));
 
     // Decode PNG
     rc = png.decode(NULL, 0);
     png.close();
-    free(fileBuffer);
 
     if (rc != PNG_SUCCESS) {
-        free(cached->pixels);
-        cached->pixels = nullptr;
         Serial.printf("[ICON] PNG decode failed: %d\n", rc);
-        return nullptr;
+        return false;
     }
 
-    // Update cache entry
-    strlcpy(cached->name, name, sizeof(cached->name));
-    cached->width = width;
-    cached->height = height;
-    cached->valid = true;
-    cached->lastUsed = millis();
+    entry->width = width;
+    entry->height = height;
+    entry->frameCount = 1;
+    entry->frames[0].delay = 0;
+    return true;
+}
+
+// GIF icons are decoded once into full frames. Each frame is composed on
+// top of a copy of the previous one, so drawing never needs the decoder.
+struct IconGifDecode {
+    uint16_t* target;           // Frame being composed
+    uint8_t width;
+    uint8_t height;
+    DirtyRect rect;             // Area covered by the frame just decoded
+    uint8_t disposal;
+    bool globalPaletteReady;
+    uint16_t palette[256];
+};
+IconGifDecode* iconGifDecode = nullptr;
+
+static void iconGifDrawLine(GIFDRAW* pDraw) {
+    IconGifDecode* decode = iconGifDecode;
+
+    if (pDraw->y == 0) {
+        gifPackPalette(pDraw, decode->palette, &decode->globalPaletteReady);
+        decode->rect = { (int16_t)pDraw->iX, (int16_t)pDraw->iY,
+                         (int16_t)pDraw->iWidth, (int16_t)pDraw->iHeight };
+        decode->disposal = pDraw->ucDisposalMethod;
+    }
+
+    int16_t y = pDraw->iY + pDraw->y;
+    int16_t width = min((int16_t)pDraw->iWidth, (int16_t)(decode->width - pDraw->iX));
+    if (y >= decode->height || width <= 0) return;
+    gifBlitLine(pDraw, pDraw->pPixels, decode->palette,
+                decode->target + y * decode->width + pDraw->iX, width);
+}
+
+// Restore the area of the last decoded frame from `source` (nullptr = clear)
+static void iconGifRestoreRect(const IconGifDecode* decode, uint16_t* frame, const uint16_t* source) {
+    const DirtyRect& r = decode->rect;
+    int16_t width = min(r.w, (int16_t)(decode->width - r.x));
+    if (width <= 0) return;
+    for (int16_t y = r.y; y < r.y + r.h && y < decode->height; y++) {
+        uint16_t offset = y * decode->width + r.x;
+        if (source) {
+            memcpy(frame + offset, source + offset, width * sizeof(uint16_t));
+        } else {
+            memset(frame + offset, 0, width * sizeof(uint16_t));
+        }
+    }
+}
+
+// Frames in the file, 0 if it does not parse. getInfo() walks the whole
+// file, the decoder is opened again to decode it.
+static int32_t iconGifFrameCount(AnimatedGIF* decoder, const char* filePath) {
+    GIFINFO info;
+    int32_t frames = 0;
+    if (decoder->open(filePath, lfsFileOpen, lfsFileClose, gifFileRead, gifFileSeek, iconGifDrawLine)) {
+        if (decoder->getInfo(&info)) frames = info.iFrameCount;
+        decoder->close();
+    }
+    return frames;
+}
+
+static uint8_t iconGifDecodeFrames(AnimatedGIF* decoder, IconGifDecode* decode, CachedIcon* entry,
+                                   int32_t fileFrames) {
+    decode->width = min(decoder->getCanvasWidth(), 32);
+    decode->height = min(decoder->getCanvasHeight(), 32);
+    decode->disposal = 0;
+    decode->globalPaletteReady = false;
+    if (decode->width == 0 || decode->height == 0) return 0;
+
+    uint16_t framePixels = decode->width * decode->height;
+    uint32_t frameBytes = framePixels * sizeof(uint16_t);
+    // An animation may take at most half of the cache budget
+    uint32_t maxFrames = min((uint32_t)MAX_ICON_FRAMES, (uint32_t)(ICON_CACHE_BUDGET / 2 / frameBytes));
+    if ((uint32_t)fileFrames < maxFrames) maxFrames = fileFrames;
+    if (maxFrames == 0) return 0;
+
+    // Sized once from the header: frames, then their pixels
+    entry->frames = (IconFrame*)malloc(maxFrames * (sizeof(IconFrame) + frameBytes));
+    if (!entry->frames) {
+        Serial.printf("[ICON] Failed to allocate %u GIF frames\n", (unsigned)maxFrames);
+        return 0;
+    }
+    entry->pixels = (uint16_t*)(entry->frames + maxFrames);
+    IconFrame* frames = entry->frames;
+    uint16_t* pixels = entry->pixels;
+    uint8_t count = 0;
+    iconGifDecode = decode;
+
+    while (count < maxFrames) {
+        uint16_t* frame = pixels + count * framePixels;
+        if (count == 0) {
+            memset(frame, 0, frameBytes);
+        } else {
+            memcpy(frame, frame - framePixels, frameBytes);
+            if (decode->disposal == DISPOSE_BACKGROUND) {
+                iconGifRestoreRect(decode, frame, nullptr);
+            } else if (decode->disposal == DISPOSE_PREVIOUS) {
+                iconGifRestoreRect(decode, frame, count >= 2 ? frame - 2 * framePixels : nullptr);
+            }
+        }
+
+        decode->target = frame;
+        decode->disposal = 0;
+        int delayMs = 0;
+        int rc = decoder->playFrame(false, &delayMs);
+        if (rc < 0) {
+            Serial.printf("[ICON] GIF decode error %d at frame %u\n", decoder->getLastError(), count);
+            break;
+        }
+        if (rc == 0 && decoder->getLastError() == GIF_EMPTY_FRAME) break;  // Trailing data
+
+        if (delayMs < GIF_MIN_FRAME_DELAY) delayMs = GIF_DEFAULT_FRAME_DELAY;
+        frames[count].delay = min(delayMs, 60000);
+        count++;
+        if (rc == 0) break;  // Last frame
+    }
+
+    iconGifDecode = nullptr;
+    entry->width = decode->width;
+    entry->height = decode->height;
+    return count;
+}
+
+static bool iconDecodeGif(const char* filePath, CachedIcon* entry) {
+    AnimatedGIF* decoder = gifAllocDecoder();
+    if (!decoder) return false;
+    IconGifDecode* decode = (IconGifDecode*)malloc(sizeof(IconGifDecode));
+    if (!decode) {
+        delete decoder;
+        return false;
+    }
+
+    uint8_t count = 0;
+    int32_t fileFrames = iconGifFrameCount(decoder, filePath);
+    if (fileFrames > 0 &&
+        decoder->open(filePath, lfsFileOpen, lfsFileClose, gifFileRead, gifFileSeek, iconGifDrawLine)) {
+        count = iconGifDecodeFrames(decoder, decode, entry, fileFrames);
+        decoder->close();
+    } else {
+        Serial.printf("[ICON] GIF open failed: %d\n", decoder->getLastError());
+    }
+    free(decode);
+    delete decoder;
 
-    Serial.printf("[ICON] Loaded: %s (%dx%d)\n", name, width, height);
+    // Frames that did not decode are left unused, packing copies the others
+    if (count == 0) return false;
+    entry->frameCount = count;
+    return true;
+}
+
+static uint32_t iconDataSize(uint8_t frameCount, uint8_t width, uint8_t height, uint16_t spanCount) {
+    return frameCount * (sizeof(IconFrame) + width * height * sizeof(uint16_t)) +
+           spanCount * sizeof(IconSpan);
+}
+
+// Point an entry into its single data block (sidecar body layout)
+static void iconAttachData(CachedIcon* entry, uint8_t* data) {
+    entry->data = data;
+    entry->frames = (IconFrame*)data;
+    entry->pixels = (uint16_t*)(data + entry->frameCount * sizeof(IconFrame));
+    entry->spans = (IconSpan*)(entry->pixels + entry->frameCount * entry->width * entry->height);
+    entry->bytes = iconDataSize(entry->frameCount, entry->width, entry->height, entry->spanCount);
+}
+
+static uint16_t iconCountSpans(const CachedIcon* entry) {
+    uint16_t framePixels = entry->width * entry->height;
+    uint16_t total = 0;
+    for (uint8_t f = 0; f < entry->frameCount; f++) {
+        total += buildIconSpans(entry->pixels + f * framePixels, entry->width, entry->height, nullptr);
+    }
+    return total;
+}
+
+// Move decoded frames into `data` (sized for iconCountSpans() runs) and
+// build the opaque runs of every frame for the span blitter
+static void iconPack(CachedIcon* entry, uint8_t* data, uint16_t spanCount) {
+    uint16_t framePixels = entry->width * entry->height;
+    uint16_t* decodedPixels = entry->pixels;
+    IconFrame* decodedFrames = entry->frames;
+    entry->spanCount = spanCount;
+    iconAttachData(entry, data);
+    memcpy(entry->frames, decodedFrames, entry->frameCount * sizeof(IconFrame));
+    memcpy(entry->pixels, decodedPixels, entry->frameCount * framePixels * sizeof(uint16_t));
+    free(decodedFrames);
+
+    uint16_t index = 0;
+    for (uint8_t f = 0; f < entry->frameCount; f++) {
+        entry->frames[f].firstSpan = index;
+        entry->frames[f].spanCount = buildIconSpans(entry->pixels + f * framePixels, entry->width,
+                                                    entry->height, entry->spans + index);
+        index += entry->frames[f].spanCount;
+    }
+}
+
+static void iconSidecarPath(const char* name, char* path, size_t len) {
+    snprintf(path, len, "%s/%s" ICON_FILE_EXT, FS_ICONS_PATH, name);
+}
+
+// Open a sidecar and check its header, the file is left at the body
+static bool iconOpenSidecar(const char* path, File& file, IconFileHeader* header) {
+    if (!LittleFS.exists(path)) return false;
+    file = LittleFS.open(path, "r");
+    if (!file) return false;
+
+    bool ok = file.read((uint8_t*)header, sizeof(*header)) == sizeof(*header) &&
+              header->magic == ICON_FILE_MAGIC && header->version == ICON_FILE_VERSION &&
+              header->colorDepth == COLOR_DEPTH && header->width > 0 && header->height > 0 &&
+              header->frameCount > 0 &&
+              file.size() == sizeof(*header) + iconDataSize(header->frameCount, header->width,
+                                                            header->height, header->spanCount);
+    if (!ok) {
+        file.close();
+        Serial.printf("[ICON] Ignoring invalid sidecar: %s\n", path);
+    }
+    return ok;
+}
+
+// Take the dimensions of a sidecar, returns the size of its body
+static uint32_t iconSetHeader(CachedIcon* entry, const IconFileHeader* header) {
+    entry->width = header->width;
+    entry->height = header->height;
+    entry->frameCount = header->frameCount;
+    entry->spanCount = header->spanCount;
+    return iconDataSize(entry->frameCount, entry->width, entry->height, entry->spanCount);
+}
+
+// Allocate the data block of a reserved slot, compacting the arena when
+// the free space is not contiguous
+static uint8_t* iconAllocData(int8_t slot, uint32_t bytes) {
+    if (!iconArenaFitsTop(&iconArena, bytes)) {
+        // A block being filled unlocked must stay where it is
+        if (iconLoads > 0) return nullptr;
+        iconArenaCompact(&iconArena);
+        // Blocks moved: re-derive the pointers into them
+        for (uint8_t i = 0; i < MAX_ICON_CACHE; i++) {
+            if (iconCache[i].valid) iconAttachData(&iconCache[i], iconCache[i].data);
+        }
+    }
+    return iconArenaAlloc(&iconArena, bytes, &iconCache[slot].data);
+}
+
+static bool iconWriteSidecar(const char* path, const CachedIcon* entry) {
+    IconFileHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = ICON_FILE_MAGIC;
+    header.version = ICON_FILE_VERSION;
+    header.colorDepth = COLOR_DEPTH;
+    header.width = entry->width;
+    header.height = entry->height;
+    header.frameCount = entry->frameCount;
+    header.spanCount = entry->spanCount;
+
+    File file = LittleFS.open(path, "w");
+    if (!file) return false;
+    bool ok = file.write((const uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+              file.write(entry->data, entry->bytes) == entry->bytes;
+    file.close();
+    if (!ok) LittleFS.remove(path);
+    return ok;
+}
+
+// Path of the source image (PNG first, then GIF), false if there is none
+static bool iconSourcePath(const char* name, char* path, size_t len) {
+    snprintf(path, len, "%s/%s.png", FS_ICONS_PATH, name);
+    if (LittleFS.exists(path)) return true;
+    snprintf(path, len, "%s/%s.gif", FS_ICONS_PATH, name);
+    return LittleFS.exists(path);
+}
+
+// Decode the source image, the entry is left unpacked. Caller holds the
+// decoder lock.
+static bool iconDecodeSource(const char* name, CachedIcon* entry) {
+    char filePath[64];
+    if (!iconSourcePath(name, filePath, sizeof(filePath))) {
+        Serial.printf("[ICON] File not found: %s/%s.png|gif\n", FS_ICONS_PATH, name);
+        return false;
+    }
+
+    size_t len = strlen(filePath);
+    bool decoded = strcmp(filePath + len - 4, ".png") == 0 ? iconDecodePng(filePath, entry)
+                                                           : iconDecodeGif(filePath, entry);
+    if (!decoded) {
+        iconFree(entry);
+        return false;
+    }
+    return true;
+}
+
+// Publish a packed entry whose data block belongs to `slot`
+static CachedIcon* iconCommit(int8_t slot, CachedIcon* entry, const char* name) {
+    unsigned long now = millis();
+    strlcpy(entry->name, name, sizeof(entry->name));
+    entry->hash = nameHash(name);
+    entry->valid = true;
+    entry->pass = iconPass;
+    entry->lastUsed = now;
+    entry->nextFrameAt = now + entry->frames[0].delay;
+    iconCache[slot] = *entry;
+    iconIndex.insert(entry->hash, slot);
+
+    CachedIcon* cached = &iconCache[slot];
+    Serial.printf("[ICON] Loaded: %s (%dx%d, %u frame(s), %u bytes, arena %u/%u)\n", name,
+                  cached->width, cached->height, cached->frameCount, cached->bytes,
+                  iconArena.live, iconArena.capacity);
     return cached;
 }
 
-bool isFailedIconDownload(const char* name) {
+static CachedIcon* iconFindCached(const char* name);
+
+// Reserve a slot and its data block for a load that fills it without the
+// state lock, caller holds it. The slot is kept from eviction and the arena
+// from compaction until iconLoadEnd(). Returns the block, *slot is -1 when
+// there is no room.
+static uint8_t* iconLoadBegin(const char* name, uint32_t bytes, int8_t* slot) {
+    *slot = iconReserveSlot(bytes);
+    uint8_t* data = *slot >= 0 ? iconAllocData(*slot, bytes) : nullptr;
+    if (!data) {
+        Serial.printf("[ICON] No room in cache for %s (%u bytes)\n", name, bytes);
+        *slot = -1;
+        return nullptr;
+    }
+    iconCache[*slot].loading = true;
+    iconLoads++;
+    return data;
+}
+
+// Publish the block of a load, caller holds the state lock. It is dropped
+// when the load failed or the icon was cached meanwhile, then nullptr.
+static CachedIcon* iconLoadEnd(int8_t slot, CachedIcon* entry, const char* name, bool ok) {
+    iconCache[slot].loading = false;
+    iconLoads--;
+    if (!ok || iconFindCached(name)) {
+        iconArenaFree(&iconArena, iconCache[slot].data);
+        iconCache[slot].data = nullptr;
+        return nullptr;
+    }
+    iconAttachData(entry, iconCache[slot].data);
+    return iconCommit(slot, entry, name);
+}
+
+// Decode the source image and pack it into a cache block, without the state
+// lock. The frames are decoded into one heap block, the runs are built in
+// the arena; iconLoadEnd() publishes it. False if it does not decode,
+// *slot is -1 if it did but there was no room.
+static bool iconDecodePacked(const char* name, CachedIcon* entry, int8_t* slot) {
+    *slot = -1;
+    if (iconDecodeMutex) xSemaphoreTake(iconDecodeMutex, portMAX_DELAY);
+    bool decoded = iconDecodeSource(name, entry);
+    if (iconDecodeMutex) xSemaphoreGive(iconDecodeMutex);
+    if (!decoded) return false;
+
+    uint16_t spanCount = iconCountSpans(entry);
+    uint8_t* data;
+    {
+        StateLock lock;
+        data = iconLoadBegin(name, iconDataSize(entry->frameCount, entry->width, entry->height, spanCount),
+                             slot);
+    }
+    if (!data) {
+        iconFree(entry);
+        return true;
+    }
+    iconPack(entry, data, spanCount);
+    return true;
+}
+
+static int8_t iconTranscodeFind(const char* name) {
+    for (uint8_t i = 0; i < iconTranscodeCount; i++) {
+        if (strcmp(iconTranscodeQueue[i], name) == 0) return i;
+    }
+    return -1;
+}
+
+// Caller holds the state lock
+static void iconQueueTranscode(const char* name) {
+    if (iconTranscodeFind(name) >= 0) return;
+    // A full queue drops the request, the next cache miss queues it again
+    if (iconTranscodeCount >= ICON_TRANSCODE_QUEUE) return;
+    strlcpy(iconTranscodeQueue[iconTranscodeCount++], name, sizeof(iconTranscodeQueue[0]));
+}
+
+// Caller holds the state lock
+static void iconTranscodeDone(const char* name) {
+    int8_t index = iconTranscodeFind(name);
+    if (index < 0) return;
+    iconTranscodeCount--;
+    memmove(iconTranscodeQueue[index], iconTranscodeQueue[index + 1],
+            (iconTranscodeCount - index) * sizeof(iconTranscodeQueue[0]));
+}
+
+static CachedIcon* iconFindCachedHash(const char* name, uint32_t hash) {
+    uint8_t pos = iconIndex.start(hash);
+    int16_t slot;
+    while ((slot = iconIndex.next(hash, &pos)) >= 0) {
+        if (strcmp(iconCache[slot].name, name) == 0) return &iconCache[slot];
+    }
+    return nullptr;
+}
+
+static CachedIcon* iconFindCached(const char* name) {
+    return iconFindCachedHash(name, nameHash(name));
+}
+
+// Icon id of an lm_<digits> name, 0 for other names
+static uint32_t iconLaMetricId(const char* name) {
+    if (strncmp(name, "lm_", 3) != 0) return 0;
+    const char* idStr = name + 3;
+    if (*idStr == '\0') return 0;
+    for (const char* p = idStr; *p; p++) {
+        if (*p < '0' || *p > '9') return 0;
+    }
+    return strtoul(idStr, nullptr, 10);
+}
+
+// True while `name` is remembered as missing (not found or not decodable)
+static bool iconMissed(const char* name, uint32_t hash) {
     unsigned long now = millis();
-    for (uint8_t i = 0; i < MAX_FAILED_ICON_DOWNLOADS; i++) {
-        if (failedIconDownloads[i].name[0] != '\0' &&
-            strcmp(failedIconDownloads[i].name, name) == 0 &&
-            (now - failedIconDownloads[i].failedAt) < FAILED_ICON_RETRY_DELAY) {
+    for (uint8_t i = 0; i < MAX_ICON_MISSES; i++) {
+        const IconMiss& miss = iconMisses[i];
+        if (miss.hash == hash && miss.name[0] != '\0' && (long)(now - miss.expiresAt) < 0 &&
+            strcmp(miss.name, name) == 0) {
             return true;
         }
     }
     return false;
 }
 
-void addFailedIconDownload(const char* name) {
-    // Find oldest entry to evict
-    uint8_t oldestIndex = 0;
-    unsigned long oldestTime = ULONG_MAX;
-    for (uint8_t i = 0; i < MAX_FAILED_ICON_DOWNLOADS; i++) {
-        if (failedIconDownloads[i].name[0] == '\0') {
-            oldestIndex = i;
+static void iconMissAdd(const char* name, uint32_t hash) {
+    // Reuse an expired entry, else replace the one expiring first
+    unsigned long now = millis();
+    IconMiss* slot = &iconMisses[0];
+    for (uint8_t i = 0; i < MAX_ICON_MISSES; i++) {
+        IconMiss* miss = &iconMisses[i];
+        if (miss->name[0] == '\0' || (long)(now - miss->expiresAt) >= 0) {
+            slot = miss;
             break;
         }
-        if (failedIconDownloads[i].failedAt < oldestTime) {
-            oldestTime = failedIconDownloads[i].failedAt;
-            oldestIndex = i;
+        if ((long)(miss->expiresAt - slot->expiresAt) < 0) slot = miss;
+    }
+    strlcpy(slot->name, name, sizeof(slot->name));
+    slot->hash = hash;
+    slot->expiresAt = now + ICON_MISS_TTL;
+}
+
+static void iconMissForget(const char* name) {
+    uint32_t hash = nameHash(name);
+    for (uint8_t i = 0; i < MAX_ICON_MISSES; i++) {
+        if (iconMisses[i].hash == hash && strcmp(iconMisses[i].name, name) == 0) {
+            iconMisses[i].name[0] = '\0';
         }
     }
-    strlcpy(failedIconDownloads[oldestIndex].name, name, sizeof(failedIconDownloads[oldestIndex].name));
-    failedIconDownloads[oldestIndex].failedAt = millis();
 }
 
-CachedIcon* getIcon(const char* name) {
+// Cache an icon from its sidecar, caller holds the state lock. An icon with
+// only a source image is queued for loop() to decode: the render task never
+// runs the decoders.
+CachedIcon* loadIcon(const char* name) {
+    RENDER_TIMED(TIMING_LOAD_ICON);
     if (!name || strlen(name) == 0) return nullptr;
+    if (!filesystemReady) return nullptr;
 
-    // Search cache first
-    for (uint8_t i = 0; i < MAX_ICON_CACHE; i++) {
-        if (iconCache[i].valid && strcmp(iconCache[i].name, name) == 0) {
-            iconCache[i].lastUsed = millis();
-            return &iconCache[i];
+    char filePath[64];
+    File file;
+    IconFileHeader header;
+    iconSidecarPath(name, filePath, sizeof(filePath));
+    if (!iconOpenSidecar(filePath, file, &header)) {
+        if (iconSourcePath(name, filePath, sizeof(filePath))) {
+            iconQueueTranscode(name);
+        } else {
+            Serial.printf("[ICON] File not found: %s/%s.png|gif\n", FS_ICONS_PATH, name);
+            iconMissAdd(name, nameHash(name));
         }
+        return nullptr;
     }
 
-    // Not in cache, try loading from filesystem
-    CachedIcon* result = loadIcon(name);
-    if (result) return result;
+    CachedIcon entry;
+    memset(&entry, 0, sizeof(entry));
+    uint32_t bytes = iconSetHeader(&entry, &header);
+    int8_t slot = iconReserveSlot(bytes);
+    uint8_t* data = slot >= 0 ? iconAllocData(slot, bytes) : nullptr;
+    if (!data) {
+        Serial.printf("[ICON] No room in cache for %s (%u bytes)\n", name, bytes);
+        file.close();
+        return nullptr;
+    }
 
-    // Auto-download LaMetric icons on demand
-    if (strncmp(name, "lm_", 3) == 0) {
-        const char* idStr = name + 3;
-        // Validate that the rest is numeric
-        bool isNumeric = (*idStr != '\0');
-        for (const char* p = idStr; *p; p++) {
-            if (*p < '0' || *p > '9') { isNumeric = false; break; }
+    bool ok = file.read(data, bytes) == bytes;
+    file.close();
+    if (!ok) {
+        iconArenaFree(&iconArena, data);
+        iconCache[slot].data = nullptr;
+        Serial.printf("[ICON] Failed to read sidecar: %s\n", filePath);
+        return nullptr;
+    }
+    iconAttachData(&entry, data);
+    return iconCommit(slot, &entry, name);
+}
+
+void iconRemoveSidecar(const char* name) {
+    char path[64];
+    iconSidecarPath(name, path, sizeof(path));
+    if (LittleFS.exists(path)) {
+        LittleFS.remove(path);
+    }
+}
+
+// The source image of an icon was written: decode it once, write the
+// sidecar from that and put it in the cache. False if it does not decode.
+// Decoding and the flash write run unlocked, only the install takes the
+// state lock.
+bool iconImport(const char* name) {
+    invalidateCachedIcon(name);
+    iconRemoveSidecar(name);
+
+    CachedIcon entry;
+    memset(&entry, 0, sizeof(entry));
+    int8_t slot;
+    if (!iconDecodePacked(name, &entry, &slot)) return false;
+    // Valid image without room in the cache, loop() decodes it again on the
+    // next cache miss
+    if (slot < 0) return true;
+
+    char path[64];
+    iconSidecarPath(name, path, sizeof(path));
+    if (!iconWriteSidecar(path, &entry)) {
+        Serial.printf("[ICON] Failed to write sidecar: %s\n", path);
+    }
+
+    StateLock lock;
+    // A render may have loaded it from the new sidecar meanwhile
+    iconLoadEnd(slot, &entry, name, true);
+    iconTranscodeDone(name);
+    return true;
+}
+
+// Decodes one queued icon per call, writes its sidecar and caches it, then
+// redraws to replace the placeholder. Only the queue and the install take
+// the state lock.
+void loopIconTranscode() {
+    if (iconTranscodeCount == 0 || !filesystemReady) return;
+
+    char name[32];
+    {
+        StateLock lock;
+        if (iconTranscodeCount == 0) return;
+        strlcpy(name, iconTranscodeQueue[0], sizeof(name));
+    }
+
+    char path[64];
+    iconSidecarPath(name, path, sizeof(path));
+    CachedIcon entry;
+    memset(&entry, 0, sizeof(entry));
+    int8_t slot = -1;
+    bool failed = false;
+    // Imported meanwhile when the sidecar is already there
+    if (!LittleFS.exists(path)) {
+        if (!iconDecodePacked(name, &entry, &slot) || slot < 0) {
+            failed = true;
+        } else if (iconWriteSidecar(path, &entry)) {
+            Serial.printf("[ICON] Sidecar written: %s (%u bytes)\n", path,
+                          (unsigned)(sizeof(IconFileHeader) + entry.bytes));
+        } else {
+            Serial.printf("[ICON] Failed to write sidecar: %s\n", path);
         }
-        if (isNumeric && !isFailedIconDownload(name)) {
-            uint32_t iconId = strtoul(idStr, nullptr, 10);
-            Serial.printf("[ICON] Auto-downloading LaMetric icon: %s (id=%u)\n", name, iconId);
-            if (downloadLaMetricIcon(iconId, name)) {
-                return loadIcon(name);
-            } else {
-                addFailedIconDownload(name);
-                Serial.printf("[ICON] Download failed, blacklisted for %ds: %s\n",
-                              FAILED_ICON_RETRY_DELAY / 1000, name);
-            }
+    }
+
+    StateLock lock;
+    iconTranscodeDone(name);
+    if (failed) {
+        // Backs off like a missing file instead of retrying every frame
+        iconMissAdd(name, nameHash(name));
+    } else if (slot >= 0) {
+        iconLoadEnd(slot, &entry, name, true);
+    }
+    // Swap the placeholder for the icon (or nothing) on the next frame
+    damageInvalidate();
+    lastDisplayUpdate = 0;
+    renderWake();
+}
+
+// Step an animated icon to its next frame once the current one has been
+// shown long enough. Idempotent for a given time, icons shared by several
+// zones advance once per redraw.
+static void iconAdvance(CachedIcon* icon, unsigned long now) {
+    if (icon->frameCount < 2 || (long)(now - icon->nextFrameAt) < 0) return;
+    icon->frame = (icon->frame + 1) % icon->frameCount;
+    uint16_t delay = icon->frames[icon->frame].delay;
+    icon->nextFrameAt += delay;
+    // Off screen for a while or running late: restart the timeline
+    if ((long)(now - icon->nextFrameAt) >= 0) {
+        icon->nextFrameAt = now + delay;
+    }
+}
+
+// True when an animated icon drawn by the last redraw has a frame due
+bool iconAnimationDue(unsigned long now) {
+    for (uint8_t i = 0; i < MAX_ICON_CACHE; i++) {
+        const CachedIcon& icon = iconCache[i];
+        if (icon.valid && icon.frameCount > 1 && icon.pass == iconPass &&
+            (long)(now - icon.nextFrameAt) >= 0) {
+            return true;
         }
     }
+    return false;
+}
+
+// Earliest frame due among the animated icons drawn by the last redraw
+void iconAnimationDeadline(FrameDeadline& next) {
+    for (uint8_t i = 0; i < MAX_ICON_CACHE; i++) {
+        const CachedIcon& icon = iconCache[i];
+        if (icon.valid && icon.frameCount > 1 && icon.pass == iconPass) {
+            next.need(icon.nextFrameAt);
+        }
+    }
+}
+
+CachedIcon* getIcon(const char* name) {
+    if (!name || name[0] == '\0') return nullptr;
+    return getIconHashed(name, nameHash(name));
+}
+
+// getIcon() for a name whose nameHash() is already known
+CachedIcon* getIconHashed(const char* name, uint32_t hash) {
+    RENDER_TIMED(TIMING_GET_ICON);
+
+    // Builtin sprites, then the cache
+    int8_t sprite = weatherSpriteFind(name, hash);
+    if (sprite >= 0) {
+        iconLookupStats.hits++;
+        return &iconAtlas[sprite];
+    }
+    CachedIcon* cached = iconFindCachedHash(name, hash);
+    if (cached) {
+        unsigned long now = millis();
+        cached->lastUsed = now;
+        cached->pass = iconPass;
+        iconAdvance(cached, now);
+        iconLookupStats.hits++;
+        return cached;
+    }
+
+    // Being downloaded: the file may be incomplete
+    uint32_t lametricId = iconLaMetricId(name);
+    if (lametricId && iconDownloadPending(name)) return &iconPlaceholder;
+    // Being decoded by loop()
+    if (iconTranscodeFind(name) >= 0) return &iconPlaceholder;
+
+    // Not in cache, try loading from filesystem unless known to be missing
+    CachedIcon* result = nullptr;
+    if (iconMissed(name, hash)) {
+        iconLookupStats.negativeHits++;
+    } else {
+        iconLookupStats.misses++;
+        result = loadIcon(name);
+        if (result) return result;
+        if (iconTranscodeFind(name) >= 0) return &iconPlaceholder;
+    }
+
+    // Auto-download LaMetric icons in the background
+    if (lametricId && iconDownloadRequest(lametricId, name, false)) {
+        return &iconPlaceholder;
+    }
 
     return nullptr;
 }
 
-void drawIcon(CachedIcon* icon, int16_t x, int16_t y) {
-    if (!icon || !icon->valid || !icon->pixels) return;
+// ============================================================================
+// Icon Prefetch
+// ============================================================================
 
-    // Upscale x2 for small icons (8x8 -> 16x16)
-    uint8_t scale = (icon->width <= 8 && icon->height <= 8) ? 2 : 1;
+// Pick an icon to load ahead of its first draw, the icon worker reads it.
+// True if it needed any work.
+static bool iconPrefetch(const char* name) {
+    if (!name || name[0] == '\0') return false;
+    uint32_t hash = nameHash(name);
+    if (weatherSpriteFind(name, hash) >= 0) return false;
+    if (iconFindCachedHash(name, hash) || iconMissed(name, hash)) return false;
+    uint32_t lametricId = iconLaMetricId(name);
+    if (lametricId && iconDownloadPending(name)) return false;
+    if (iconTranscodeFind(name) >= 0) return false;
+
+    // One at a time, the next scan picks the following icon
+    if (iconPrefetchName[0] != '\0') return true;
+    strlcpy(iconPrefetchName, name, sizeof(iconPrefetchName));
+    if (iconDownloadTaskHandle) xTaskNotifyGive(iconDownloadTaskHandle);
+    return true;
+}
 
-    for (uint8_t py = 0; py < icon->height; py++) {
-        for (uint8_t px = 0; px < icon->width; px++) {
-            uint16_t pixel = icon->pixels[py * icon->width + px];
-            if (pixel != 0) {  // Skip transparent/black pixels
-                if (scale == 2) {
-                    // Draw 2x2 block for each pixel
-                    int16_t dx = x + px * 2;
-                    int16_t dy = y + py * 2;
-                    dma_display->drawPixel(dx, dy, pixel);
-                    dma_display->drawPixel(dx + 1, dy, pixel);
-                    dma_display->drawPixel(dx, dy + 1, pixel);
-                    dma_display->drawPixel(dx + 1, dy + 1, pixel);
-                } else {
-                    dma_display->drawPixel(x + px, y + py, pixel);
-                }
-            }
+// Prefetch the icons an app will draw, stopping after the first pick
+static bool iconPrefetchApp(const AppItem* app) {
+    if (!app) return false;
+    if (app->kind == APP_KIND_TRACKER) {
+        TrackerData* tracker = trackerFind(app->id + strlen(TRACKER_ID_PREFIX));
+        return tracker && iconPrefetch(tracker->icon);
+    }
+    if (iconPrefetch(app->icon)) return true;
+    for (uint8_t i = 0; i + 1 < app->zoneCount && i < 3; i++) {
+        if (iconPrefetch(app->zones[i].icon)) return true;
+    }
+    return false;
+}
+
+// Pick what is shown next during idle frame time, at most one icon per
+// call: the next queued notification, the app it interrupted, then the next
+// app in the rotation. The frame only does lookups, loading is left to the
+// icon worker. Eviction keeps the icons of the last redraw, so what is on
+// screen is never dropped for a prefetch.
+void loopIconPrefetch() {
+    static unsigned long lastScan = 0;
+    unsigned long now = millis();
+    if (now - lastScan < ICON_PREFETCH_INTERVAL) return;
+    lastScan = now;
+    if (!wifiConnected || !filesystemReady || sleepIsActive() || transition.active) return;
+
+    int8_t notifIndex = notifPeekNext();
+    if (notifIndex >= 0 && iconPrefetch(notifications[notifIndex].icon)) return;
+    if (notifGetCurrent() && iconPrefetchApp(appGetCurrent())) return;
+
+    int8_t appIndex = appPeekNext();
+    if (appIndex >= 0) iconPrefetchApp(&apps[appIndex]);
+}
+
+// Load the icon picked by the frame, run by the icon worker. The state
+// lock is held to reserve the cache block, the sidecar is read into it
+// unlocked. An icon with no sidecar goes to the transcode queue. False when
+// none is pending.
+static bool iconPrefetchStep() {
+    char name[32];
+    {
+        StateLock lock;
+        if (iconPrefetchName[0] == '\0') return false;
+        strlcpy(name, iconPrefetchName, sizeof(name));
+    }
+
+    char path[64];
+    File file;
+    IconFileHeader header;
+    iconSidecarPath(name, path, sizeof(path));
+    if (iconOpenSidecar(path, file, &header)) {
+        CachedIcon entry;
+        memset(&entry, 0, sizeof(entry));
+        uint32_t bytes = iconSetHeader(&entry, &header);
+        int8_t slot = -1;
+        uint8_t* data = nullptr;
+        {
+            StateLock lock;
+            // A render may have loaded it meanwhile, then it is on screen
+            if (!iconFindCached(name)) data = iconLoadBegin(name, bytes, &slot);
         }
+        bool ok = data && file.read(data, bytes) == bytes;
+        file.close();
+        if (data && !ok) Serial.printf("[ICON] Failed to read sidecar: %s\n", path);
+
+        StateLock lock;
+        iconPrefetchName[0] = '\0';
+        CachedIcon* icon = data ? iconLoadEnd(slot, &entry, name, ok) : nullptr;
+        if (icon) {
+            // Not stamped with the current pass: it is not on screen yet
+            icon->pass = iconPass - 1;
+            iconPrefetches++;
+        }
+        return true;
     }
+
+    bool source = iconSourcePath(name, path, sizeof(path));
+    StateLock lock;
+    iconPrefetchName[0] = '\0';
+    if (source) {
+        iconQueueTranscode(name);
+    } else {
+        uint32_t lametricId = iconLaMetricId(name);
+        if (!lametricId || !iconDownloadRequest(lametricId, name, false)) {
+            iconMissAdd(name, nameHash(name));
+        }
+    }
+    return true;
 }
 
+void drawIcon(CachedIcon* icon, int16_t x, int16_t y) {
+    if (!icon || !icon->valid) return;
+
+    // Upscale x2 for small icons (8x8 -> 16x16)
+    uint8_t scale = (icon->width <= 8 && icon->height <= 8) ? 2 : 1;
+    drawIconAtScale(icon, x, y, scale);
+}
+
+// Forgets both the decoded copy and a remembered miss
 void invalidateCachedIcon(const char* name) {
     if (!name || strlen(name) == 0) return;
+    StateLock lock;  // Called from upload/download handlers
 
-    for (uint8_t i = 0; i < MAX_ICON_CACHE; i++) {
-        if (iconCache[i].valid && strcmp(iconCache[i].name, name) == 0) {
-            if (iconCache[i].pixels) {
-                free(iconCache[i].pixels);
-                iconCache[i].pixels = nullptr;
-            }
-            iconCache[i].valid = false;
-            iconCache[i].name[0] = '\0';
-            Serial.printf("[ICON] Invalidated cached icon: %s\n", name);
-            return;
-        }
+    iconMissForget(name);
+    CachedIcon* cached = iconFindCached(name);
+    if (cached) {
+        iconFree(cached);
+        cached->name[0] = '\0';
+        damageInvalidate();  // Slot may be reused with the same pointer
+        Serial.printf("[ICON] Invalidated cached icon: %s\n", name);
     }
 }
 
@@ -3061,98 +5092,257 @@ bool validateGifHeader(const uint8_t* data, size_t len) {
             data[3] == '8' && (data[4] == '7' || data[4] == '9') && data[5] == 'a');
 }
 
+// Blocking download and import, run by the download worker. The file is
+// written under a temporary name so renders never load a partial icon.
+// Refused from the render task or under the state lock: a slow server
+// would freeze the display.
 bool downloadLaMetricIcon(uint32_t iconId, const char* saveName) {
+    if (stateLockHeld() || (renderTaskHandle && xTaskGetCurrentTaskHandle() == renderTaskHandle)) {
+        Serial.printf("[LAMETRIC] Download of %u refused on the render path\n", iconId);
+        return false;
+    }
+
     if (!filesystemReady) {
         Serial.println("[LAMETRIC] Filesystem not ready");
         return false;
     }
 
-    WiFiClientSecure client;
-    client.setInsecure();  // Skip certificate verification for simplicity
+    // LAMETRIC_ICON_URL may point to a plain HTTP stand-in
+    String baseUrl = LAMETRIC_ICON_URL;
+    bool secure = baseUrl.startsWith("https://");
+    WiFiClient plainClient;
+    WiFiClientSecure secureClient;
+    secureClient.setInsecure();  // Skip certificate verification for simplicity
+    WiFiClient& client = secure ? secureClient : plainClient;
 
-    HTTPClient https;
+    HTTPClient http;
+    http.setConnectTimeout(ICON_DOWNLOAD_TIMEOUT);
+    http.setTimeout(ICON_DOWNLOAD_TIMEOUT);
     bool isPng = true;
 
     // Try PNG first
-    String url = "https://" LAMETRIC_API_HOST LAMETRIC_ICON_PATH + String(iconId) + ".png";
+    String url = baseUrl + String(iconId) + ".png";
     Serial.printf("[LAMETRIC] Trying PNG: %s\n", url.c_str());
 
-    if (!https.begin(client, url)) {
-        Serial.println("[LAMETRIC] HTTPS begin failed");
+    if (!http.begin(client, url)) {
+        Serial.println("[LAMETRIC] HTTP begin failed");
         return false;
     }
 
-    int httpCode = https.GET();
+    int httpCode = http.GET();
 
     // If PNG not found, try GIF
     if (httpCode != HTTP_CODE_OK) {
-        https.end();
-        url = "https://" LAMETRIC_API_HOST LAMETRIC_ICON_PATH + String(iconId) + ".gif";
+        http.end();
+        url = baseUrl + String(iconId) + ".gif";
         Serial.printf("[LAMETRIC] Trying GIF: %s\n", url.c_str());
 
-        if (!https.begin(client, url)) {
-            Serial.println("[LAMETRIC] HTTPS begin failed");
+        if (!http.begin(client, url)) {
+            Serial.println("[LAMETRIC] HTTP begin failed");
             return false;
         }
 
-        httpCode = https.GET();
+        httpCode = http.GET();
         isPng = false;
     }
 
     if (httpCode != HTTP_CODE_OK) {
         Serial.printf("[LAMETRIC] HTTP error: %d\n", httpCode);
-        https.end();
+        http.end();
         return false;
     }
 
     // Check file size
-    int contentLength = https.getSize();
+    int contentLength = http.getSize();
     if (contentLength > MAX_ICON_SIZE) {
         Serial.printf("[LAMETRIC] Icon too large: %d bytes\n", contentLength);
-        https.end();
+        http.end();
         return false;
     }
 
     // Save file with appropriate extension
     String ext = isPng ? ".png" : ".gif";
     String path = String(FS_ICONS_PATH) + "/" + saveName + ext;
+    String tempPath = path + ".part";
 
-    File file = LittleFS.open(path, "w");
+    File file = LittleFS.open(tempPath, "w");
     if (!file) {
-        Serial.printf("[LAMETRIC] Failed to create file: %s\n", path.c_str());
-        https.end();
+        Serial.printf("[LAMETRIC] Failed to create file: %s\n", tempPath.c_str());
+        http.end();
         return false;
     }
 
-    // Stream response to file
-    WiFiClient* stream = https.getStreamPtr();
+    // Stream response to file, giving up on a stalled server
+    WiFiClient* stream = http.getStreamPtr();
     uint8_t buffer[256];
     size_t totalWritten = 0;
+    unsigned long lastData = millis();
+    bool complete = true;
 
-    while (https.connected() && (contentLength > 0 || contentLength == -1)) {
+    while (http.connected() && (contentLength > 0 || contentLength == -1)) {
         size_t available = stream->available();
         if (available) {
             size_t toRead = min(available, sizeof(buffer));
             size_t bytesRead = stream->readBytes(buffer, toRead);
             file.write(buffer, bytesRead);
             totalWritten += bytesRead;
+            lastData = millis();
             if (contentLength > 0) {
                 contentLength -= bytesRead;
             }
+            if (totalWritten > MAX_ICON_SIZE) {
+                Serial.println("[LAMETRIC] Icon exceeds size limit");
+                complete = false;
+                break;
+            }
+        } else if (millis() - lastData > ICON_DOWNLOAD_TIMEOUT) {
+            Serial.println("[LAMETRIC] Download timed out");
+            complete = false;
+            break;
         } else {
             delay(1);
         }
     }
+    if (contentLength > 0) complete = false;
+
+    file.close();
+    http.end();
+
+    if (!complete || !LittleFS.rename(tempPath, path)) {
+        LittleFS.remove(tempPath);
+        return false;
+    }
+
+    Serial.printf("[LAMETRIC] Downloaded icon %u as %s (%u bytes)\n",
+                  (unsigned)iconId, path.c_str(), (unsigned)totalWritten);
+
+    if (!iconImport(saveName)) {
+        Serial.printf("[LAMETRIC] Icon cannot be decoded: %s\n", path.c_str());
+        LittleFS.remove(path);
+        return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// Icon Downloads
+// ============================================================================
+
+// Caller holds the state lock
+static IconDownload* iconDownloadFind(const char* name) {
+    for (uint8_t i = 0; i < MAX_ICON_DOWNLOADS; i++) {
+        if (iconDownloads[i].state != ICON_DOWNLOAD_FREE && strcmp(iconDownloads[i].name, name) == 0) {
+            return &iconDownloads[i];
+        }
+    }
+    return nullptr;
+}
+
+// Queued or in flight. Caller holds the state lock.
+bool iconDownloadPending(const char* name) {
+    IconDownload* entry = iconDownloadFind(name);
+    return entry && (entry->state == ICON_DOWNLOAD_QUEUED || entry->state == ICON_DOWNLOAD_ACTIVE);
+}
+
+// Queue a download unless the name is already queued, in flight or backing
+// off; `force` (explicit API requests) skips the backoff. Returns false if
+// nothing will be downloaded. Caller holds the state lock.
+bool iconDownloadRequest(uint32_t iconId, const char* name, bool force) {
+    unsigned long now = millis();
+    IconDownload* entry = iconDownloadFind(name);
+    if (entry) {
+        if (entry->state != ICON_DOWNLOAD_FAILED) return true;
+        if (!force && (long)(now - entry->retryAt) < 0) return false;
+    } else {
+        // Free entry first, else forget the failure that is retried soonest
+        for (uint8_t i = 0; i < MAX_ICON_DOWNLOADS && !entry; i++) {
+            if (iconDownloads[i].state == ICON_DOWNLOAD_FREE) entry = &iconDownloads[i];
+        }
+        for (uint8_t i = 0; i < MAX_ICON_DOWNLOADS && !entry; i++) {
+            if (iconDownloads[i].state != ICON_DOWNLOAD_FAILED) continue;
+            if (!entry || (long)(iconDownloads[i].retryAt - entry->retryAt) < 0) {
+                entry = &iconDownloads[i];
+            }
+        }
+        if (!entry) return false;
+        strlcpy(entry->name, name, sizeof(entry->name));
+        entry->failures = 0;
+    }
+
+    entry->iconId = iconId;
+    entry->state = ICON_DOWNLOAD_QUEUED;
+    entry->queuedAt = now;
+    Serial.printf("[ICON] Download queued: %s (id=%u)\n", name, iconId);
+    if (iconDownloadTaskHandle) xTaskNotifyGive(iconDownloadTaskHandle);
+    return true;
+}
+
+// Run the oldest queued download, false when the queue is empty
+static bool iconDownloadStep() {
+    char name[32];
+    uint32_t iconId;
+    {
+        StateLock lock;
+        IconDownload* next = nullptr;
+        for (uint8_t i = 0; i < MAX_ICON_DOWNLOADS; i++) {
+            if (iconDownloads[i].state != ICON_DOWNLOAD_QUEUED) continue;
+            if (!next || (long)(iconDownloads[i].queuedAt - next->queuedAt) < 0) {
+                next = &iconDownloads[i];
+            }
+        }
+        if (!next) return false;
+        next->state = ICON_DOWNLOAD_ACTIVE;
+        strlcpy(name, next->name, sizeof(name));
+        iconId = next->iconId;
+    }
+
+    bool ok = downloadLaMetricIcon(iconId, name);
+
+    StateLock lock;
+    // Active entries are never reused, the entry is still ours
+    IconDownload* entry = iconDownloadFind(name);
+    if (ok) {
+        entry->state = ICON_DOWNLOAD_FREE;
+        iconDownloadsDone++;
+        // Swap the placeholder for the icon on the next frame
+        damageInvalidate();
+        lastDisplayUpdate = 0;
+        renderWake();
+        return true;
+    }
 
-    file.close();
-    https.end();
+    entry->failures++;
+    uint32_t backoff = (uint32_t)ICON_DOWNLOAD_RETRY_MIN << min((int)entry->failures - 1, 10);
+    if (backoff > ICON_DOWNLOAD_RETRY_MAX) backoff = ICON_DOWNLOAD_RETRY_MAX;
+    entry->retryAt = millis() + backoff;
+    entry->state = ICON_DOWNLOAD_FAILED;
+    iconDownloadsFailed++;
+    Serial.printf("[ICON] Download failed (%u in a row), retry in %us: %s\n",
+                  entry->failures, backoff / 1000, name);
+    return true;
+}
 
-    Serial.printf("[LAMETRIC] Downloaded icon %d as %s (%d bytes)\n", iconId, path.c_str(), totalWritten);
+static void iconDownloadTask(void*) {
+    while (true) {
+        if (!iconPrefetchStep() && !iconDownloadStep()) ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+}
 
-    // Invalidate cache if icon with same name was cached
-    invalidateCachedIcon(saveName);
+void setupIconDownloads() {
+    BaseType_t created = xTaskCreatePinnedToCore(iconDownloadTask, "icondl", ICON_DOWNLOAD_TASK_STACK,
+                                                 nullptr, ICON_DOWNLOAD_TASK_PRIORITY,
+                                                 &iconDownloadTaskHandle, ICON_DOWNLOAD_TASK_CORE);
+    if (created != pdPASS) {
+        iconDownloadTaskHandle = nullptr;
+        Serial.println("[ICON] Failed to create download task, downloading from loop()");
+    }
+}
 
-    return true;
+// Fallback when the download task could not be created
+void loopIconDownloads() {
+    if (iconDownloadTaskHandle) return;
+    iconPrefetchStep();
+    iconDownloadStep();
 }
 
 void handleApiIconsList(AsyncWebServerRequest *request) {
@@ -3163,9 +5353,10 @@ void handleApiIconsList(AsyncWebServerRequest *request) {
     if (root && root.isDirectory()) {
         File file = root.openNextFile();
         while (file) {
-            if (!file.isDirectory()) {
+            String filename = String(file.name());
+            // Pre-decoded sidecars and partial downloads are implementation details
+            if (!file.isDirectory() && !filename.endsWith(ICON_FILE_EXT) && !filename.endsWith(".part")) {
                 JsonObject obj = icons.add<JsonObject>();
-                String filename = String(file.name());
                 // Remove path prefix if present
                 int lastSlash = filename.lastIndexOf('/');
                 if (lastSlash >= 0) {
@@ -3216,6 +5407,7 @@ void handleApiIconsDelete(AsyncWebServerRequest *request) {
 
     // Invalidate cache first
     invalidateCachedIcon(name.c_str());
+    iconRemoveSidecar(name.c_str());
 
     // Try to delete PNG or GIF
     String pngPath = String(FS_ICONS_PATH) + "/" + name + ".png";
@@ -3244,16 +5436,14 @@ void setupWiFi() {
     wifiManager.setConfigPortalTimeout(180);
     wifiManager.setAPCallback([](WiFiManager *myWiFiManager) {
         Serial.println("[WIFI] Config portal started");
-        dma_display->clearScreen();
-        dma_display->setTextColor(dma_display->color565(255, 165, 0));
-        dma_display->setCursor(4, 20);
-        dma_display->print("WiFi Setup");
-        dma_display->setTextColor(dma_display->color565(255, 255, 255));
-        dma_display->setCursor(4, 35);
-        dma_display->print(WIFI_AP_NAME);
-        #if DOUBLE_BUFFER
-            dma_display->flipDMABuffer();
-        #endif
+        canvas->fillScreen(0);
+        canvas->setTextColor(panelColor(255, 165, 0));
+        canvas->setCursor(4, 20);
+        canvas->print("WiFi Setup");
+        canvas->setTextColor(panelColor(255, 255, 255));
+        canvas->setCursor(4, 35);
+        canvas->print(WIFI_AP_NAME);
+        displayFlush();
     });
 
     wifiConnected = wifiManager.autoConnect(WIFI_AP_NAME);
@@ -3320,23 +5510,7 @@ void setupWebServer() {
     AsyncCallbackJsonWebHandler* brightnessHandler = new AsyncCallbackJsonWebHandler("/api/brightness",
         [](AsyncWebServerRequest *request, JsonVariant &json) {
             Serial.println("[API] /brightness handler called");
-            JsonObject doc = json.as<JsonObject>();
-
-            if (doc.isNull()) {
-                request->send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
-                return;
-            }
-
-            if (!doc["brightness"].isNull()) {
-                uint8_t brightness = doc["brightness"].as<uint8_t>();
-                displaySetBrightness(brightness);
-                settings.brightness = brightness;
-                saveSettings();
-                Serial.printf("[API] Brightness set to %d\n", brightness);
-                request->send(200, "application/json", "{\"success\":true}");
-            } else {
-                request->send(400, "application/json", "{\"error\":\"Missing brightness\"}");
-            }
+            commandRespond(request, CMD_BRIGHTNESS, 0, "", json, "{\"success\":true}");
         });
     webServer.addHandler(brightnessHandler);
 
@@ -3362,59 +5536,7 @@ void setupWebServer() {
                 return;
             }
 
-            // Check for multi-zone format
-            JsonArray zonesArray = doc["zones"].as<JsonArray>();
-            bool isMultiZone = !zonesArray.isNull() && zonesArray.size() > 0;
-
-            if (isMultiZone) {
-                uint8_t zoneCount = zonesArray.size();
-                if (zoneCount == 1 || zoneCount > MAX_ZONES) {
-                    request->send(400, "application/json",
-                        "{\"error\":\"zones array must have 2, 3, or 4 elements\"}");
-                    return;
-                }
-            }
-
-            // For multi-zone, zone 0 provides the main fields; for single-zone, use top-level fields
-            const char* icon = isMultiZone ? "" : (doc["icon"] | "");
-            uint32_t textColor = isMultiZone ? 0xFFFFFF : parseColorValue(doc["color"], 0xFFFFFF);
-
-            // Parse text field (may be string, {text,color} object, or [{t,c},...] array)
-            char parsedText[64] = "";
-            TextSegment textSegs[MAX_TEXT_SEGMENTS];
-            uint8_t textSegCount = 0;
-            if (!isMultiZone) {
-                parseTextFieldWithSegments(doc["text"], parsedText, sizeof(parsedText),
-                                           textSegs, &textSegCount, textColor);
-            }
-
-            uint16_t duration = doc["duration"] | settings.defaultDuration;
-            uint32_t lifetime = doc["lifetime"] | 0;
-            int8_t priority = doc["priority"] | 0;
-
-            int8_t result = appAdd(name.c_str(), parsedText, icon, textColor,
-                                   duration, lifetime, priority, false);
-
-            if (result >= 0) {
-                if (!isMultiZone) {
-                    // Copy text segments
-                    memcpy(apps[result].textSegments, textSegs, sizeof(textSegs));
-                    apps[result].textSegmentCount = textSegCount;
-                    // Parse label field
-                    parseTextFieldWithSegments(doc["label"], apps[result].label,
-                                               sizeof(apps[result].label),
-                                               apps[result].labelSegments,
-                                               &apps[result].labelSegmentCount, textColor);
-                }
-                // Apply multi-zone data if present
-                if (isMultiZone) {
-                    appSetZones(result, zonesArray);
-                }
-                Serial.printf("[API] Custom app '%s' created/updated\n", name.c_str());
-                request->send(200, "application/json", "{\"success\":true}");
-            } else {
-                request->send(500, "application/json", "{\"error\":\"Failed to add app\"}");
-            }
+            commandRespond(request, CMD_CUSTOM, 0, name.c_str(), json, "{\"success\":true}");
         });
     webServer.addHandler(customHandler);
 
@@ -3426,72 +5548,20 @@ void setupWebServer() {
         }
 
         String name = request->getParam("name")->value();
-        if (appRemove(name.c_str())) {
-            request->send(200, "application/json", "{\"success\":true}");
-        } else {
-            request->send(404, "application/json", "{\"error\":\"App not found or is system app\"}");
-        }
+        commandRespond(request, CMD_CUSTOM_DELETE, 0, name.c_str(), JsonVariant(), "{\"success\":true}");
     });
 
     // POST /api/settings - Update settings (using AsyncCallbackJsonWebHandler)
     AsyncCallbackJsonWebHandler* settingsHandler = new AsyncCallbackJsonWebHandler("/api/settings",
         [](AsyncWebServerRequest *request, JsonVariant &json) {
             Serial.println("[API] /settings handler called");
-            JsonObject doc = json.as<JsonObject>();
-
-            if (doc.isNull()) {
-                request->send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
-                return;
-            }
-
-            // Update settings from JSON
-            if (!doc["brightness"].isNull()) {
-                settings.brightness = doc["brightness"].as<uint8_t>();
-                displaySetBrightness(settings.brightness);
-            }
-            if (!doc["autoRotate"].isNull()) {
-                settings.autoRotate = doc["autoRotate"].as<bool>();
-                appRotationEnabled = settings.autoRotate;
-            }
-            if (!doc["defaultDuration"].isNull()) {
-                settings.defaultDuration = doc["defaultDuration"].as<uint16_t>();
-            }
-
-            bool ntpChanged = false;
-            if (doc["ntp"].is<JsonObject>()) {
-                JsonObject ntpUpdate = doc["ntp"].as<JsonObject>();
-                if (!ntpUpdate["offset"].isNull() || !ntpUpdate["daylight_offset"].isNull()) {
-                    Serial.println("[NTP] Legacy ntp.offset/daylight_offset ignored, use ntp.tz_posix");
-                }
-                if (ntpUpdate["tz_posix"].is<const char*>()) {
-                    const char* tz = ntpUpdate["tz_posix"].as<const char*>();
-                    size_t tzLen = strlen(tz);
-                    if (tzLen == 0 || tzLen >= sizeof(settings.tzPosix)) {
-                        request->send(400, "application/json", "{\"error\":\"tz_posix length invalid\"}");
-                        return;
-                    }
-                    strlcpy(settings.tzPosix, tz, sizeof(settings.tzPosix));
-                    Serial.printf("[NTP] tz_posix updated to %s\n", settings.tzPosix);
-                    ntpChanged = true;
-                }
-                if (ntpUpdate["server"].is<const char*>()) {
-                    strlcpy(settings.ntpServer, ntpUpdate["server"].as<const char*>(), sizeof(settings.ntpServer));
-                    Serial.printf("[NTP] server updated to %s\n", settings.ntpServer);
-                    ntpChanged = true;
-                }
-            }
-            if (ntpChanged) {
-                configTzTime(settings.tzPosix, settings.ntpServer);
-            }
-
-            saveSettings();
-            Serial.println("[API] Settings updated");
-            request->send(200, "application/json", "{\"success\":true}");
+            commandRespond(request, CMD_SETTINGS, 0, "", json, "{\"success\":true}");
         });
     webServer.addHandler(settingsHandler);
 
     // GET /api/weather - Return current weather data
     webServer.on("/api/weather", HTTP_GET, [](AsyncWebServerRequest *request) {
+        StateLock lock;
         JsonDocument doc;
 
         doc["valid"] = weatherData.valid;
@@ -3527,52 +5597,7 @@ void setupWebServer() {
     AsyncCallbackJsonWebHandler* weatherHandler = new AsyncCallbackJsonWebHandler("/api/weather",
         [](AsyncWebServerRequest *request, JsonVariant &json) {
             Serial.println("[API] /weather handler called");
-            JsonObject doc = json.as<JsonObject>();
-
-            if (doc.isNull()) {
-                request->send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
-                return;
-            }
-
-            // Parse current weather
-            if (doc["current"].is<JsonObject>()) {
-                JsonObject current = doc["current"];
-                strlcpy(weatherData.currentIcon, current["icon"] | "", sizeof(weatherData.currentIcon));
-                weatherData.currentTemp = current["temp"] | 0;
-                weatherData.currentTempMin = current["temp_min"] | 0;
-                weatherData.currentTempMax = current["temp_max"] | 0;
-                weatherData.currentHumidity = current["humidity"] | 0;
-            } else {
-                request->send(400, "application/json", "{\"error\":\"Missing 'current' object\"}");
-                return;
-            }
-
-            // Parse forecast (optional, up to MAX_FORECAST_DAYS days)
-            if (doc["forecast"].is<JsonArray>()) {
-                JsonArray forecastArr = doc["forecast"];
-                int forecastSize = min((int)forecastArr.size(), (int)MAX_FORECAST_DAYS);
-                for (int i = 0; i < forecastSize; i++) {
-                    JsonObject fc = forecastArr[i];
-                    strlcpy(weatherData.forecast[i].icon, fc["icon"] | "", sizeof(weatherData.forecast[i].icon));
-                    weatherData.forecast[i].tempMin = fc["temp_min"] | 0;
-                    weatherData.forecast[i].tempMax = fc["temp_max"] | 0;
-                    strlcpy(weatherData.forecast[i].dayName, fc["day"] | "", sizeof(weatherData.forecast[i].dayName));
-                }
-                weatherData.forecastCount = forecastSize;
-            } else {
-                weatherData.forecastCount = 0;
-            }
-
-            // Reset forecast pagination on new data
-            forecastPage = 0;
-            lastForecastPageSwitch = millis();
-
-            weatherData.lastUpdate = millis();
-            weatherData.valid = true;
-
-            Serial.printf("[WEATHER] Updated: %d C, %d%% humidity\n",
-                         weatherData.currentTemp, weatherData.currentHumidity);
-            request->send(200, "application/json", "{\"success\":true}");
+            commandRespond(request, CMD_WEATHER, 0, "", json, "{\"success\":true}");
         });
     webServer.addHandler(weatherHandler);
 
@@ -3583,24 +5608,28 @@ void setupWebServer() {
     // GET /api/trackers - List all active trackers
     webServer.on("/api/trackers", HTTP_GET, [](AsyncWebServerRequest *request) {
         JsonDocument doc;
-        JsonArray arr = doc["trackers"].to<JsonArray>();
-
-        for (uint8_t i = 0; i < MAX_TRACKERS; i++) {
-            if (trackers[i].valid) {
-                JsonObject t = arr.add<JsonObject>();
-                t["name"] = trackers[i].name;
-                t["symbol"] = trackers[i].symbol;
-                t["value"] = trackers[i].currentValue;
-                t["change"] = trackers[i].changePercent;
-                unsigned long ageMs = millis() - trackers[i].lastUpdate;
-                t["age"] = ageMs / 1000;
-                t["stale"] = (ageMs > TRACKER_STALE_TIMEOUT);
+        String output;
+        {
+            SnapshotPin pin;
+            const StateSnapshot* state = pin.state;
+            JsonArray arr = doc["trackers"].to<JsonArray>();
+
+            for (uint8_t i = 0; i < MAX_TRACKERS; i++) {
+                const TrackerData& tracker = state->trackers[i];
+                if (tracker.valid) {
+                    JsonObject t = arr.add<JsonObject>();
+                    t["name"] = tracker.name;
+                    t["symbol"] = tracker.symbol;
+                    t["value"] = tracker.currentValue;
+                    t["change"] = tracker.changePercent;
+                    unsigned long ageMs = millis() - tracker.lastUpdate;
+                    t["age"] = ageMs / 1000;
+                    t["stale"] = (ageMs > TRACKER_STALE_TIMEOUT);
+                }
             }
+            doc["count"] = state->trackerCount;
+            serializeJson(doc, output);
         }
-        doc["count"] = trackerCount;
-
-        String output;
-        serializeJson(doc, output);
         request->send(200, "application/json", output);
     });
 
@@ -3612,7 +5641,14 @@ void setupWebServer() {
         }
 
         String name = request->getParam("name")->value();
-        TrackerData* tracker = trackerFind(name.c_str());
+        SnapshotPin pin;
+        const TrackerData* tracker = nullptr;
+        for (uint8_t i = 0; i < MAX_TRACKERS; i++) {
+            if (pin.state->trackers[i].valid && strcmp(pin.state->trackers[i].name, name.c_str()) == 0) {
+                tracker = &pin.state->trackers[i];
+                break;
+            }
+        }
 
         if (!tracker) {
             request->send(404, "application/json", "{\"error\":\"Tracker not found\"}");
@@ -3658,11 +5694,7 @@ void setupWebServer() {
         }
 
         String name = request->getParam("name")->value();
-        if (trackerRemove(name.c_str())) {
-            request->send(200, "application/json", "{\"success\":true}");
-        } else {
-            request->send(404, "application/json", "{\"error\":\"Tracker not found\"}");
-        }
+        commandRespond(request, CMD_TRACKER_DELETE, 0, name.c_str(), JsonVariant(), "{\"success\":true}");
     });
 
     // POST /api/tracker?name=btc - Create/update tracker
@@ -3687,75 +5719,7 @@ void setupWebServer() {
                 return;
             }
 
-            // Allocate or find existing tracker
-            TrackerData* tracker = trackerAllocate(name.c_str());
-            if (!tracker) {
-                request->send(500, "application/json", "{\"error\":\"No tracker slot available\"}");
-                return;
-            }
-
-            // Parse fields
-            if (!doc["symbol"].isNull()) {
-                strlcpy(tracker->symbol, doc["symbol"] | "", sizeof(tracker->symbol));
-            }
-            if (!doc["icon"].isNull()) {
-                strlcpy(tracker->icon, doc["icon"] | "", sizeof(tracker->icon));
-            }
-            if (!doc["currency"].isNull()) {
-                strlcpy(tracker->currencySymbol, doc["currency"] | "", sizeof(tracker->currencySymbol));
-            }
-            if (!doc["value"].isNull()) {
-                tracker->currentValue = doc["value"].as<float>();
-            }
-            if (!doc["change"].isNull()) {
-                tracker->changePercent = doc["change"].as<float>();
-            }
-            if (!doc["bottomText"].isNull()) {
-                strlcpy(tracker->bottomText, doc["bottomText"] | "", sizeof(tracker->bottomText));
-            }
-
-            tracker->symbolColor = parseColorValue(doc["symbolColor"], tracker->symbolColor);
-            tracker->sparklineColor = parseColorValue(doc["sparklineColor"], tracker->sparklineColor);
-
-            // Parse sparkline data (float array -> scaled uint16)
-            if (doc["sparkline"].is<JsonArray>()) {
-                JsonArray sparkArr = doc["sparkline"];
-                uint8_t count = min((int)sparkArr.size(), (int)MAX_SPARKLINE_POINTS);
-
-                if (count >= 2) {
-                    // Find min/max of float values
-                    float minVal = sparkArr[0].as<float>();
-                    float maxVal = minVal;
-                    for (uint8_t i = 1; i < count; i++) {
-                        float v = sparkArr[i].as<float>();
-                        if (v < minVal) minVal = v;
-                        if (v > maxVal) maxVal = v;
-                    }
-
-                    float range = maxVal - minVal;
-                    if (range < 0.0001f) range = 1.0f;
-
-                    // Scale to uint16 (0-65535)
-                    for (uint8_t i = 0; i < count; i++) {
-                        float normalized = (sparkArr[i].as<float>() - minVal) / range;
-                        tracker->sparkline[i] = (uint16_t)(normalized * 65535.0f);
-                    }
-                    tracker->sparklineCount = count;
-                }
-            }
-
-            tracker->lastUpdate = millis();
-
-            // Register/update app in rotation
-            char appId[32];
-            snprintf(appId, sizeof(appId), "%s%s", TRACKER_ID_PREFIX, name.c_str());
-            uint16_t duration = doc["duration"] | (uint16_t)DEFAULT_APP_DURATION;
-            appAdd(appId, tracker->symbol, tracker->icon, 0xFFFFFF,
-                   duration, 0, 0, false);
-
-            Serial.printf("[TRACKER] Updated: %s (%s = %.2f)\n",
-                         name.c_str(), tracker->symbol, tracker->currentValue);
-            request->send(200, "application/json", "{\"success\":true}");
+            commandRespond(request, CMD_TRACKER, 0, name.c_str(), json, "{\"success\":true}");
         });
     webServer.addHandler(trackerHandler);
 
@@ -3766,6 +5730,7 @@ void setupWebServer() {
     webServer.on("/api/sleep", HTTP_GET, [](AsyncWebServerRequest *request)
     {
         Serial.println("[API] /sleep GET");
+        StateLock lock;
 
         JsonDocument doc;
         bool active = sleepIsActive();
@@ -3794,33 +5759,14 @@ void setupWebServer() {
         [](AsyncWebServerRequest *request, JsonVariant &json)
         {
             Serial.println("[API] /sleep POST");
-
-            JsonObject body = json.as<JsonObject>();
-            if (body.isNull())
-            {
-                request->send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
-                return;
-            }
-
-            String errorMessage;
-            if (!applySleepUpdate(body, errorMessage))
-            {
-                JsonDocument errorDoc;
-                errorDoc["error"] = errorMessage;
-                String output;
-                serializeJson(errorDoc, output);
-                request->send(400, "application/json", output);
-                return;
-            }
-            request->send(200, "application/json", "{\"success\":true}");
+            commandRespond(request, CMD_SLEEP, 0, "", json, "{\"success\":true}");
         });
     webServer.addHandler(sleepHandler);
 
     webServer.on("/api/sleep/wake", HTTP_POST, [](AsyncWebServerRequest *request)
     {
         Serial.println("[API] /sleep/wake POST");
-        wakeNow();
-        request->send(200, "application/json", "{\"success\":true}");
+        commandRespond(request, CMD_WAKE, 0, "", JsonVariant(), "{\"success\":true}");
     });
 
     // ========================================================================
@@ -3830,38 +5776,37 @@ void setupWebServer() {
     // POST /api/notify/dismiss - Dismiss current notification
     // IMPORTANT: Must be registered BEFORE /api/notify JSON handler to avoid prefix match
     webServer.on("/api/notify/dismiss", HTTP_POST, [](AsyncWebServerRequest *request) {
-        if (notifDismiss()) {
-            resetNotifScrollState();
-            request->send(200, "application/json", "{\"success\":true}");
-        } else {
-            request->send(404, "application/json", "{\"error\":\"No active notification\"}");
-        }
+        commandRespond(request, CMD_DISMISS, 0, "", JsonVariant(), "{\"success\":true}");
     });
 
     // GET /api/notify/list - List all active notifications
     // IMPORTANT: Must be registered BEFORE /api/notify JSON handler to avoid prefix match
     webServer.on("/api/notify/list", HTTP_GET, [](AsyncWebServerRequest *request) {
         JsonDocument doc;
-        doc["count"] = notificationCount;
-        doc["currentIndex"] = currentNotifIndex;
-
-        JsonArray arr = doc["notifications"].to<JsonArray>();
-        for (uint8_t i = 0; i < MAX_NOTIFICATIONS; i++) {
-            if (!notifications[i].active) continue;
-            JsonObject obj = arr.add<JsonObject>();
-            obj["id"] = notifications[i].id;
-            obj["text"] = notifications[i].text;
-            obj["icon"] = notifications[i].icon;
-            obj["duration"] = notifications[i].duration;
-            obj["hold"] = notifications[i].hold;
-            obj["urgent"] = notifications[i].urgent;
-            obj["stack"] = notifications[i].stack;
-            obj["displayed"] = notifications[i].displayedAt > 0;
-            obj["current"] = (i == (uint8_t)currentNotifIndex);
-        }
-
         String output;
-        serializeJson(doc, output);
+        {
+            SnapshotPin pin;
+            const StateSnapshot* state = pin.state;
+            doc["count"] = state->notificationCount;
+            doc["currentIndex"] = state->currentNotifIndex;
+
+            JsonArray arr = doc["notifications"].to<JsonArray>();
+            for (uint8_t i = 0; i < MAX_NOTIFICATIONS; i++) {
+                const NotificationItem& notif = state->notifications[i];
+                if (!notif.active) continue;
+                JsonObject obj = arr.add<JsonObject>();
+                obj["id"] = notif.id;
+                obj["text"] = notif.text;
+                obj["icon"] = notif.icon;
+                obj["duration"] = notif.duration;
+                obj["hold"] = notif.hold;
+                obj["urgent"] = notif.urgent;
+                obj["stack"] = notif.stack;
+                obj["displayed"] = notif.displayedAt > 0;
+                obj["current"] = (i == (uint8_t)state->currentNotifIndex);
+            }
+            serializeJson(doc, output);
+        }
         request->send(200, "application/json", output);
     });
 
@@ -3871,59 +5816,30 @@ void setupWebServer() {
             Serial.println("[API] /notify handler called");
             JsonObject doc = json.as<JsonObject>();
 
-            if (doc.isNull()) {
-                request->send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
-                return;
-            }
-
-            // Text is required
-            if (doc["text"].isNull() || strlen(doc["text"] | "") == 0) {
-                request->send(400, "application/json", "{\"error\":\"Missing text\"}");
-                return;
-            }
-
-            const char* text = doc["text"] | "";
-            const char* id = doc["id"] | "";
-            const char* icon = doc["icon"] | "";
-            uint32_t textColor = parseColorValue(doc["color"], 0xFFFFFF);
-            uint32_t bgColor = parseColorValue(doc["background"], 0x000000);
-            uint16_t duration = doc["duration"] | (uint16_t)DEFAULT_NOTIF_DURATION;
-            bool hold = doc["hold"] | false;
-            bool urgent = doc["urgent"] | false;
-            bool stack = doc["stack"] | true;
-
-            int8_t slot = notifAdd(id, text, icon, textColor, bgColor,
-                                   duration, hold, urgent, stack);
-
-            if (slot < 0) {
-                request->send(503, "application/json", "{\"error\":\"Notification queue full\"}");
-                return;
+            // The ID is assigned here so it can be returned before the command runs
+            char id[sizeof(Command::name)];
+            const char* requestedId = doc["id"] | "";
+            if (requestedId[0] != '\0') {
+                strlcpy(id, requestedId, sizeof(id));
+            } else {
+                snprintf(id, sizeof(id), "notif_%lu", millis());
             }
 
-            // Return the assigned ID
             char response[128];
-            snprintf(response, sizeof(response),
-                     "{\"success\":true,\"id\":\"%s\"}", notifications[slot].id);
-            request->send(200, "application/json", response);
+            snprintf(response, sizeof(response), "{\"success\":true,\"id\":\"%s\"}", id);
+            commandRespond(request, CMD_NOTIFY, 0, id, json, response);
         });
     webServer.addHandler(notifyHandler);
 
     // DELETE /api/indicator{1-3} - Turn off indicator
-    webServer.on("/api/indicator1", HTTP_DELETE, [](AsyncWebServerRequest *request) {
-        indicatorOff(0); saveSettings();
-        Serial.println("[API] Indicator 1 turned off (DELETE)");
-        request->send(200, "application/json", "{\"success\":true,\"mode\":\"off\"}");
-    });
-    webServer.on("/api/indicator2", HTTP_DELETE, [](AsyncWebServerRequest *request) {
-        indicatorOff(1); saveSettings();
-        Serial.println("[API] Indicator 2 turned off (DELETE)");
-        request->send(200, "application/json", "{\"success\":true,\"mode\":\"off\"}");
-    });
-    webServer.on("/api/indicator3", HTTP_DELETE, [](AsyncWebServerRequest *request) {
-        indicatorOff(2); saveSettings();
-        Serial.println("[API] Indicator 3 turned off (DELETE)");
-        request->send(200, "application/json", "{\"success\":true,\"mode\":\"off\"}");
-    });
+    for (uint8_t idx = 0; idx < NUM_INDICATORS; idx++) {
+        String path = "/api/indicator" + String(idx + 1);
+        webServer.on(path.c_str(), HTTP_DELETE, [idx](AsyncWebServerRequest *request) {
+            Serial.printf("[API] Indicator %d turned off (DELETE)\n", idx + 1);
+            commandRespond(request, CMD_INDICATOR_OFF, idx, "", JsonVariant(),
+                           "{\"success\":true,\"mode\":\"off\"}");
+        });
+    }
 
     // POST /api/indicator{1-3} - Set corner indicators
     for (uint8_t idx = 0; idx < NUM_INDICATORS; idx++) {
@@ -3938,6 +5854,15 @@ void setupWebServer() {
     }
     Serial.println("[WEB] Indicator API endpoints registered");
 
+    // POST /api/batch - Several app/tracker/weather/notify/indicator/brightness
+    // operations, applied together in one frame
+    AsyncCallbackJsonWebHandler* batchHandler = new AsyncCallbackJsonWebHandler("/api/batch",
+        [](AsyncWebServerRequest *request, JsonVariant &json) {
+            handleBatchApi(request, json);
+        });
+    batchHandler->setMethod(HTTP_POST);
+    webServer.addHandler(batchHandler);
+
     // POST /api/reboot - Reboot device (deferred to allow response to be sent)
     webServer.on("/api/reboot", HTTP_POST, [](AsyncWebServerRequest *request) {
         Serial.println("[API] Reboot requested");
@@ -3988,12 +5913,14 @@ void setupWebServer() {
             // Use provided name or icon ID as name
             String name = doc["name"] | String(iconId);
 
-            Serial.printf("[API] LaMetric download request: id=%d, name=%s\n", iconId, name.c_str());
+            Serial.printf("[API] LaMetric download request: id=%u, name=%s\n", (unsigned)iconId, name.c_str());
 
-            if (downloadLaMetricIcon(iconId, name.c_str())) {
-                request->send(200, "application/json", "{\"success\":true}");
+            // Downloaded by the worker, the icon list shows it once imported
+            StateLock lock;
+            if (iconDownloadRequest(iconId, name.c_str(), true)) {
+                request->send(202, "application/json", "{\"success\":true,\"queued\":true}");
             } else {
-                request->send(500, "application/json", "{\"error\":\"Failed to download icon from LaMetric\"}");
+                request->send(503, "application/json", "{\"error\":\"Download queue full\"}");
             }
         });
     webServer.addHandler(lametricHandler);
@@ -4002,13 +5929,16 @@ void setupWebServer() {
     webServer.on("/api/icons", HTTP_POST,
         // Completion handler
         [](AsyncWebServerRequest *request) {
-            if (uploadValid && uploadSize > 0) {
-                Serial.printf("[ICON] Upload complete: %s (%d bytes)\n",
-                              uploadIconName.c_str(), uploadSize);
+            // Decoding validates the whole file and fills the cache
+            if (uploadValid && uploadSize > 0 && iconImport(uploadIconName.c_str())) {
+                Serial.printf("[ICON] Upload complete: %s (%u bytes)\n",
+                              uploadIconName.c_str(), (unsigned)uploadSize);
                 request->send(200, "application/json", "{\"success\":true}");
             } else {
                 // Clean up failed upload
                 if (uploadIconName.length() > 0) {
+                    invalidateCachedIcon(uploadIconName.c_str());
+                    iconRemoveSidecar(uploadIconName.c_str());
                     String path = String(FS_ICONS_PATH) + "/" + uploadIconName + ".png";
                     if (LittleFS.exists(path)) {
                         LittleFS.remove(path);
@@ -4082,10 +6012,6 @@ void setupWebServer() {
             // Final chunk
             if (final && uploadFile) {
                 uploadFile.close();
-                if (uploadValid) {
-                    // Invalidate cached icon
-                    invalidateCachedIcon(uploadIconName.c_str());
-                }
             }
         }
     );
@@ -4113,11 +6039,7 @@ void setupWebServer() {
                 return;
             }
             String name = request->getParam("name")->value();
-            if (trackerRemove(name.c_str())) {
-                request->send(200, "application/json", "{\"success\":true}");
-            } else {
-                request->send(404, "application/json", "{\"error\":\"Tracker not found\"}");
-            }
+            commandRespond(request, CMD_TRACKER_DELETE, 0, name.c_str(), JsonVariant(), "{\"success\":true}");
             return;
         }
         if (method == HTTP_DELETE_METHOD && url.startsWith("/api/indicator")) {
@@ -4125,10 +6047,9 @@ void setupWebServer() {
             char lastChar = url.charAt(url.length() - 1);
             uint8_t idx = lastChar - '1';  // '1'->0, '2'->1, '3'->2
             if (idx < NUM_INDICATORS) {
-                indicatorOff(idx);
-                saveSettings();
                 Serial.printf("[API] Indicator %d turned off (DELETE)\n", idx + 1);
-                request->send(200, "application/json", "{\"success\":true,\"mode\":\"off\"}");
+                commandRespond(request, CMD_INDICATOR_OFF, idx, "", JsonVariant(),
+                               "{\"success\":true,\"mode\":\"off\"}");
             } else {
                 request->send(400, "application/json", "{\"error\":\"Invalid indicator number\"}");
             }
@@ -4140,11 +6061,7 @@ void setupWebServer() {
                 return;
             }
             String name = request->getParam("name")->value();
-            if (appRemove(name.c_str())) {
-                request->send(200, "application/json", "{\"success\":true}");
-            } else {
-                request->send(404, "application/json", "{\"error\":\"App not found or is system app\"}");
-            }
+            commandRespond(request, CMD_CUSTOM_DELETE, 0, name.c_str(), JsonVariant(), "{\"success\":true}");
             return;
         }
 
@@ -4174,6 +6091,7 @@ void setupWebServer() {
 }
 
 void handleApiStats(AsyncWebServerRequest *request) {
+    StateLock lock;
     JsonDocument doc;
 
     doc["version"] = VERSION_STRING;
@@ -4186,7 +6104,77 @@ void handleApiStats(AsyncWebServerRequest *request) {
     doc["wifi"]["ip"] = WiFi.localIP().toString();
     doc["display"]["width"] = DISPLAY_WIDTH;
     doc["display"]["height"] = DISPLAY_HEIGHT;
-    doc["mqtt"]["connected"] = mqttConnected;
+    doc["display"]["frames"] = displayFrameStats.frames;
+    doc["display"]["partialFrames"] = displayFrameStats.partialFrames;
+    doc["display"]["pixelsTouched"] = displayFrameStats.lastPixelsTouched;
+    doc["display"]["pixelsTouchedAvg"] = displayFrameStats.frames > 0
+        ? (uint32_t)(displayFrameStats.totalPixelsTouched / displayFrameStats.frames) : 0;
+    doc["display"]["pixelsPushed"] = displayFrameStats.lastPixelsPushed;
+    doc["display"]["spansPushed"] = displayFrameStats.lastSpansPushed;
+    doc["display"]["render"]["core"] = RENDER_TASK_CORE;
+    doc["display"]["render"]["periodMs"] = RENDER_FRAME_PERIOD;
+    doc["display"]["render"]["idlePeriodMs"] = RENDER_IDLE_PERIOD;
+    doc["display"]["render"]["frames"] = renderStats.frames;
+    doc["display"]["render"]["wakeups"] = renderStats.wakeups;
+    doc["display"]["render"]["frameRate"] = renderStats.frameRate;
+    doc["display"]["render"]["busyPermille"] = renderStats.busyPermille;
+    doc["display"]["render"]["ingestUs"] = renderStats.ingestAvgUs;
+    doc["display"]["render"]["ingestMaxUs"] = renderStats.ingestMaxUs;
+    doc["display"]["render"]["jitterUs"] = renderStats.jitterAvgUs;
+    doc["display"]["render"]["jitterMaxUs"] = renderStats.jitterMaxUs;
+    doc["display"]["render"]["frameUs"] = renderStats.frameUs;
+    doc["display"]["render"]["frameMaxUs"] = renderStats.frameMaxUs;
+    doc["display"]["render"]["overruns"] = renderStats.overruns;
+    doc["display"]["gif"]["playing"] = gifPlayer.open;
+    doc["display"]["gif"]["frames"] = gifPlayer.frames;
+    doc["display"]["gif"]["lateFrames"] = gifPlayer.lateFrames;
+    doc["display"]["gif"]["decoderBytes"] = gifPlayer.decoder ? sizeof(AnimatedGIF) : 0;
+    uint8_t iconsCached = 0;
+    for (uint8_t i = 0; i < MAX_ICON_CACHE; i++) {
+        if (iconCache[i].valid) iconsCached++;
+    }
+    doc["icons"]["cached"] = iconsCached;
+    doc["icons"]["slots"] = MAX_ICON_CACHE;
+    doc["icons"]["bytes"] = iconArena.live;
+    doc["icons"]["budget"] = iconArena.capacity;
+    doc["icons"]["lookups"]["hits"] = iconLookupStats.hits;
+    doc["icons"]["lookups"]["misses"] = iconLookupStats.misses;
+    doc["icons"]["lookups"]["negativeHits"] = iconLookupStats.negativeHits;
+    doc["icons"]["prefetched"] = iconPrefetches;
+    doc["icons"]["arena"]["top"] = iconArena.top;
+    doc["icons"]["arena"]["free"] = iconArena.capacity - iconArena.live;
+    doc["icons"]["arena"]["largestFree"] = iconArenaLargestFree(&iconArena);
+    doc["icons"]["arena"]["fragmentation"] = iconArenaFragmentation(&iconArena);
+    doc["icons"]["arena"]["compactions"] = iconArena.compactions;
+    uint8_t downloadsQueued = 0;
+    uint8_t downloadsBackoff = 0;
+    for (uint8_t i = 0; i < MAX_ICON_DOWNLOADS; i++) {
+        if (iconDownloads[i].state == ICON_DOWNLOAD_QUEUED || iconDownloads[i].state == ICON_DOWNLOAD_ACTIVE) {
+            downloadsQueued++;
+        } else if (iconDownloads[i].state == ICON_DOWNLOAD_FAILED) {
+            downloadsBackoff++;
+        }
+    }
+    doc["icons"]["downloads"]["pending"] = downloadsQueued;
+    doc["icons"]["downloads"]["backoff"] = downloadsBackoff;
+    doc["icons"]["downloads"]["done"] = iconDownloadsDone;
+    doc["icons"]["downloads"]["failed"] = iconDownloadsFailed;
+    doc["mqtt"]["connected"] = mqttConnected.load();
+    doc["mqtt"]["connects"] = mqttConnects;
+    doc["mqtt"]["failures"] = mqttConnectFailures;
+    doc["mqtt"]["backoff"] = mqttConnected ? 0 : mqttBackoff;
+    doc["mqtt"]["outbox"]["depth"] = mqttOutbox.depth();
+    doc["mqtt"]["outbox"]["highWater"] = mqttOutbox.highWater.load(std::memory_order_relaxed);
+    doc["mqtt"]["outbox"]["drops"] = mqttOutbox.drops.load(std::memory_order_relaxed);
+    doc["commands"]["applied"] = commandsApplied;
+    doc["commands"]["rejected"] = commandsRejected;
+    doc["commands"]["batches"] = batchesApplied;
+    buildCommandQueueJson(doc["commands"]["rest"].to<JsonObject>(), restCommands);
+    buildCommandQueueJson(doc["commands"]["mqtt"].to<JsonObject>(), mqttCommands);
+    doc["snapshot"]["version"] = snapshotVersion;
+    doc["snapshot"]["copies"] = STATE_SNAPSHOT_COPIES;
+    doc["snapshot"]["publishes"] = snapshotPublishes;
+    doc["snapshot"]["deferrals"] = snapshotDeferrals;
     doc["apps"]["count"] = appCount;
     doc["apps"]["current"] = currentAppIndex >= 0 ? apps[currentAppIndex].id : "";
     doc["apps"]["rotationEnabled"] = appRotationEnabled;
@@ -4195,18 +6183,40 @@ void handleApiStats(AsyncWebServerRequest *request) {
         doc["filesystem"]["total"] = LittleFS.totalBytes();
         doc["filesystem"]["used"] = LittleFS.usedBytes();
     }
+    buildTimingJson(doc["timing"].to<JsonObject>());
 
     String response;
     serializeJson(doc, response);
     request->send(200, "application/json", response);
 }
 
+void buildCommandQueueJson(JsonObject root, const CommandQueue& queue) {
+    root["depth"] = queue.depth();
+    root["highWater"] = queue.highWater.load(std::memory_order_relaxed);
+    root["drops"] = queue.drops.load(std::memory_order_relaxed);
+}
+
+// Render function timings in microseconds (inclusive of nested calls)
+void buildTimingJson(JsonObject root) {
+    for (uint8_t i = 0; i < TIMING_COUNT; i++) {
+        const TimingHistogram* h = &renderTimings[i];
+        if (h->count == 0) continue;
+        JsonObject entry = root[RENDER_TIMING_NAMES[i]].to<JsonObject>();
+        entry["count"] = h->count;
+        entry["p50Us"] = timingPercentile(h, 50);
+        entry["p95Us"] = timingPercentile(h, 95);
+        entry["maxUs"] = h->maxUs;
+    }
+}
+
 void handleApiSettings(AsyncWebServerRequest *request) {
+    StateLock lock;
     JsonDocument doc;
 
     doc["brightness"] = settings.brightness;
     doc["autoRotate"] = settings.autoRotate;
     doc["defaultDuration"] = settings.defaultDuration;
+    doc["transition"] = transitionToString(settings.transition);
     doc["display"]["width"] = DISPLAY_WIDTH;
     doc["display"]["height"] = DISPLAY_HEIGHT;
     doc["ntp"]["server"] = settings.ntpServer;
@@ -4220,72 +6230,79 @@ void handleApiSettings(AsyncWebServerRequest *request) {
 }
 
 void handleApiApps(AsyncWebServerRequest *request) {
+    SnapshotPin pin;
+    const StateSnapshot* state = pin.state;
     JsonDocument doc;
     JsonArray appsArray = doc["apps"].to<JsonArray>();
 
     for (uint8_t i = 0; i < MAX_APPS; i++) {
-        if (apps[i].active) {
+        const AppItem& app = state->apps[i];
+        if (app.active) {
             JsonObject appObj = appsArray.add<JsonObject>();
-            appObj["id"] = apps[i].id;
-            appObj["icon"] = apps[i].icon;
-            appObj["duration"] = apps[i].duration;
-            appObj["lifetime"] = apps[i].lifetime;
-            appObj["priority"] = apps[i].priority;
-            appObj["isSystem"] = apps[i].isSystem;
-            appObj["isCurrent"] = (currentAppIndex == i);
+            appObj["id"] = app.id;
+            appObj["icon"] = app.icon;
+            if (app.gif[0] != '\0') {
+                appObj["gif"] = app.gif;
+            }
+            appObj["duration"] = app.duration;
+            appObj["lifetime"] = app.lifetime;
+            appObj["priority"] = app.priority;
+            appObj["transition"] = transitionToString(app.transition);
+            appObj["isSystem"] = app.isSystem;
+            appObj["isCurrent"] = (state->currentAppIndex == i);
 
             // Color as hex string
             char colorHex[8];
-            formatColorHex(apps[i].textColor, colorHex, sizeof(colorHex));
+            formatColorHex(app.textColor, colorHex, sizeof(colorHex));
             appObj["color"] = colorHex;
 
             // Text and label in polymorphic format
-            serializeTextField(appObj, "text", apps[i].text,
-                               apps[i].textSegments, apps[i].textSegmentCount);
-            if (apps[i].label[0] != '\0') {
-                serializeTextField(appObj, "label", apps[i].label,
-                                   apps[i].labelSegments, apps[i].labelSegmentCount);
+            serializeTextField(appObj, "text", app.text,
+                               app.textSegments, app.textSegmentCount);
+            if (app.label[0] != '\0') {
+                serializeTextField(appObj, "label", app.label,
+                                   app.labelSegments, app.labelSegmentCount);
             }
 
             // Multi-zone data
-            if (apps[i].zoneCount >= 2) {
-                appObj["zoneCount"] = apps[i].zoneCount;
+            if (app.zoneCount >= 2) {
+                appObj["zoneCount"] = app.zoneCount;
                 JsonArray zonesArr = appObj["zones"].to<JsonArray>();
                 // Zone 0 from main fields
                 JsonObject z0 = zonesArr.add<JsonObject>();
-                serializeTextField(z0, "text", apps[i].text,
-                                   apps[i].textSegments, apps[i].textSegmentCount);
-                z0["icon"] = apps[i].icon;
-                if (apps[i].label[0] != '\0') {
-                    serializeTextField(z0, "label", apps[i].label,
-                                       apps[i].labelSegments, apps[i].labelSegmentCount);
+                serializeTextField(z0, "text", app.text,
+                                   app.textSegments, app.textSegmentCount);
+                z0["icon"] = app.icon;
+                if (app.label[0] != '\0') {
+                    serializeTextField(z0, "label", app.label,
+                                       app.labelSegments, app.labelSegmentCount);
                 }
                 char z0ColorHex[8];
-                formatColorHex(apps[i].textColor, z0ColorHex, sizeof(z0ColorHex));
+                formatColorHex(app.textColor, z0ColorHex, sizeof(z0ColorHex));
                 z0["color"] = z0ColorHex;
                 // Zones 1-N
-                for (uint8_t z = 1; z < apps[i].zoneCount; z++) {
+                for (uint8_t z = 1; z < app.zoneCount; z++) {
                     JsonObject zObj = zonesArr.add<JsonObject>();
-                    serializeTextField(zObj, "text", apps[i].zones[z - 1].text,
-                                       apps[i].zones[z - 1].textSegments,
-                                       apps[i].zones[z - 1].textSegmentCount);
-                    zObj["icon"] = apps[i].zones[z - 1].icon;
-                    if (apps[i].zones[z - 1].label[0] != '\0') {
-                        serializeTextField(zObj, "label", apps[i].zones[z - 1].label,
-                                           apps[i].zones[z - 1].labelSegments,
-                                           apps[i].zones[z - 1].labelSegmentCount);
+                    serializeTextField(zObj, "text", app.zones[z - 1].text,
+                                       app.zones[z - 1].textSegments,
+                                       app.zones[z - 1].textSegmentCount);
+                    zObj["icon"] = app.zones[z - 1].icon;
+                    if (app.zones[z - 1].label[0] != '\0') {
+                        serializeTextField(zObj, "label", app.zones[z - 1].label,
+                                           app.zones[z - 1].labelSegments,
+                                           app.zones[z - 1].labelSegmentCount);
                     }
                     char zColorHex[8];
-                    formatColorHex(apps[i].zones[z - 1].textColor, zColorHex, sizeof(zColorHex));
+                    formatColorHex(app.zones[z - 1].textColor, zColorHex, sizeof(zColorHex));
                     zObj["color"] = zColorHex;
                 }
             }
         }
     }
 
-    doc["count"] = appCount;
-    doc["currentIndex"] = currentAppIndex;
-    doc["rotationEnabled"] = appRotationEnabled;
+    doc["count"] = state->appCount;
+    doc["currentIndex"] = state->currentAppIndex;
+    doc["rotationEnabled"] = state->appRotationEnabled;
 
     String response;
     serializeJson(doc, response);
@@ -4296,31 +6313,29 @@ void handleApiApps(AsyncWebServerRequest *request) {
 // MQTT Functions
 // ============================================================================
 
-void setupMQTT() {
-    if (!settings.mqttEnabled || strlen(settings.mqttServer) == 0) {
-        Serial.println("[MQTT] Disabled or no server configured");
-        return;
-    }
-
-    mqttClient.setServer(settings.mqttServer, settings.mqttPort);
-    mqttClient.setCallback(mqttCallback);
-    mqttClient.setBufferSize(MQTT_BUFFER_SIZE);
-    mqttClient.setKeepAlive(MQTT_KEEPALIVE);
-
-    Serial.printf("[MQTT] Configured: %s:%d (prefix: %s)\n",
-                  settings.mqttServer, settings.mqttPort, settings.mqttPrefix);
-
-    mqttConnect();
+// MQTT task (or loop() without one): take the settings written since the
+// last call. True when the copy changed.
+static bool mqttConfigLoad() {
+    if (!mqttConfigChanged.exchange(false)) return false;
+
+    StateLock lock;
+    mqttConfig.enabled = settings.mqttEnabled;
+    strlcpy(mqttConfig.server, settings.mqttServer, sizeof(mqttConfig.server));
+    mqttConfig.port = settings.mqttPort;
+    strlcpy(mqttConfig.user, settings.mqttUser, sizeof(mqttConfig.user));
+    strlcpy(mqttConfig.password, settings.mqttPassword, sizeof(mqttConfig.password));
+    strlcpy(mqttConfig.prefix, settings.mqttPrefix, sizeof(mqttConfig.prefix));
+    return true;
 }
 
 bool mqttConnect() {
-    if (!settings.mqttEnabled || strlen(settings.mqttServer) == 0) {
+    if (!mqttConfig.enabled || strlen(mqttConfig.server) == 0) {
         return false;
     }
 
     // Build LWT topic
     char lwtTopic[96];
-    snprintf(lwtTopic, sizeof(lwtTopic), "%s%s", settings.mqttPrefix, MQTT_TOPIC_STATUS);
+    snprintf(lwtTopic, sizeof(lwtTopic), "%s%s", mqttConfig.prefix, MQTT_TOPIC_STATUS);
 
     // Build unique client ID from MAC address
     char clientId[32];
@@ -4331,8 +6346,8 @@ bool mqttConnect() {
     Serial.printf("[MQTT] Connecting as %s...\n", clientId);
 
     bool connected = false;
-    if (strlen(settings.mqttUser) > 0) {
-        connected = mqttClient.connect(clientId, settings.mqttUser, settings.mqttPassword,
+    if (strlen(mqttConfig.user) > 0) {
+        connected = mqttClient.connect(clientId, mqttConfig.user, mqttConfig.password,
                                        lwtTopic, 0, true, "offline");
     } else {
         connected = mqttClient.connect(clientId, lwtTopic, 0, true, "offline");
@@ -4340,54 +6355,150 @@ bool mqttConnect() {
 
     if (connected) {
         mqttConnected = true;
-        lastMqttReconnectAttempt = millis();
+        mqttFailures = 0;
+        mqttBackoff = 0;
+        mqttConnects++;
 
         // Publish online status (retained)
         mqttClient.publish(lwtTopic, "online", true);
 
         // Subscribe to all topics under prefix
         char subscribeTopic[96];
-        snprintf(subscribeTopic, sizeof(subscribeTopic), "%s/#", settings.mqttPrefix);
+        snprintf(subscribeTopic, sizeof(subscribeTopic), "%s/#", mqttConfig.prefix);
         mqttClient.subscribe(subscribeTopic);
 
         Serial.printf("[MQTT] Connected, subscribed to %s\n", subscribeTopic);
         return true;
     } else {
         mqttConnected = false;
-        Serial.printf("[MQTT] Connection failed, rc=%d\n", mqttClient.state());
-        lastMqttReconnectAttempt = millis();
+        mqttConnectFailures++;
+        if (mqttFailures < 255) mqttFailures++;
+
+        // Exponential backoff with equal jitter, so devices that lost the
+        // broker together do not all come back in the same second
+        uint32_t backoff = (uint32_t)MQTT_BACKOFF_MIN << min((int)mqttFailures - 1, 10);
+        if (backoff > MQTT_BACKOFF_MAX) backoff = MQTT_BACKOFF_MAX;
+        mqttBackoff = backoff / 2 + random(backoff / 2 + 1);
+        mqttRetryAt = millis() + mqttBackoff;
+        Serial.printf("[MQTT] Connection failed, rc=%d, retry in %lu ms\n",
+                      mqttClient.state(), (unsigned long)mqttBackoff);
         return false;
     }
 }
 
-void loopMQTT() {
-    if (!settings.mqttEnabled || !wifiConnected) return;
-
-    if (mqttClient.connected()) {
-        mqttClient.loop();
+// One pass of the client: connect when due, poll the socket for incoming
+// messages (mqttCallback() queues them for the frame) and send the outbox
+static void mqttStep() {
+    if (mqttConfigLoad()) {
+        // New broker or credentials: drop the session and connect afresh
+        if (mqttClient.connected()) mqttClient.disconnect();
+        mqttConnected = false;
+        mqttClient.setServer(mqttConfig.server, mqttConfig.port);
+        mqttFailures = 0;
+        mqttBackoff = 0;
+        mqttRetryAt = millis();
+        Serial.printf("[MQTT] Configured: %s:%d (prefix: %s)\n",
+                      mqttConfig.server, mqttConfig.port, mqttConfig.prefix);
+    }
 
-        // Periodic stats publish
-        if (millis() - lastStatsPublish > MQTT_STATS_INTERVAL) {
-            mqttPublishStats();
-            lastStatsPublish = millis();
-        }
-    } else {
+    if (!mqttConfig.enabled || !wifiConnected) {
         mqttConnected = false;
+        return;
+    }
 
-        // Reconnect with delay
-        if (millis() - lastMqttReconnectAttempt > MQTT_RECONNECT_DELAY) {
-            Serial.println("[MQTT] Attempting reconnection...");
-            mqttConnect();
+    if (!mqttClient.connected()) {
+        if (mqttConnected) {
+            mqttConnected = false;
+            Serial.printf("[MQTT] Connection lost, rc=%d\n", mqttClient.state());
         }
+        if ((long)(millis() - mqttRetryAt) < 0) return;
+        if (!mqttConnect()) return;
+    }
+
+    mqttClient.loop();
+
+    for (MqttMessage* msg = mqttOutbox.peek(); msg && mqttClient.connected(); msg = mqttOutbox.peek()) {
+        char fullTopic[96];
+        snprintf(fullTopic, sizeof(fullTopic), "%s%s", mqttConfig.prefix, msg->topic);
+
+        // Streamed, so the payload does not have to fit the client buffer
+        bool sent = mqttClient.beginPublish(fullTopic, msg->length, msg->retained) &&
+                    mqttClient.write((const uint8_t*)msg->payload, msg->length) == msg->length &&
+                    mqttClient.endPublish();
+        if (!sent) Serial.printf("[MQTT] Publish failed: %s\n", fullTopic);
+        mqttOutbox.release();
+    }
+}
+
+static void mqttTask(void*) {
+    while (true) {
+        mqttStep();
+        // Woken early by mqttQueue()
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(MQTT_TASK_PERIOD));
     }
 }
 
+void setupMQTT() {
+    mqttConfigLoad();
+    if (!mqttConfig.enabled || strlen(mqttConfig.server) == 0) {
+        Serial.println("[MQTT] Disabled or no server configured");
+        return;
+    }
+
+    mqttClient.setServer(mqttConfig.server, mqttConfig.port);
+    mqttClient.setCallback(mqttCallback);
+    mqttClient.setBufferSize(MQTT_BUFFER_SIZE);
+    mqttClient.setKeepAlive(MQTT_KEEPALIVE);
+    mqttClient.setSocketTimeout(MQTT_CONNECT_TIMEOUT);
+    wifiClient.setTimeout(MQTT_CONNECT_TIMEOUT);
+
+    Serial.printf("[MQTT] Configured: %s:%d (prefix: %s)\n",
+                  mqttConfig.server, mqttConfig.port, mqttConfig.prefix);
+
+    // The task owns the client from here on, a dead broker stalls it and
+    // never loop() or the render task
+    BaseType_t created = xTaskCreatePinnedToCore(mqttTask, "mqtt", MQTT_TASK_STACK,
+                                                 nullptr, MQTT_TASK_PRIORITY,
+                                                 &mqttTaskHandle, MQTT_TASK_CORE);
+    if (created != pdPASS) {
+        mqttTaskHandle = nullptr;
+        Serial.println("[MQTT] Failed to create client task, polling from loop()");
+    }
+}
+
+void loopMQTT() {
+    // Fallback when the client task could not be created
+    if (!mqttTaskHandle) mqttStep();
+
+    // Periodic stats publish
+    if (mqttConnected && millis() - lastStatsPublish > MQTT_STATS_INTERVAL) {
+        mqttPublishStats();
+        lastStatsPublish = millis();
+    }
+}
+
+// Hand a message to the client task. False when the outbox is full or the
+// payload is larger than a slot. Single producer: loop().
+bool mqttQueue(const char* topic, const char* payload, size_t length, bool retained) {
+    if (length > MQTT_BUFFER_SIZE) return false;
+    MqttMessage* msg = mqttOutbox.reserve();
+    if (!msg) return false;
+
+    strlcpy(msg->topic, topic, sizeof(msg->topic));
+    msg->retained = retained;
+    msg->length = length;
+    memcpy(msg->payload, payload, length);
+    mqttOutbox.publish();
+    if (mqttTaskHandle) xTaskNotifyGive(mqttTaskHandle);
+    return true;
+}
+
 void mqttCallback(char* topic, byte* payload, unsigned int length) {
-    Serial.printf("[MQTT] Message on topic: %s (%d bytes)\n", topic, length);
+    Serial.printf("[MQTT] Message on topic: %s (%u bytes)\n", topic, length);
 
     // Strip prefix to get relative topic
-    size_t prefixLen = strlen(settings.mqttPrefix);
-    if (strncmp(topic, settings.mqttPrefix, prefixLen) != 0) {
+    size_t prefixLen = strlen(mqttConfig.prefix);
+    if (strncmp(topic, mqttConfig.prefix, prefixLen) != 0) {
         Serial.println("[MQTT] Ignoring message outside prefix");
         return;
     }
@@ -4399,107 +6510,68 @@ void mqttCallback(char* topic, byte* payload, unsigned int length) {
         return;
     }
 
-    // Topics that need no JSON payload
-    if (strcmp(relativeTopic, MQTT_TOPIC_DISMISS) == 0) {
-        mqttHandleDismiss();
-        return;
-    }
     if (strcmp(relativeTopic, MQTT_TOPIC_REBOOT) == 0) {
-        mqttHandleReboot();
-        return;
-    }
-    if (strcmp(relativeTopic, MQTT_TOPIC_WAKE) == 0) {
-        wakeNow();
-        return;
-    }
-
-    // Parse JSON payload for all other topics
-    JsonDocument doc;
-    DeserializationError error = deserializeJson(doc, payload, length);
-    if (error) {
-        Serial.printf("[MQTT] JSON parse error: %s\n", error.c_str());
+        Serial.println("[MQTT] Reboot requested");
+        pendingReboot = true;
+        rebootRequestTime = millis();
         return;
     }
-    JsonObject obj = doc.as<JsonObject>();
 
-    // Route to handler based on relative topic
-    if (strcmp(relativeTopic, MQTT_TOPIC_NOTIFY) == 0) {
-        mqttHandleNotify(obj);
+    // Everything else is queued for the render frame, which parses the payload
+    uint8_t type;
+    uint8_t index = 0;
+    const char* name = "";
+    if (strcmp(relativeTopic, MQTT_TOPIC_DISMISS) == 0) {
+        type = CMD_DISMISS;
+    } else if (strcmp(relativeTopic, MQTT_TOPIC_WAKE) == 0) {
+        type = CMD_WAKE;
+    } else if (strcmp(relativeTopic, MQTT_TOPIC_NOTIFY) == 0) {
+        type = CMD_NOTIFY;
     } else if (strcmp(relativeTopic, MQTT_TOPIC_BRIGHTNESS) == 0) {
-        mqttHandleBrightness(obj);
+        type = CMD_BRIGHTNESS;
     } else if (strcmp(relativeTopic, MQTT_TOPIC_SETTINGS) == 0) {
-        mqttHandleSettings(obj);
+        type = CMD_SETTINGS;
     } else if (strcmp(relativeTopic, MQTT_TOPIC_WEATHER) == 0) {
-        mqttHandleWeather(obj);
+        type = CMD_WEATHER;
     } else if (strcmp(relativeTopic, MQTT_TOPIC_CUSTOM) == 0) {
         // /custom with name in JSON body
-        const char* name = obj["name"] | "";
-        if (strlen(name) > 0) {
-            if (obj["delete"] | false) {
-                mqttHandleCustomDelete(name);
-            } else {
-                mqttHandleCustom(name, obj);
-            }
-        } else {
-            Serial.println("[MQTT] /custom missing name");
-        }
+        type = CMD_CUSTOM;
     } else if (strncmp(relativeTopic, MQTT_TOPIC_CUSTOM "/", strlen(MQTT_TOPIC_CUSTOM) + 1) == 0) {
         // /custom/{name}
-        const char* name = relativeTopic + strlen(MQTT_TOPIC_CUSTOM) + 1;
-        if (strlen(name) > 0) {
-            if (obj["delete"] | false) {
-                mqttHandleCustomDelete(name);
-            } else {
-                mqttHandleCustom(name, obj);
-            }
-        }
+        type = CMD_CUSTOM;
+        name = relativeTopic + strlen(MQTT_TOPIC_CUSTOM) + 1;
+        if (strlen(name) == 0) return;
     } else if (strcmp(relativeTopic, MQTT_TOPIC_TRACKER) == 0) {
         // /tracker with name in JSON body
-        const char* name = obj["name"] | "";
-        if (strlen(name) > 0) {
-            if (obj["delete"] | false) {
-                mqttHandleTrackerDelete(name);
-            } else {
-                mqttHandleTracker(name, obj);
-            }
-        } else {
-            Serial.println("[MQTT] /tracker missing name");
-        }
+        type = CMD_TRACKER;
     } else if (strncmp(relativeTopic, MQTT_TOPIC_TRACKER "/", strlen(MQTT_TOPIC_TRACKER) + 1) == 0) {
         // /tracker/{name}
-        const char* name = relativeTopic + strlen(MQTT_TOPIC_TRACKER) + 1;
-        if (strlen(name) > 0) {
-            if (obj["delete"] | false) {
-                mqttHandleTrackerDelete(name);
-            } else {
-                mqttHandleTracker(name, obj);
-            }
-        }
+        type = CMD_TRACKER;
+        name = relativeTopic + strlen(MQTT_TOPIC_TRACKER) + 1;
+        if (strlen(name) == 0) return;
     } else if (strncmp(relativeTopic, MQTT_TOPIC_INDICATOR, strlen(MQTT_TOPIC_INDICATOR)) == 0) {
         // /indicator1, /indicator2, /indicator3
         const char* indexStr = relativeTopic + strlen(MQTT_TOPIC_INDICATOR);
         int idx = atoi(indexStr);
-        if (idx >= 1 && idx <= NUM_INDICATORS) {
-            mqttHandleIndicator(idx - 1, obj);
-        } else {
+        if (idx < 1 || idx > NUM_INDICATORS) {
             Serial.printf("[MQTT] Invalid indicator index: %s\n", indexStr);
-        }
-    } else if (strcmp(relativeTopic, MQTT_TOPIC_SLEEP) == 0) {
-        if (!obj["until"].is<unsigned long>() && !obj["until"].is<long>()) {
-            Serial.println("[MQTT] /sleep payload missing or non-integer 'until'");
             return;
         }
-        uint32_t requestedUntil = obj["until"].as<uint32_t>();
-        JsonDocument overrideDoc;
-        JsonObject overrideBody = overrideDoc.to<JsonObject>();
-        overrideBody["sleep_until"] = requestedUntil;
-        String errorMessage;
-        if (!applySleepUpdate(overrideBody, errorMessage)) {
-            Serial.printf("[MQTT] /sleep rejected (until=%lu): %s\n",
-                          (unsigned long)requestedUntil, errorMessage.c_str());
-        }
+        type = CMD_INDICATOR;
+        index = idx - 1;
+    } else if (strcmp(relativeTopic, MQTT_TOPIC_SLEEP) == 0) {
+        type = CMD_SLEEP_UNTIL;
+    } else if (strcmp(relativeTopic, MQTT_TOPIC_BATCH) == 0) {
+        // Array of operations, same format as POST /api/batch
+        type = CMD_BATCH;
     } else {
         Serial.printf("[MQTT] Unknown topic: %s\n", relativeTopic);
+        return;
+    }
+
+    if (!commandHasBody(type)) length = 0;
+    if (!commandPost(mqttCommands, type, index, name, (const char*)payload, length)) {
+        Serial.printf("[MQTT] Dropped %s: command queue full or payload too large\n", relativeTopic);
     }
 }
 
@@ -4514,46 +6586,218 @@ void mqttPublishStats() {
     doc["appCount"] = appCount;
     doc["version"] = VERSION_STRING;
 
+    stateLock();
     if (currentAppIndex >= 0 && currentAppIndex < appCount) {
         doc["currentApp"] = apps[currentAppIndex].id;
     }
-
-    char fullTopic[96];
-    snprintf(fullTopic, sizeof(fullTopic), "%s%s", settings.mqttPrefix, MQTT_TOPIC_STATS);
+    buildTimingJson(doc["timing"].to<JsonObject>());
+    stateUnlock();
 
     String payload;
     serializeJson(doc, payload);
-    mqttClient.publish(fullTopic, payload.c_str());
+    if (!mqttQueue(MQTT_TOPIC_STATS, payload.c_str(), payload.length(), false)) {
+        Serial.println("[MQTT] Stats dropped: outbox full or payload too large");
+    }
 }
 
-// --- MQTT Topic Handlers ---
+// ============================================================================
+// Commands
+// ============================================================================
 
-void mqttHandleBrightness(JsonObject& doc) {
-    if (doc["brightness"].isNull()) {
-        Serial.println("[MQTT] /brightness missing brightness value");
-        return;
+static bool commandHasBody(uint8_t type) {
+    switch (type) {
+        case CMD_CUSTOM_DELETE:
+        case CMD_DISMISS:
+        case CMD_INDICATOR_OFF:
+        case CMD_TRACKER_DELETE:
+        case CMD_WAKE:
+            return false;
+        default:
+            return true;
+    }
+}
+
+// Checks that only look at the payload, so REST handlers can answer 400
+// without touching the state. The frame runs them again on MQTT payloads.
+static bool commandValidate(uint8_t type, JsonObject doc, String& errorOut) {
+    if (!commandHasBody(type)) return true;
+    if (doc.isNull()) {
+        errorOut = "Invalid JSON";
+        return false;
+    }
+
+    switch (type) {
+        case CMD_BRIGHTNESS:
+            if (doc["brightness"].isNull()) {
+                errorOut = "Missing brightness";
+                return false;
+            }
+            break;
+
+        case CMD_SETTINGS:
+            if (!doc["transition"].isNull() &&
+                transitionFromString(doc["transition"] | "", TRANSITION_GLOBAL) == TRANSITION_GLOBAL) {
+                errorOut = "Invalid transition";
+                return false;
+            }
+            if (doc["ntp"]["tz_posix"].is<const char*>()) {
+                size_t tzLen = strlen(doc["ntp"]["tz_posix"].as<const char*>());
+                if (tzLen == 0 || tzLen >= sizeof(settings.tzPosix)) {
+                    errorOut = "tz_posix length invalid";
+                    return false;
+                }
+            }
+            break;
+
+        case CMD_CUSTOM: {
+            JsonArray zonesArray = doc["zones"].as<JsonArray>();
+            if (!zonesArray.isNull() && (zonesArray.size() == 1 || zonesArray.size() > MAX_ZONES)) {
+                errorOut = "zones array must have 2, 3, or 4 elements";
+                return false;
+            }
+            break;
+        }
+
+        case CMD_NOTIFY:
+            if (strlen(doc["text"] | "") == 0) {
+                errorOut = "Missing text";
+                return false;
+            }
+            break;
+
+        case CMD_INDICATOR: {
+            IndicatorMode mode;
+            if (!indicatorModeFromBody(doc, &mode)) {
+                errorOut = "Invalid mode. Use: off, solid, blink, fade";
+                return false;
+            }
+            break;
+        }
+
+        case CMD_WEATHER:
+            if (!doc["current"].is<JsonObject>()) {
+                errorOut = "Missing 'current' object";
+                return false;
+            }
+            break;
+
+        case CMD_SLEEP: {
+            SleepSchedule probe = {};
+            return sleepParseUpdate(doc, probe, errorOut);
+        }
+
+        case CMD_SLEEP_UNTIL:
+            if (!doc["until"].is<unsigned long>() && !doc["until"].is<long>()) {
+                errorOut = "Missing or non-integer 'until'";
+                return false;
+            }
+            break;
+    }
+    return true;
+}
+
+// Operations a batch may carry, each with the payload of its MQTT topic
+static const struct {
+    const char* op;
+    uint8_t type;
+} BATCH_OPS[] = {
+    { "custom",     CMD_CUSTOM },
+    { "tracker",    CMD_TRACKER },
+    { "weather",    CMD_WEATHER },
+    { "notify",     CMD_NOTIFY },
+    { "indicator",  CMD_INDICATOR },
+    { "brightness", CMD_BRIGHTNESS },
+};
+
+// Resolve one batch operation: {"op": "custom", "name": "...", ...payload}.
+// custom/tracker take {"delete": true}, indicator an "index" from 1 to 3.
+static bool batchOpParse(JsonObject op, uint8_t* type, uint8_t* index, String& errorOut) {
+    if (op.isNull()) {
+        errorOut = "Operation must be an object";
+        return false;
+    }
+
+    const char* name = op["op"] | "";
+    uint8_t i = 0;
+    while (i < sizeof(BATCH_OPS) / sizeof(BATCH_OPS[0]) && strcmp(BATCH_OPS[i].op, name) != 0) i++;
+    if (i == sizeof(BATCH_OPS) / sizeof(BATCH_OPS[0])) {
+        errorOut = "Unknown op. Use: custom, tracker, weather, notify, indicator, brightness";
+        return false;
+    }
+    *type = BATCH_OPS[i].type;
+    *index = 0;
+
+    if (*type == CMD_INDICATOR) {
+        int idx = op["index"] | 0;
+        if (idx < 1 || idx > NUM_INDICATORS) {
+            errorOut = "Invalid indicator index";
+            return false;
+        }
+        *index = idx - 1;
     }
 
+    if ((*type == CMD_CUSTOM || *type == CMD_TRACKER) && strlen(op["name"] | "") == 0) {
+        errorOut = "Missing name";
+        return false;
+    }
+    return commandValidate(*type, op, errorOut);
+}
+
+static void applyBrightness(JsonObject doc) {
     uint8_t brightness = doc["brightness"].as<uint8_t>();
     displaySetBrightness(brightness);
     settings.brightness = brightness;
     saveSettings();
-    Serial.printf("[MQTT] Brightness set to %d\n", brightness);
+    Serial.printf("[CMD] Brightness set to %d\n", brightness);
 }
 
-void mqttHandleCustom(const char* name, JsonObject& doc) {
-    // Check for multi-zone format
-    JsonArray zonesArray = doc["zones"].as<JsonArray>();
-    bool isMultiZone = !zonesArray.isNull() && zonesArray.size() > 0;
+static void applySettings(JsonObject doc) {
+    if (!doc["brightness"].isNull()) {
+        settings.brightness = doc["brightness"].as<uint8_t>();
+        displaySetBrightness(settings.brightness);
+    }
+    if (!doc["autoRotate"].isNull()) {
+        settings.autoRotate = doc["autoRotate"].as<bool>();
+        appRotationEnabled = settings.autoRotate;
+        stateVersion++;
+    }
+    if (!doc["defaultDuration"].isNull()) {
+        settings.defaultDuration = doc["defaultDuration"].as<uint16_t>();
+    }
+    if (!doc["transition"].isNull()) {
+        settings.transition = (TransitionType)transitionFromString(doc["transition"] | "", TRANSITION_GLOBAL);
+    }
 
-    if (isMultiZone) {
-        uint8_t zoneCount = zonesArray.size();
-        if (zoneCount == 1 || zoneCount > MAX_ZONES) {
-            Serial.println("[MQTT] /custom zones array must have 2, 3, or 4 elements");
-            return;
+    bool ntpChanged = false;
+    if (doc["ntp"].is<JsonObject>()) {
+        JsonObject ntpUpdate = doc["ntp"].as<JsonObject>();
+        if (!ntpUpdate["offset"].isNull() || !ntpUpdate["daylight_offset"].isNull()) {
+            Serial.println("[NTP] Legacy ntp.offset/daylight_offset ignored, use ntp.tz_posix");
+        }
+        if (ntpUpdate["tz_posix"].is<const char*>()) {
+            strlcpy(settings.tzPosix, ntpUpdate["tz_posix"].as<const char*>(), sizeof(settings.tzPosix));
+            Serial.printf("[NTP] tz_posix updated to %s\n", settings.tzPosix);
+            ntpChanged = true;
         }
+        if (ntpUpdate["server"].is<const char*>()) {
+            strlcpy(settings.ntpServer, ntpUpdate["server"].as<const char*>(), sizeof(settings.ntpServer));
+            Serial.printf("[NTP] server updated to %s\n", settings.ntpServer);
+            ntpChanged = true;
+        }
+    }
+    if (ntpChanged) {
+        configTzTime(settings.tzPosix, settings.ntpServer);
     }
 
+    saveSettings();
+    Serial.println("[CMD] Settings updated");
+}
+
+static void applyCustom(const char* name, JsonObject doc) {
+    // Check for multi-zone format
+    JsonArray zonesArray = doc["zones"].as<JsonArray>();
+    bool isMultiZone = !zonesArray.isNull() && zonesArray.size() > 0;
+
     // For multi-zone, zone 0 provides the main fields; for single-zone, use top-level fields
     const char* icon = isMultiZone ? "" : (doc["icon"] | "");
     uint32_t textColor = isMultiZone ? 0xFFFFFF : parseColorValue(doc["color"], 0xFFFFFF);
@@ -4574,43 +6818,42 @@ void mqttHandleCustom(const char* name, JsonObject& doc) {
     int8_t result = appAdd(name, parsedText, icon, textColor,
                            duration, lifetime, priority, false);
 
-    if (result >= 0) {
-        if (!isMultiZone) {
-            // Copy text segments
-            memcpy(apps[result].textSegments, textSegs, sizeof(textSegs));
-            apps[result].textSegmentCount = textSegCount;
-            // Parse label field
-            parseTextFieldWithSegments(doc["label"], apps[result].label,
-                                       sizeof(apps[result].label),
-                                       apps[result].labelSegments,
-                                       &apps[result].labelSegmentCount, textColor);
-        }
-        // Apply multi-zone data if present
-        if (isMultiZone) {
-            appSetZones(result, zonesArray);
-        }
-        Serial.printf("[MQTT] Custom app '%s' created/updated\n", name);
-    } else {
-        Serial.printf("[MQTT] Failed to add custom app '%s'\n", name);
+    if (result < 0) {
+        Serial.printf("[CMD] Failed to add custom app '%s'\n", name);
+        return;
+    }
+
+    if (!isMultiZone) {
+        // Copy text segments
+        memcpy(apps[result].textSegments, textSegs, sizeof(textSegs));
+        apps[result].textSegmentCount = textSegCount;
+        // Parse label field
+        parseTextFieldWithSegments(doc["label"], apps[result].label,
+                                   sizeof(apps[result].label),
+                                   apps[result].labelSegments,
+                                   &apps[result].labelSegmentCount, textColor);
+        appCompile(&apps[result]);
+        strlcpy(apps[result].gif, doc["gif"] | "", sizeof(apps[result].gif));
+    }
+    // Apply multi-zone data if present
+    if (isMultiZone) {
+        appSetZones(result, zonesArray);
     }
+    apps[result].transition = transitionFromString(doc["transition"] | "",
+                                                   TRANSITION_GLOBAL);
+    Serial.printf("[CMD] Custom app '%s' created/updated\n", name);
 }
 
-void mqttHandleCustomDelete(const char* name) {
+static void applyCustomDelete(const char* name) {
     if (appRemove(name)) {
-        Serial.printf("[MQTT] Custom app '%s' deleted\n", name);
+        Serial.printf("[CMD] Custom app '%s' deleted\n", name);
     } else {
-        Serial.printf("[MQTT] Custom app '%s' not found or is system app\n", name);
+        Serial.printf("[CMD] Custom app '%s' not found or is system app\n", name);
     }
 }
 
-void mqttHandleNotify(JsonObject& doc) {
+static void applyNotify(const char* id, JsonObject doc) {
     const char* text = doc["text"] | "";
-    if (strlen(text) == 0) {
-        Serial.println("[MQTT] /notify missing text");
-        return;
-    }
-
-    const char* id = doc["id"] | "";
     const char* icon = doc["icon"] | "";
     uint32_t textColor = parseColorValue(doc["color"], 0xFFFFFF);
     uint32_t bgColor = parseColorValue(doc["background"], 0x000000);
@@ -4619,50 +6862,30 @@ void mqttHandleNotify(JsonObject& doc) {
     bool urgent = doc["urgent"] | false;
     bool stack = doc["stack"] | true;
 
-    int8_t slot = notifAdd(id, text, icon, textColor, bgColor,
-                           duration, hold, urgent, stack);
-
-    if (slot >= 0) {
-        Serial.printf("[MQTT] Notification added: '%s'\n", text);
-    } else {
-        Serial.println("[MQTT] Notification queue full");
-    }
+    // An id assigned by the REST handler wins over the payload's
+    if (id[0] == '\0') id = doc["id"] | "";
+    notifAdd(id, text, icon, textColor, bgColor, duration, hold, urgent, stack);
 }
 
-void mqttHandleDismiss() {
+static void applyDismiss() {
     if (notifDismiss()) {
         resetNotifScrollState();
-        Serial.println("[MQTT] Notification dismissed");
+        Serial.println("[CMD] Notification dismissed");
     } else {
-        Serial.println("[MQTT] No active notification to dismiss");
+        Serial.println("[CMD] No active notification to dismiss");
     }
 }
 
-void mqttHandleIndicator(uint8_t index, JsonObject& doc) {
+static void applyIndicator(uint8_t index, JsonObject doc) {
     if (index >= NUM_INDICATORS) return;
 
-    // Parse mode string
-    const char* modeStr = doc["mode"] | "";
     IndicatorMode mode = INDICATOR_OFF;
-
-    if (strlen(modeStr) > 0) {
-        if (strcmp(modeStr, "solid") == 0) mode = INDICATOR_SOLID;
-        else if (strcmp(modeStr, "blink") == 0) mode = INDICATOR_BLINK;
-        else if (strcmp(modeStr, "fade") == 0) mode = INDICATOR_FADE;
-        else if (strcmp(modeStr, "off") == 0) mode = INDICATOR_OFF;
-        else {
-            Serial.printf("[MQTT] Invalid indicator mode: %s\n", modeStr);
-            return;
-        }
-    } else if (!doc["color"].isNull()) {
-        // Default to solid if color provided but no mode
-        mode = INDICATOR_SOLID;
-    }
+    indicatorModeFromBody(doc, &mode);
 
     if (mode == INDICATOR_OFF) {
         indicatorOff(index);
         saveSettings();
-        Serial.printf("[MQTT] Indicator %d turned off\n", index + 1);
+        Serial.printf("[CMD] Indicator %d turned off\n", index + 1);
         return;
     }
 
@@ -4673,17 +6896,11 @@ void mqttHandleIndicator(uint8_t index, JsonObject& doc) {
     indicatorSet(index, mode, color, blinkInterval, fadePeriod);
     saveSettings();
 
-    Serial.printf("[MQTT] Indicator %d set: mode=%s color=0x%06X\n",
-                  index + 1, modeStr[0] ? modeStr : "solid", color);
+    Serial.printf("[CMD] Indicator %d set: mode=%s color=0x%06X\n",
+                  index + 1, indicatorModeToString(mode), color);
 }
 
-void mqttHandleWeather(JsonObject& doc) {
-    // Parse current weather
-    if (!doc["current"].is<JsonObject>()) {
-        Serial.println("[MQTT] /weather missing 'current' object");
-        return;
-    }
-
+static void applyWeather(JsonObject doc) {
     JsonObject current = doc["current"];
     strlcpy(weatherData.currentIcon, current["icon"] | "", sizeof(weatherData.currentIcon));
     weatherData.currentTemp = current["temp"] | 0;
@@ -4714,108 +6931,459 @@ void mqttHandleWeather(JsonObject& doc) {
     weatherData.lastUpdate = millis();
     weatherData.valid = true;
 
-    Serial.printf("[MQTT] Weather updated: %d C, %d%% humidity\n",
-                  weatherData.currentTemp, weatherData.currentHumidity);
+    Serial.printf("[WEATHER] Updated: %d C, %d%% humidity\n",
+                  weatherData.currentTemp, weatherData.currentHumidity);
+}
+
+static void applyTracker(const char* name, JsonObject doc) {
+    // Allocate or find existing tracker
+    TrackerData* tracker = trackerAllocate(name);
+    if (!tracker) {
+        Serial.printf("[CMD] No tracker slot available for '%s'\n", name);
+        return;
+    }
+
+    // Parse fields
+    if (!doc["symbol"].isNull()) {
+        strlcpy(tracker->symbol, doc["symbol"] | "", sizeof(tracker->symbol));
+    }
+    if (!doc["icon"].isNull()) {
+        strlcpy(tracker->icon, doc["icon"] | "", sizeof(tracker->icon));
+    }
+    if (!doc["currency"].isNull()) {
+        strlcpy(tracker->currencySymbol, doc["currency"] | "", sizeof(tracker->currencySymbol));
+    }
+    if (!doc["value"].isNull()) {
+        tracker->currentValue = doc["value"].as<float>();
+    }
+    if (!doc["change"].isNull()) {
+        tracker->changePercent = doc["change"].as<float>();
+    }
+    if (!doc["bottomText"].isNull()) {
+        strlcpy(tracker->bottomText, doc["bottomText"] | "", sizeof(tracker->bottomText));
+    }
+
+    tracker->symbolColor = parseColorValue(doc["symbolColor"], tracker->symbolColor);
+    tracker->sparklineColor = parseColorValue(doc["sparklineColor"], tracker->sparklineColor);
+    trackerPackColors(tracker);
+
+    // Parse sparkline data (float array -> scaled uint16)
+    if (doc["sparkline"].is<JsonArray>()) {
+        JsonArray sparkArr = doc["sparkline"];
+        uint8_t count = min((int)sparkArr.size(), (int)MAX_SPARKLINE_POINTS);
+
+        if (count >= 2) {
+            // Find min/max of float values
+            float minVal = sparkArr[0].as<float>();
+            float maxVal = minVal;
+            for (uint8_t i = 1; i < count; i++) {
+                float v = sparkArr[i].as<float>();
+                if (v < minVal) minVal = v;
+                if (v > maxVal) maxVal = v;
+            }
+
+            float range = maxVal - minVal;
+            if (range < 0.0001f) range = 1.0f;
+
+            // Scale to uint16 (0-65535)
+            for (uint8_t i = 0; i < count; i++) {
+                float normalized = (sparkArr[i].as<float>() - minVal) / range;
+                tracker->sparkline[i] = (uint16_t)(normalized * 65535.0f);
+            }
+            tracker->sparklineCount = count;
+        }
+    }
+
+    tracker->lastUpdate = millis();
+
+    // Register/update app in rotation
+    char appId[32];
+    snprintf(appId, sizeof(appId), "%s%s", TRACKER_ID_PREFIX, name);
+    uint16_t duration = doc["duration"] | (uint16_t)DEFAULT_APP_DURATION;
+    appAdd(appId, tracker->symbol, tracker->icon, 0xFFFFFF,
+           duration, 0, 0, false);
+
+    Serial.printf("[TRACKER] Updated: %s (%s = %.2f)\n",
+                  name, tracker->symbol, tracker->currentValue);
+}
+
+static void applyTrackerDelete(const char* name) {
+    if (trackerRemove(name)) {
+        Serial.printf("[CMD] Tracker '%s' deleted\n", name);
+    } else {
+        Serial.printf("[CMD] Tracker '%s' not found\n", name);
+    }
+}
+
+static void applySleepUntil(JsonObject doc) {
+    uint32_t requestedUntil = doc["until"].as<uint32_t>();
+    JsonDocument overrideDoc;
+    JsonObject overrideBody = overrideDoc.to<JsonObject>();
+    overrideBody["sleep_until"] = requestedUntil;
+    String errorMessage;
+    if (!applySleepUpdate(overrideBody, errorMessage)) {
+        Serial.printf("[CMD] Sleep rejected (until=%lu): %s\n",
+                      (unsigned long)requestedUntil, errorMessage.c_str());
+    }
+}
+
+// One operation with its payload parsed, shared by single commands and batches
+static void commandApplyOp(uint8_t type, uint8_t index, const char* name, JsonObject obj) {
+    String errorMessage;
+    if (!commandValidate(type, obj, errorMessage)) {
+        Serial.printf("[CMD] Command %d rejected: %s\n", type, errorMessage.c_str());
+        commandsRejected++;
+        return;
+    }
+
+    // MQTT /custom and /tracker may carry the name in the payload
+    const char* id = name;
+    if (name[0] == '\0') name = obj["name"] | "";
+    if ((type == CMD_CUSTOM || type == CMD_TRACKER) && name[0] == '\0') {
+        Serial.printf("[CMD] Command %d missing name\n", type);
+        commandsRejected++;
+        return;
+    }
+
+    commandsApplied++;
+    stateVersion++;
+    switch (type) {
+        case CMD_BRIGHTNESS:     applyBrightness(obj); break;
+        case CMD_SETTINGS:       applySettings(obj); break;
+        case CMD_CUSTOM:
+            if (obj["delete"] | false) applyCustomDelete(name);
+            else applyCustom(name, obj);
+            break;
+        case CMD_CUSTOM_DELETE:  applyCustomDelete(name); break;
+        case CMD_NOTIFY:         applyNotify(id, obj); break;
+        case CMD_DISMISS:        applyDismiss(); break;
+        case CMD_INDICATOR:      applyIndicator(index, obj); break;
+        case CMD_INDICATOR_OFF:
+            indicatorOff(index);
+            saveSettings();
+            Serial.printf("[CMD] Indicator %d turned off\n", index + 1);
+            break;
+        case CMD_WEATHER:        applyWeather(obj); break;
+        case CMD_TRACKER:
+            if (obj["delete"] | false) applyTrackerDelete(name);
+            else applyTracker(name, obj);
+            break;
+        case CMD_TRACKER_DELETE: applyTrackerDelete(name); break;
+        case CMD_SLEEP: {
+            String sleepError;
+            if (!applySleepUpdate(obj, sleepError)) {
+                Serial.printf("[CMD] Sleep rejected: %s\n", sleepError.c_str());
+            }
+            break;
+        }
+        case CMD_SLEEP_UNTIL:    applySleepUntil(obj); break;
+        case CMD_WAKE:           wakeNow(); break;
+    }
+}
+
+// Every operation of a batch runs in the same frame, so none is drawn with
+// only part of the batch applied. Invalid operations are skipped.
+static void commandApplyBatch(JsonArray ops) {
+    if (ops.isNull()) {
+        Serial.println("[CMD] Batch rejected: expected an array of operations");
+        commandsRejected++;
+        return;
+    }
+
+    uint16_t skipped = 0;
+    for (JsonObject op : ops) {
+        uint8_t type;
+        uint8_t index;
+        String errorMessage;
+        if (!batchOpParse(op, &type, &index, errorMessage)) {
+            Serial.printf("[CMD] Batch op rejected: %s\n", errorMessage.c_str());
+            commandsRejected++;
+            skipped++;
+            continue;
+        }
+        commandApplyOp(type, index, "", op);
+    }
+    batchesApplied++;
+    Serial.printf("[CMD] Batch applied: %u op(s), %u skipped\n", (unsigned)ops.size(), skipped);
+}
+
+// Caller holds the state lock
+static void commandApply(const Command* cmd) {
+    CommandLargeBody* large = cmd->large != COMMAND_INLINE ? &restLargeBodies[cmd->large] : nullptr;
+    const char* body = large ? large->body : cmd->body;
+    size_t length = large ? large->length : cmd->length;
+
+    JsonDocument doc;
+    if (length > 0) {
+        DeserializationError error = deserializeJson(doc, body, length);
+        // The large buffer is free again once parsed
+        if (large) large->busy.store(false, std::memory_order_release);
+        if (error) {
+            Serial.printf("[CMD] JSON parse error: %s\n", error.c_str());
+            commandsRejected++;
+            return;
+        }
+    }
+
+    if (cmd->type == CMD_BATCH) {
+        commandApplyBatch(doc.as<JsonArray>());
+    } else {
+        commandApplyOp(cmd->type, cmd->index, cmd->name, doc.as<JsonObject>());
+    }
+}
+
+// Producer side: false when the ring is full or the payload does not fit
+bool commandPost(CommandQueue& queue, uint8_t type, uint8_t index, const char* name,
+                 const char* payload, size_t length) {
+    if (length >= COMMAND_BODY_SIZE) return false;
+    Command* cmd = queue.reserve();
+    if (!cmd) return false;
+    cmd->type = type;
+    cmd->index = index;
+    cmd->large = COMMAND_INLINE;
+    strlcpy(cmd->name, name, sizeof(cmd->name));
+    memcpy(cmd->body, payload, length);
+    cmd->length = length;
+    cmd->queuedUs = micros();
+    queue.publish();
+    renderWake();
+    return true;
+}
+
+// Claim a free large body buffer, -1 when all are queued
+static int8_t commandLargeClaim() {
+    for (uint8_t i = 0; i < COMMAND_LARGE_COUNT; i++) {
+        bool expected = false;
+        if (restLargeBodies[i].busy.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            return i;
+        }
+    }
+    return -1;
 }
 
-void mqttHandleTracker(const char* name, JsonObject& doc) {
-    // Allocate or find existing tracker
-    TrackerData* tracker = trackerAllocate(name);
-    if (!tracker) {
-        Serial.printf("[MQTT] No tracker slot available for '%s'\n", name);
-        return;
+// Queue a REST payload of `length` bytes of JSON: in the slot when it fits,
+// else in a large body buffer. False after answering 413 or 503.
+static bool commandQueueRest(AsyncWebServerRequest* request, uint8_t type, uint8_t index,
+                             const char* name, JsonVariantConst json, size_t length) {
+    if (length >= COMMAND_LARGE_SIZE) {
+        request->send(413, "application/json", "{\"error\":\"Payload too large\"}");
+        return false;
     }
 
-    // Parse fields
-    if (!doc["symbol"].isNull()) {
-        strlcpy(tracker->symbol, doc["symbol"] | "", sizeof(tracker->symbol));
+    Command* cmd = restCommands.reserve();
+    uint8_t large = COMMAND_INLINE;
+    if (cmd && length >= COMMAND_BODY_SIZE) {
+        // The reserved slot is simply not published when this fails
+        int8_t claimed = commandLargeClaim();
+        if (claimed < 0) {
+            cmd = nullptr;
+        } else {
+            large = claimed;
+        }
     }
-    if (!doc["icon"].isNull()) {
-        strlcpy(tracker->icon, doc["icon"] | "", sizeof(tracker->icon));
+    if (!cmd) {
+        request->send(503, "application/json", "{\"error\":\"Command queue full\"}");
+        return false;
     }
-    if (!doc["currency"].isNull()) {
-        strlcpy(tracker->currencySymbol, doc["currency"] | "", sizeof(tracker->currencySymbol));
+
+    cmd->type = type;
+    cmd->index = index;
+    cmd->large = large;
+    strlcpy(cmd->name, name, sizeof(cmd->name));
+    if (large == COMMAND_INLINE) {
+        cmd->length = length ? serializeJson(json, cmd->body, sizeof(cmd->body)) : 0;
+    } else {
+        CommandLargeBody& body = restLargeBodies[large];
+        body.length = serializeJson(json, body.body, sizeof(body.body));
+        cmd->length = 0;
     }
-    if (!doc["value"].isNull()) {
-        tracker->currentValue = doc["value"].as<float>();
+    cmd->queuedUs = micros();
+    restCommands.publish();
+    renderWake();
+    return true;
+}
+
+static const AppItem* snapshotFindApp(const StateSnapshot* state, const char* id) {
+    for (uint8_t i = 0; i < MAX_APPS; i++) {
+        if (state->apps[i].active && strcmp(state->apps[i].id, id) == 0) return &state->apps[i];
     }
-    if (!doc["change"].isNull()) {
-        tracker->changePercent = doc["change"].as<float>();
+    return nullptr;
+}
+
+static bool snapshotHasTracker(const StateSnapshot* state, const char* name) {
+    for (uint8_t i = 0; i < MAX_TRACKERS; i++) {
+        if (state->trackers[i].valid && strcmp(state->trackers[i].name, name) == 0) return true;
     }
-    if (!doc["bottomText"].isNull()) {
-        strlcpy(tracker->bottomText, doc["bottomText"] | "", sizeof(tracker->bottomText));
+    return false;
+}
+
+// Refuse what the last published snapshot says will fail, with the answers
+// given before requests were queued. A command racing with one queued
+// meanwhile can still fail when applied, that is only logged.
+static bool commandPrecheck(AsyncWebServerRequest* request, uint8_t type, const char* name,
+                            JsonObject body) {
+    SnapshotPin pin;
+    const StateSnapshot* state = pin.state;
+    bool remove = body["delete"] | false;
+
+    if (type == CMD_CUSTOM_DELETE || (type == CMD_CUSTOM && remove)) {
+        const AppItem* app = snapshotFindApp(state, name);
+        if (!app || app->isSystem) {
+            request->send(404, "application/json", "{\"error\":\"App not found or is system app\"}");
+            return false;
+        }
+    } else if (type == CMD_CUSTOM) {
+        if (!snapshotFindApp(state, name) && state->appCount >= MAX_APPS) {
+            request->send(500, "application/json", "{\"error\":\"Failed to add app\"}");
+            return false;
+        }
+    } else if (type == CMD_TRACKER_DELETE || (type == CMD_TRACKER && remove)) {
+        if (!snapshotHasTracker(state, name)) {
+            request->send(404, "application/json", "{\"error\":\"Tracker not found\"}");
+            return false;
+        }
+    } else if (type == CMD_TRACKER) {
+        if (!snapshotHasTracker(state, name) && state->trackerCount >= MAX_TRACKERS) {
+            request->send(500, "application/json", "{\"error\":\"No tracker slot available\"}");
+            return false;
+        }
+    } else if (type == CMD_NOTIFY) {
+        // Without a free slot a stacked notification would be dropped
+        if ((body["stack"] | true) && state->notificationCount >= MAX_NOTIFICATIONS) {
+            request->send(503, "application/json", "{\"error\":\"Notification queue full\"}");
+            return false;
+        }
+    } else if (type == CMD_DISMISS) {
+        if (state->currentNotifIndex < 0) {
+            request->send(404, "application/json", "{\"error\":\"No active notification\"}");
+            return false;
+        }
     }
+    return true;
+}
 
-    tracker->symbolColor = parseColorValue(doc["symbolColor"], tracker->symbolColor);
-    tracker->sparklineColor = parseColorValue(doc["sparklineColor"], tracker->sparklineColor);
+// Validate and queue a REST request, answering right away: 400 for a bad
+// payload, 404/500/503 when the published state says it will fail (see
+// commandPrecheck), 413 when it is over COMMAND_LARGE_SIZE, 503 when the
+// queue (or, for a payload over a slot, every large buffer) is full
+void commandRespond(AsyncWebServerRequest* request, uint8_t type, uint8_t index, const char* name,
+                    JsonVariant json, const char* response) {
+    String errorMessage;
+    if (!commandValidate(type, json.as<JsonObject>(), errorMessage)) {
+        JsonDocument errorDoc;
+        errorDoc["error"] = errorMessage;
+        String output;
+        serializeJson(errorDoc, output);
+        request->send(400, "application/json", output);
+        return;
+    }
+    if (!commandPrecheck(request, type, name, json.as<JsonObject>())) return;
 
-    // Parse sparkline data (float array -> scaled uint16)
-    if (doc["sparkline"].is<JsonArray>()) {
-        JsonArray sparkArr = doc["sparkline"];
-        uint8_t count = min((int)sparkArr.size(), (int)MAX_SPARKLINE_POINTS);
+    size_t length = commandHasBody(type) ? measureJson(json) : 0;
+    if (!commandQueueRest(request, type, index, name, json, length)) return;
+    request->send(200, "application/json", response);
+}
 
-        if (count >= 2) {
-            float minVal = sparkArr[0].as<float>();
-            float maxVal = minVal;
-            for (uint8_t i = 1; i < count; i++) {
-                float v = sparkArr[i].as<float>();
-                if (v < minVal) minVal = v;
-                if (v > maxVal) maxVal = v;
-            }
+// Validate every operation, queue the valid ones as one command and answer
+// with a status per operation. 400 when none is valid, 413 when they are
+// over COMMAND_LARGE_SIZE, 503 when the queue or the large buffers are full.
+void handleBatchApi(AsyncWebServerRequest* request, JsonVariant& json) {
+    JsonArray ops = json.as<JsonArray>();
+    if (ops.isNull()) {
+        request->send(400, "application/json", "{\"error\":\"Expected an array of operations\"}");
+        return;
+    }
 
-            float range = maxVal - minVal;
-            if (range < 0.0001f) range = 1.0f;
+    JsonDocument accepted;
+    JsonArray acceptedOps = accepted.to<JsonArray>();
+    JsonDocument response;
+    JsonArray results = response["results"].to<JsonArray>();
+    uint8_t stacked = 0;
+    uint16_t position = 0;
 
-            for (uint8_t i = 0; i < count; i++) {
-                float normalized = (sparkArr[i].as<float>() - minVal) / range;
-                tracker->sparkline[i] = (uint16_t)(normalized * 65535.0f);
-            }
-            tracker->sparklineCount = count;
-        }
+    // Queue depth as the render task last published it
+    uint8_t queued;
+    {
+        SnapshotPin pin;
+        queued = pin.state->notificationCount;
     }
 
-    tracker->lastUpdate = millis();
-
-    // Register/update app in rotation
-    char appId[32];
-    snprintf(appId, sizeof(appId), "%s%s", TRACKER_ID_PREFIX, name);
-    uint16_t duration = doc["duration"] | (uint16_t)DEFAULT_APP_DURATION;
-    appAdd(appId, tracker->symbol, tracker->icon, 0xFFFFFF,
-           duration, 0, 0, false);
+    for (JsonVariant entry : ops) {
+        JsonObject result = results.add<JsonObject>();
+        JsonObject op = entry.as<JsonObject>();
+        uint8_t type;
+        uint8_t index;
+        String errorMessage;
+        if (!batchOpParse(op, &type, &index, errorMessage)) {
+            result["status"] = "rejected";
+            result["error"] = errorMessage;
+            position++;
+            continue;
+        }
 
-    Serial.printf("[MQTT] Tracker updated: %s (%s = %.2f)\n",
-                  name, tracker->symbol, tracker->currentValue);
-}
+        // Same checks as POST /api/notify: no dropped stacked notification,
+        // an ID returned before the operation runs
+        char id[sizeof(Command::name)] = "";
+        if (type == CMD_NOTIFY) {
+            if ((op["stack"] | true) && queued + stacked >= MAX_NOTIFICATIONS) {
+                result["status"] = "rejected";
+                result["error"] = "Notification queue full";
+                position++;
+                continue;
+            }
+            if (op["stack"] | true) stacked++;
+            const char* requestedId = op["id"] | "";
+            if (requestedId[0] != '\0') {
+                strlcpy(id, requestedId, sizeof(id));
+            } else {
+                snprintf(id, sizeof(id), "notif_%lu_%u", millis(), position);
+            }
+            result["id"] = id;
+        }
 
-void mqttHandleTrackerDelete(const char* name) {
-    if (trackerRemove(name)) {
-        Serial.printf("[MQTT] Tracker '%s' deleted\n", name);
-    } else {
-        Serial.printf("[MQTT] Tracker '%s' not found\n", name);
+        JsonObject copy = acceptedOps.add<JsonObject>();
+        copy.set(op);
+        if (id[0] != '\0') copy["id"] = id;
+        result["status"] = "accepted";
+        position++;
     }
-}
 
-void mqttHandleSettings(JsonObject& doc) {
-    if (!doc["brightness"].isNull()) {
-        settings.brightness = doc["brightness"].as<uint8_t>();
-        displaySetBrightness(settings.brightness);
-    }
-    if (!doc["autoRotate"].isNull()) {
-        settings.autoRotate = doc["autoRotate"].as<bool>();
-        appRotationEnabled = settings.autoRotate;
+    response["accepted"] = acceptedOps.size();
+    String output;
+    if (acceptedOps.size() == 0) {
+        serializeJson(response, output);
+        request->send(400, "application/json", output);
+        return;
     }
-    if (!doc["defaultDuration"].isNull()) {
-        settings.defaultDuration = doc["defaultDuration"].as<uint16_t>();
+
+    size_t length = measureJson(accepted);
+    if (length >= COMMAND_LARGE_SIZE) {
+        request->send(413, "application/json", "{\"error\":\"Batch too large\"}");
+        return;
     }
+    if (!commandQueueRest(request, CMD_BATCH, 0, "", accepted, length)) return;
 
-    saveSettings();
-    Serial.println("[MQTT] Settings updated");
+    serializeJson(response, output);
+    request->send(200, "application/json", output);
+}
+
+static void commandDrainQueue(CommandQueue& queue, bool* drained, uint32_t* queuedUs) {
+    const Command* cmd;
+    while ((cmd = queue.peek()) != nullptr) {
+        if (!*drained || (int32_t)(cmd->queuedUs - *queuedUs) < 0) *queuedUs = cmd->queuedUs;
+        *drained = true;
+        commandApply(cmd);
+        queue.release();
+    }
 }
 
-void mqttHandleReboot() {
-    Serial.println("[MQTT] Reboot requested");
-    pendingReboot = true;
-    rebootRequestTime = millis();
+// Apply every queued command. Called at the start of a frame, under the state
+// lock. False when none was queued, else *queuedUs is when the oldest was.
+bool commandDrain(uint32_t* queuedUs) {
+    bool drained = false;
+    commandDrainQueue(restCommands, &drained, queuedUs);
+    commandDrainQueue(mqttCommands, &drained, queuedUs);
+    return drained;
 }
 
 // ============================================================================
@@ -4830,8 +7398,8 @@ void setupFilesystem() {
     }
 
     filesystemReady = true;
-    Serial.printf("[FS] LittleFS mounted, total: %d bytes, used: %d bytes\n",
-        LittleFS.totalBytes(), LittleFS.usedBytes());
+    Serial.printf("[FS] LittleFS mounted, total: %u bytes, used: %u bytes\n",
+        (unsigned)LittleFS.totalBytes(), (unsigned)LittleFS.usedBytes());
 
     ensureDirectories();
 }
@@ -4860,6 +7428,7 @@ void initDefaultSettings() {
     settings.brightness = DEFAULT_BRIGHTNESS;
     settings.autoRotate = true;
     settings.defaultDuration = DEFAULT_APP_DURATION;
+    settings.transition = DEFAULT_TRANSITION;
 
     strlcpy(settings.ntpServer, NTP_SERVER, sizeof(settings.ntpServer));
     strlcpy(settings.tzPosix, DEFAULT_TZ_POSIX, sizeof(settings.tzPosix));
@@ -4879,6 +7448,7 @@ void initDefaultSettings() {
     settings.mqttUser[0] = '\0';
     settings.mqttPassword[0] = '\0';
     strlcpy(settings.mqttPrefix, MQTT_PREFIX, sizeof(settings.mqttPrefix));
+    mqttConfigChanged = true;
 
     settings.sleep.enabled = false;
     settings.sleep.sleepUntilEpoch = 0;
@@ -4914,6 +7484,10 @@ bool loadSettings() {
     settings.brightness = doc["display"]["brightness"] | DEFAULT_BRIGHTNESS;
     settings.autoRotate = doc["display"]["autoRotate"] | true;
     settings.defaultDuration = doc["display"]["defaultDuration"] | DEFAULT_APP_DURATION;
+    uint8_t savedTransition = transitionFromString(doc["display"]["transition"] | "none",
+                                                   DEFAULT_TRANSITION);
+    settings.transition = savedTransition == TRANSITION_GLOBAL ?
+                          DEFAULT_TRANSITION : (TransitionType)savedTransition;
 
     // NTP settings
     const char* ntpSrv = doc["ntp"]["server"] | NTP_SERVER;
@@ -4967,6 +7541,7 @@ bool loadSettings() {
     strlcpy(settings.mqttPassword, mqttPwd, sizeof(settings.mqttPassword));
     const char* mqttPfx = doc["mqtt"]["prefix"] | MQTT_PREFIX;
     strlcpy(settings.mqttPrefix, mqttPfx, sizeof(settings.mqttPrefix));
+    mqttConfigChanged = true;
 
     // Indicator settings
     for (int i = 0; i < NUM_INDICATORS; i++) {
@@ -5051,20 +7626,23 @@ bool loadSettings() {
     return true;
 }
 
+// Only marks settings dirty, loopPersistence() writes them
 bool saveSettings() {
     if (!filesystemReady) {
         Serial.println("[SETTINGS] Filesystem not ready");
         return false;
     }
+    settingsSavePending = true;
+    return true;
+}
 
-    JsonDocument doc;
-
+static void buildSettingsDoc(JsonDocument& doc) {
     // Display settings
     doc["display"]["brightness"] = settings.brightness;
     doc["display"]["autoRotate"] = settings.autoRotate;
     doc["display"]["defaultDuration"] = settings.defaultDuration;
     doc["display"]["colorDepth"] = COLOR_DEPTH;
-    doc["display"]["transition"] = "none";
+    doc["display"]["transition"] = transitionToString(settings.transition);
 
     // WiFi settings
     doc["wifi"]["hostname"] = MDNS_NAME;
@@ -5133,18 +7711,6 @@ bool saveSettings() {
             slotObj["endMinute"]   = slot.endMinute;
         }
     }
-
-    File file = LittleFS.open(FS_CONFIG_FILE, "w");
-    if (!file) {
-        Serial.println("[SETTINGS] Failed to open config file for writing");
-        return false;
-    }
-
-    serializeJsonPretty(doc, file);
-    file.close();
-
-    Serial.println("[SETTINGS] Configuration saved successfully");
-    return true;
 }
 
 bool loadApps() {
@@ -5197,11 +7763,15 @@ bool loadApps() {
                                            sizeof(apps[result].label),
                                            apps[result].labelSegments,
                                            &apps[result].labelSegmentCount, textColor);
+                appCompile(&apps[result]);
+                strlcpy(apps[result].gif, appObj["gif"] | "", sizeof(apps[result].gif));
                 // Restore multi-zone data if present
                 JsonArray zonesArr = appObj["zones"].as<JsonArray>();
                 if (!zonesArr.isNull() && zonesArr.size() >= 2) {
                     appSetZones(result, zonesArr);
                 }
+                apps[result].transition = transitionFromString(appObj["transition"] | "",
+                                                               TRANSITION_GLOBAL);
                 loadedCount++;
             }
         }
@@ -5211,13 +7781,17 @@ bool loadApps() {
     return loadedCount > 0;
 }
 
+// Only marks apps dirty, loopPersistence() writes them
 bool saveApps() {
     if (!filesystemReady) {
         Serial.println("[APPS] Filesystem not ready, cannot save apps");
         return false;
     }
+    appsSavePending = true;
+    return true;
+}
 
-    JsonDocument doc;
+static int buildAppsDoc(JsonDocument& doc) {
     doc["version"] = 1;
     JsonArray appsArray = doc["apps"].to<JsonArray>();
 
@@ -5227,10 +7801,16 @@ bool saveApps() {
             JsonObject appObj = appsArray.add<JsonObject>();
             appObj["id"] = apps[i].id;
             appObj["icon"] = apps[i].icon;
+            if (apps[i].gif[0] != '\0') {
+                appObj["gif"] = apps[i].gif;
+            }
             appObj["textColor"] = apps[i].textColor;
             appObj["duration"] = apps[i].duration;
             appObj["lifetime"] = apps[i].lifetime;
             appObj["priority"] = apps[i].priority;
+            if (apps[i].transition != TRANSITION_GLOBAL) {
+                appObj["transition"] = transitionToString(apps[i].transition);
+            }
             // Serialize text and label in polymorphic format
             serializeTextField(appObj, "text", apps[i].text,
                                apps[i].textSegments, apps[i].textSegmentCount);
@@ -5276,20 +7856,57 @@ bool saveApps() {
             savedCount++;
         }
     }
+    return savedCount;
+}
 
-    File file = LittleFS.open(FS_APPS_FILE, "w");
-    if (!file) {
-        Serial.println("[APPS] Failed to open apps file for writing");
-        return false;
-    }
-
-    serializeJsonPretty(doc, file);
+static bool writeJsonFile(const char* path, const String& json) {
+    File file = LittleFS.open(path, "w");
+    if (!file) return false;
+    file.print(json);
     file.close();
-
-    Serial.printf("[APPS] Saved %d custom apps to storage\n", savedCount);
     return true;
 }
 
+// Snapshot dirty settings/apps under the state lock, then write them to
+// flash after releasing it so the render task never waits on LittleFS.
+void loopPersistence() {
+    if (!settingsSavePending && !appsSavePending) return;
+
+    String settingsJson;
+    String appsJson;
+    int appsSaved = 0;
+
+    stateLock();
+    if (settingsSavePending) {
+        settingsSavePending = false;
+        JsonDocument doc;
+        buildSettingsDoc(doc);
+        serializeJsonPretty(doc, settingsJson);
+    }
+    if (appsSavePending) {
+        appsSavePending = false;
+        JsonDocument doc;
+        appsSaved = buildAppsDoc(doc);
+        serializeJsonPretty(doc, appsJson);
+    }
+    stateUnlock();
+
+    if (settingsJson.length() > 0) {
+        if (writeJsonFile(FS_CONFIG_FILE, settingsJson)) {
+            Serial.println("[SETTINGS] Configuration saved successfully");
+        } else {
+            Serial.println("[SETTINGS] Failed to open config file for writing");
+        }
+    }
+    if (appsJson.length() > 0) {
+        if (writeJsonFile(FS_APPS_FILE, appsJson)) {
+            Serial.printf("[APPS] Saved %d custom apps to storage\n", appsSaved);
+        } else {
+            Serial.println("[APPS] Failed to open apps file for writing");
+        }
+    }
+}
+
 // ============================================================================
 // Application Manager Functions
 // ============================================================================
@@ -5325,11 +7942,13 @@ void setupApps() {
 
     Serial.printf("[APPS] Initialized with %d apps\n", appCount);
     appRotationEnabled = settings.autoRotate;
+    stateVersion++;
 }
 
 int8_t appAdd(const char* id, const char* text, const char* icon,
               uint32_t textColor, uint16_t duration,
               uint32_t lifetime, int8_t priority, bool isSystem) {
+    stateVersion++;
 
     // Check if app with same ID exists
     int8_t existingIndex = appFind(id);
@@ -5339,17 +7958,21 @@ int8_t appAdd(const char* id, const char* text, const char* icon,
         strlcpy(app->text, text, sizeof(app->text));
         if (icon) strlcpy(app->icon, icon, sizeof(app->icon));
         app->label[0] = '\0';  // Reset label (caller will set if needed)
+        app->gif[0] = '\0';    // Reset animation (caller will set if needed)
         app->textColor = textColor;
+        app->textColorPanel = panelColorRGB(textColor);
         app->textSegmentCount = 0;
         app->labelSegmentCount = 0;
         app->duration = duration;
         app->lifetime = lifetime;
         app->priority = priority;
+        app->transition = TRANSITION_GLOBAL;  // Caller will set if needed
         app->createdAt = millis();
         app->active = true;
         // Reset zone data (caller will set via appSetZones if needed)
         app->zoneCount = 0;
         memset(app->zones, 0, sizeof(app->zones));
+        appCompile(app);
         Serial.printf("[APPS] Updated app: %s\n", id);
         // Persist non-system apps
         if (!app->isSystem) {
@@ -5379,18 +8002,22 @@ int8_t appAdd(const char* id, const char* text, const char* icon,
     if (icon) strlcpy(app->icon, icon, sizeof(app->icon));
     else app->icon[0] = '\0';
     app->label[0] = '\0';  // Initialize label (caller will set if needed)
+    app->gif[0] = '\0';    // Initialize animation (caller will set if needed)
     app->textColor = textColor;
+    app->textColorPanel = panelColorRGB(textColor);
     app->textSegmentCount = 0;
     app->labelSegmentCount = 0;
     app->duration = duration > 0 ? duration : settings.defaultDuration;
     app->lifetime = lifetime;
     app->createdAt = millis();
     app->priority = constrain(priority, -10, 10);
+    app->transition = TRANSITION_GLOBAL;
     app->active = true;
     app->isSystem = isSystem;
     // Initialize zone data (caller will set via appSetZones if needed)
     app->zoneCount = 0;
     memset(app->zones, 0, sizeof(app->zones));
+    appCompile(app);
 
     appCount++;
     Serial.printf("[APPS] Added app: %s (slot %d, total %d)\n", id, emptySlot, appCount);
@@ -5416,6 +8043,7 @@ void appSetZones(int8_t appIndex, JsonArray zonesArray) {
     JsonObject zone0 = zonesArray[0].as<JsonObject>();
     strlcpy(app->icon, zone0["icon"] | "", sizeof(app->icon));
     app->textColor = parseColorValue(zone0["color"], 0xFFFFFF);
+    app->textColorPanel = panelColorRGB(app->textColor);
     parseTextFieldWithSegments(zone0["text"], app->text, sizeof(app->text),
                                app->textSegments, &app->textSegmentCount, app->textColor);
     parseTextFieldWithSegments(zone0["label"], app->label, sizeof(app->label),
@@ -5426,6 +8054,7 @@ void appSetZones(int8_t appIndex, JsonArray zonesArray) {
         JsonObject zoneObj = zonesArray[i].as<JsonObject>();
         strlcpy(app->zones[i - 1].icon, zoneObj["icon"] | "", sizeof(app->zones[0].icon));
         app->zones[i - 1].textColor = parseColorValue(zoneObj["color"], 0xFFFFFF);
+        app->zones[i - 1].textColorPanel = panelColorRGB(app->zones[i - 1].textColor);
         parseTextFieldWithSegments(zoneObj["text"], app->zones[i - 1].text,
                                    sizeof(app->zones[0].text),
                                    app->zones[i - 1].textSegments,
@@ -5437,6 +8066,7 @@ void appSetZones(int8_t appIndex, JsonArray zonesArray) {
                                    &app->zones[i - 1].labelSegmentCount,
                                    app->zones[i - 1].textColor);
     }
+    appCompile(app);
 
     Serial.printf("[APPS] Set %d zones for app: %s\n", count, app->id);
 
@@ -5458,6 +8088,7 @@ bool appRemove(const char* id) {
 
     app->active = false;
     appCount--;
+    stateVersion++;
 
     // If removing current app, move to next
     if (currentAppIndex == index) {
@@ -5480,13 +8111,53 @@ bool appUpdate(const char* id, const char* text, const char* icon,
     AppItem* app = &apps[index];
     if (text) strlcpy(app->text, text, sizeof(app->text));
     if (icon) strlcpy(app->icon, icon, sizeof(app->icon));
-    if (textColor != 0) app->textColor = textColor;
+    if (textColor != 0) {
+        app->textColor = textColor;
+        app->textColorPanel = panelColorRGB(textColor);
+    }
+    appCompile(app);
     app->createdAt = millis();
 
     Serial.printf("[APPS] Updated app: %s\n", id);
     return true;
 }
 
+static uint8_t appKindFromId(const char* id) {
+    if (strcmp(id, "clock") == 0) return APP_KIND_CLOCK;
+    if (strcmp(id, "date") == 0) return APP_KIND_DATE;
+    if (strcmp(id, "weatherclock") == 0) return APP_KIND_WEATHERCLOCK;
+    if (strncmp(id, TRACKER_ID_PREFIX, strlen(TRACKER_ID_PREFIX)) == 0) return APP_KIND_TRACKER;
+    return APP_KIND_CUSTOM;
+}
+
+static uint32_t iconNameHash(const char* name) {
+    return name[0] != '\0' ? nameHash(name) : 0;
+}
+
+// Resolve everything the renderer would otherwise work out from strings
+// each frame: layout kind, text widths, icon hashes and content signatures.
+// Called whenever an app's drawn fields change.
+void appCompile(AppItem* app) {
+    app->kind = appKindFromId(app->id);
+    app->textWidth = calculateTextWidth(app->text);
+    app->labelWidth = fontTextWidth(&fontTomThumb, app->label);
+    app->iconHash = iconNameHash(app->icon);
+    app->textSignature = textStripSignature(app->text, app->textColorPanel,
+                                            app->textSegments, app->textSegmentCount);
+
+    uint32_t signature = damageHash(app->textSignature, app->icon, strlen(app->icon) + 1);
+    signature = damageHash(signature, app->label, strlen(app->label) + 1);
+    signature = damageHash(signature, app->labelSegments, sizeof(TextSegment) * app->labelSegmentCount);
+    app->signature = signature;
+
+    for (uint8_t i = 0; i < MAX_ZONES - 1; i++) {
+        AppZone* zone = &app->zones[i];
+        zone->textWidth = calculateTextWidth(zone->text);
+        zone->labelWidth = fontTextWidth(&fontTomThumb, zone->label);
+        zone->iconHash = iconNameHash(zone->icon);
+    }
+}
+
 int8_t appFind(const char* id) {
     for (uint8_t i = 0; i < MAX_APPS; i++) {
         if (apps[i].active && strcmp(apps[i].id, id) == 0) {
@@ -5504,6 +8175,7 @@ void appCleanExpired() {
                 Serial.printf("[APPS] App expired: %s\n", apps[i].id);
                 apps[i].active = false;
                 appCount--;
+                stateVersion++;
                 if (currentAppIndex == i) {
                     currentAppIndex = -1;
                 }
@@ -5512,25 +8184,33 @@ void appCleanExpired() {
     }
 }
 
-AppItem* appGetNext() {
-    if (appCount == 0) return nullptr;
-
-    // Clean expired apps first
-    appCleanExpired();
-    if (appCount == 0) return nullptr;
+// Index of the app after the current one in the rotation, without
+// switching to it (-1 if none)
+int8_t appPeekNext() {
+    if (appCount == 0) return -1;
 
     // Simple round-robin: find next active app after current
     int8_t startIndex = (currentAppIndex + 1) % MAX_APPS;
 
     for (uint8_t i = 0; i < MAX_APPS; i++) {
         int8_t idx = (startIndex + i) % MAX_APPS;
-        if (apps[idx].active) {
-            currentAppIndex = idx;
-            return &apps[idx];
-        }
+        if (apps[idx].active) return idx;
     }
 
-    return nullptr;
+    return -1;
+}
+
+AppItem* appGetNext() {
+    if (appCount == 0) return nullptr;
+
+    // Clean expired apps first
+    appCleanExpired();
+
+    int8_t idx = appPeekNext();
+    if (idx < 0) return nullptr;
+    if (currentAppIndex != idx) stateVersion++;
+    currentAppIndex = idx;
+    return &apps[idx];
 }
 
 AppItem* appGetCurrent() {
@@ -5540,6 +8220,26 @@ AppItem* appGetCurrent() {
     return nullptr;
 }
 
+// Notification expiry and app rotation, mirroring loopApps(). Queued
+// notifications and a missing current app are handled in the frame that
+// queued them.
+void appsDeadline(FrameDeadline& next) {
+    if (!wifiConnected || sleepIsActive()) return;
+
+    NotificationItem* notif = notifGetCurrent();
+    if (notif) {
+        if (!notif->hold && notif->duration > 0 && notif->displayedAt != 0) {
+            next.need(notif->displayedAt + notif->duration + 1);
+        }
+        return;
+    }
+
+    AppItem* current = appGetCurrent();
+    if (current && appRotationEnabled) {
+        next.need(lastAppSwitch + current->duration + 1);
+    }
+}
+
 void loopApps() {
     if (!wifiConnected) return;
     if (sleepIsActive()) return;
@@ -5556,8 +8256,6 @@ void loopApps() {
         currentNotif = notifGetNext();  // Try next in queue
         if (currentNotif) {
             resetNotifScrollState();
-            // Draw twice to flush both DMA buffers
-            displayShowNotification(currentNotif);
             displayShowNotification(currentNotif);
             lastDisplayUpdate = now;
         }
@@ -5572,8 +8270,6 @@ void loopApps() {
                 savedAppIndex = currentAppIndex;
             }
             resetNotifScrollState();
-            // Draw twice to flush both DMA buffers (prevents weather ghosting)
-            displayShowNotification(currentNotif);
             displayShowNotification(currentNotif);
             lastDisplayUpdate = now;
         }
@@ -5588,25 +8284,19 @@ void loopApps() {
     if (savedAppIndex >= 0) {
         currentAppIndex = savedAppIndex;
         savedAppIndex = -1;
+        stateVersion++;
         lastAppSwitch = now;
         resetScrollState();
         // Reset weather clock cache to force full redraw (not just seconds update)
         weatherLastDrawnMinute = -1;
         weatherLastUpdateDrawn = 0;
         Serial.println("[NOTIF] All dismissed, resuming app rotation");
-        // Clear both DMA buffers to remove any notification pixel remnants,
-        // then force immediate app redraw on both buffers
-        dma_display->clearScreen();
-        #if DOUBLE_BUFFER
-            dma_display->flipDMABuffer();
-        #endif
-        dma_display->clearScreen();
-        #if DOUBLE_BUFFER
-            dma_display->flipDMABuffer();
-        #endif
+        textStripRelease(&notifTextStrip);
+        // Clear notification remnants and force immediate app redraw
+        canvas->fillScreen(0);
+        damageInvalidate();
         AppItem* restored = appGetCurrent();
         if (restored) {
-            displayShowApp(restored);
             displayShowApp(restored);
             lastDisplayUpdate = now;
         }
@@ -5637,8 +8327,11 @@ void loopApps() {
             lastAppSwitch = now;
             resetScrollState();
             Serial.printf("[APPS] Switched to: %s\n", current->id);
-            // Force immediate redraw on app switch
+            // Snapshot the outgoing frame, render the incoming app off-screen,
+            // then let loopDisplay() animate between them
+            bool animate = transitionBegin(transitionForApp(current));
             displayShowApp(current);
+            if (animate) transitionCommit();
             lastDisplayUpdate = now;
         }
     }
@@ -5714,6 +8407,23 @@ bool sleepIsActive() {
 // Display Loop
 // ============================================================================
 
+// sleepIsActive() only changes on a minute boundary or when a sleep
+// override runs out
+void sleepDeadline(FrameDeadline& next)
+{
+    if (!settings.sleep.enabled) return;
+
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    if (tv.tv_sec < NTP_VALID_EPOCH_THRESHOLD) return;
+
+    unsigned long now = millis() - tv.tv_usec / 1000;  // Start of the current second
+    next.need(now + (60 - tv.tv_sec % 60) * 1000UL);
+    if ((uint32_t)tv.tv_sec < settings.sleep.sleepUntilEpoch) {
+        next.need(now + (settings.sleep.sleepUntilEpoch - (uint32_t)tv.tv_sec) * 1000UL);
+    }
+}
+
 void loopSleepTransition()
 {
     static bool wasSleeping = false;
@@ -5723,13 +8433,12 @@ void loopSleepTransition()
     if (isSleeping && !wasSleeping) {
         Serial.printf("[SLEEP] entering at %u\n", (unsigned)time(nullptr));
         previousBrightness = currentBrightness;
+        transitionCancel();
         if (strcmp(settings.sleep.displayMode, "black") == 0) {
             displaySetBrightness(0);
             displayClear();
         } else if (strcmp(settings.sleep.displayMode, "clock") == 0) {
-            // Render twice to flush both DMA buffers so the clock replaces
-            // any leftover app/notification frame immediately on entry.
-            displayShowTime();
+            // Clock replaces any leftover app/notification frame immediately on entry
             displayShowTime();
             lastDisplayUpdate = millis();
         }
@@ -5826,10 +8535,9 @@ static void buildSleepConfigJson(JsonObject root)
     root["sleep_until"] = settings.sleep.sleepUntilEpoch;
 }
 
-static bool applySleepUpdate(JsonObject body, String& errorOut)
+// Apply a sleep update to scratch; the checks depend only on the body
+static bool sleepParseUpdate(JsonObject body, SleepSchedule& scratch, String& errorOut)
 {
-    SleepSchedule scratch = settings.sleep;
-
     if (body["enabled"].is<bool>()) {
         scratch.enabled = body["enabled"].as<bool>();
     }
@@ -5907,6 +8615,17 @@ static bool applySleepUpdate(JsonObject body, String& errorOut)
         }
     }
 
+    return true;
+}
+
+static bool applySleepUpdate(JsonObject body, String& errorOut)
+{
+    SleepSchedule scratch = settings.sleep;
+    if (!sleepParseUpdate(body, scratch, errorOut))
+    {
+        return false;
+    }
+
     settings.sleep = scratch;
     saveSettings();
     loopSleepTransition();
@@ -5921,13 +8640,69 @@ static void wakeNow()
     Serial.println("[SLEEP] Wake override cleared");
 }
 
+// Milliseconds since the wall clock entered its current second
+static unsigned long clockIntoSecond() {
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    return tv.tv_usec / 1000;
+}
+
+// True when the clock second has changed since `since` (a millis() time),
+// so clocks tick on the second instead of drifting a frame per redraw
+static bool clockSecondDue(unsigned long since, unsigned long now) {
+    return now - since > clockIntoSecond();
+}
+
+// Next scroll step: every SCROLL_SPEED while scrolling, the end of the
+// pause otherwise, never sooner than loopDisplay() checks scroll state
+static void scrollDeadline(FrameDeadline& next, const ScrollState& scroll, unsigned long lastUpdate) {
+    if (!scroll.needsScroll) return;
+    unsigned long step = lastUpdate + SCROLL_SPEED;
+    if (scroll.scrollPhase == 1) {
+        next.need(step);
+        return;
+    }
+    unsigned long pauseEnd = scroll.lastScrollTime + SCROLL_PAUSE;
+    next.need((long)(pauseEnd - step) > 0 ? pauseEnd : step);
+}
+
+// Frames in which loopDisplay() will draw something, mirroring its checks
+void displayDeadline(FrameDeadline& next) {
+    if (!wifiConnected) return;
+
+    // Clock tick, also the periodic refresh of everything else
+    next.need(millis() + 1000 - clockIntoSecond());
+    if (sleepIsActive()) return;
+
+    if (notifGetCurrent()) {
+        scrollDeadline(next, notifScrollState, lastNotifScrollUpdate);
+        iconAnimationDeadline(next);
+        indicatorDeadline(next, lastDisplayUpdate);
+        return;
+    }
+
+    if (transition.active) {
+        next.need(transition.nextFrame);
+        return;
+    }
+
+    AppItem* current = appGetCurrent();
+    if (current) {
+        scrollDeadline(next, appScrollState, lastScrollUpdate);
+        if (current->gif[0] != '\0' && gifPlayer.open) next.need(gifPlayer.nextFrameAt);
+    }
+    iconAnimationDeadline(next);
+    indicatorDeadline(next, lastDisplayUpdate);
+}
+
 void loopDisplay() {
     if (!wifiConnected) return;
 
     if (sleepIsActive()) {
+        gifStop(true);
         if (strcmp(settings.sleep.displayMode, "clock") == 0) {
             unsigned long sleepNow = millis();
-            if (sleepNow - lastDisplayUpdate > 1000) {
+            if (clockSecondDue(lastDisplayUpdate, sleepNow)) {
                 displayShowTime();
                 lastDisplayUpdate = sleepNow;
             }
@@ -5941,6 +8716,9 @@ void loopDisplay() {
     // ---- Notification display (priority over apps) ----
     NotificationItem* currentNotif = notifGetCurrent();
     if (currentNotif) {
+        // The app restarts from its first frame once the notification is gone
+        gifStop(true);
+
         // Handle notification scroll animation
         if (notifScrollState.needsScroll) {
             if (now - lastNotifScrollUpdate >= SCROLL_SPEED) {
@@ -5974,15 +8752,30 @@ void loopDisplay() {
             }
         }
 
+        // Animated icons redraw whenever their next frame is due
+        if (iconAnimationDue(now)) {
+            needsRedraw = true;
+        }
+
         // Redraw notification on scroll, periodic update, or indicator animation
         bool indicatorRedraw = indicatorNeedsRedraw() && (now - lastDisplayUpdate > 50);
-        if (now - lastDisplayUpdate > 1000 || needsRedraw || indicatorRedraw) {
+        if (clockSecondDue(lastDisplayUpdate, now) || needsRedraw || indicatorRedraw) {
             displayShowNotification(currentNotif);
             lastDisplayUpdate = now;
         }
         return;  // Skip app display while notification is active
     }
 
+    // ---- App transition (takes over the display until it completes) ----
+    if (transition.active) {
+        if (!transitionStep(now)) {
+            // Start the scroll pause once the incoming app is fully visible
+            appScrollState.lastScrollTime = now;
+            lastDisplayUpdate = now;
+        }
+        return;
+    }
+
     // ---- Normal app display ----
     AppItem* current = appGetCurrent();
     needsRedraw = false;
@@ -6022,9 +8815,14 @@ void loopDisplay() {
         }
     }
 
-    // Regular display update (1000ms for non-scrolling, 50ms for indicator animation)
+    // GIF apps and animated icons redraw whenever their next frame is due
+    if ((current && current->gif[0] != '\0' && gifFrameDue(now)) || iconAnimationDue(now)) {
+        needsRedraw = true;
+    }
+
+    // Regular display update (every clock second, 50ms for indicator animation)
     bool indicatorRedraw = indicatorNeedsRedraw() && (now - lastDisplayUpdate > 50);
-    if (now - lastDisplayUpdate > 1000 || needsRedraw || indicatorRedraw) {
+    if (clockSecondDue(lastDisplayUpdate, now) || needsRedraw || indicatorRedraw) {
         if (current) {
             displayShowApp(current);
         } else {
@@ -6040,6 +8838,20 @@ void loopDisplay() {
 // ============================================================================
 
 void logMemory() {
-    Serial.printf("[MEM] Free heap: %d bytes, largest block: %d bytes\n",
-        ESP.getFreeHeap(), ESP.getMaxAllocHeap());
+    Serial.printf("[MEM] Free heap: %u bytes, largest block: %u bytes\n",
+        (unsigned)ESP.getFreeHeap(), (unsigned)ESP.getMaxAllocHeap());
+}
+
+// Long-lived buffers, taken once at boot: from PSRAM when the board has it,
+// otherwise from the internal heap while it is still unfragmented. Zeroed.
+void* bootAlloc(size_t bytes, const char* what) {
+    void* buffer = nullptr;
+#if USE_PSRAM
+    buffer = ps_calloc(1, bytes);
+#endif
+    bool external = buffer != nullptr;
+    if (!buffer) buffer = calloc(1, bytes);
+    Serial.printf("[MEM] %s: %u bytes%s%s\n", what, (unsigned)bytes,
+                  external ? " in PSRAM" : "", buffer ? "" : ", allocation failed");
+    return buffer;
 }